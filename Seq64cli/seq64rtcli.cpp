@@ -24,7 +24,7 @@
  * \library       seq64rtcli application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2017-04-07
- * \updates       2020-02-09
+ * \updates       2026-10-17
  * \license       GNU GPLv2 or above
  *
  *  This application is seq64 without a GUI, control must be done via MIDI.
@@ -216,7 +216,35 @@ main (int argc, char * argv [])
                 if (! ok)
                     extant_msg_active = true;
             }
-            if (ok)
+            std::string renderfile = seq64::usr().option_render();
+            if (ok && ! renderfile.empty())
+            {
+                /*
+                 * Render the song to a MIDI file offline, and exit, without
+                 * running a session or saving the configuration.
+                 */
+
+                ok = seq64::render_midi_file
+                (
+                    p, renderfile, seq64::usr().option_render_format(),
+                    extant_errmsg
+                );
+                if (ok)
+                {
+                    printf("[Rendered song to %s]\n", renderfile.c_str());
+                }
+                else
+                {
+                    fprintf
+                    (
+                        stderr, "[Could not render song to %s: %s]\n",
+                        renderfile.c_str(), extant_errmsg.c_str()
+                    );
+                }
+
+                p.finish();                         /* tear down performer  */
+            }
+            else if (ok)
             {
 #if defined PLATFORM_LINUX
                 if (seq64::rc().lash_support())
@@ -0,0 +1,133 @@
+#ifndef SEQ64_ALSA_ENCODE_HPP
+#define SEQ64_ALSA_ENCODE_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          alsa_encode.hpp
+ *
+ *  This module defines the encoding of a channel message as an ALSA
+ *  sequencer event, for the ALSA MIDI buss of both the seq_alsamidi and
+ *  the seq_rtmidi libraries.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ *  This header lives in the top-level include directory, which both ALSA
+ *  backends have in their include paths, rather than in libseq64, which
+ *  must not depend on ALSA.  Only the ALSA modules include it.
+ */
+
+#include <alsa/asoundlib.h>
+
+#include "event.hpp"                    /* seq64::EVENT_NOTE_OFF, etc.  */
+
+/**
+ *  Defines the size of the MIDI event buffer of the ALSA MIDI encoder, which
+ *  should be large enough to accomodate the largest MIDI message to be
+ *  encoded.
+ */
+
+#define SEQ64_MIDI_EVENT_SIZE_MAX   10
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Fills in an ALSA sequencer event from the status and data bytes of a
+ *  channel message.  This replaces an ALSA MIDI parser, which had to be
+ *  allocated, set up, and freed for each event played.
+ *
+ * \param ev
+ *      The ALSA event to fill in.  It has already been cleared.
+ *
+ * \param status
+ *      The status byte, including the channel nybble.
+ *
+ * \param d0
+ *      The first data byte.
+ *
+ * \param d1
+ *      The second data byte, if any.
+ *
+ * \return
+ *      Returns false if the status is not that of a channel message, in
+ *      which case the event is left as is.
+ */
+
+inline bool
+alsa_encode_event
+(
+    snd_seq_event_t & ev, midibyte status, midibyte d0, midibyte d1
+)
+{
+    int channel = status & 0x0F;
+    switch (status & 0xF0)
+    {
+    case EVENT_NOTE_OFF:
+        snd_seq_ev_set_noteoff(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_NOTE_ON:
+        snd_seq_ev_set_noteon(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_AFTERTOUCH:
+        snd_seq_ev_set_keypress(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_CONTROL_CHANGE:
+        snd_seq_ev_set_controller(&ev, channel, d0, d1);
+        break;
+
+    case EVENT_PROGRAM_CHANGE:
+        snd_seq_ev_set_pgmchange(&ev, channel, d0);
+        break;
+
+    case EVENT_CHANNEL_PRESSURE:
+        snd_seq_ev_set_chanpress(&ev, channel, d0);
+        break;
+
+    case EVENT_PITCH_WHEEL:
+        snd_seq_ev_set_pitchbend(&ev, channel, ((int(d1) << 7) | d0) - 8192);
+        break;
+
+    default:
+        return false;
+    }
+    return true;
+}
+
+}           // namespace seq64
+
+#endif      // SEQ64_ALSA_ENCODE_HPP
+
+/*
+ * alsa_encode.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
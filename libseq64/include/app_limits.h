@@ -660,6 +660,79 @@
 
 #define SEQ64_RECENT_FILES_MAX          10
 
+/**
+ *  Provides the range of the number of threads that render the patterns
+ *  during playback.  A value of 1, the default, means that the output
+ *  thread plays all of the patterns itself, as always.  Higher values are
+ *  meant for very large sets of patterns on multi-core machines.
+ */
+
+#define SEQ64_PLAYBACK_THREADS_MIN      1
+#define SEQ64_PLAYBACK_THREADS_MAX      16
+#define SEQ64_PLAYBACK_THREADS_DEFAULT  1
+
+/**
+ *  Provides the range of the period of the output thread, in microseconds,
+ *  when it runs on absolute deadlines (see the [output-timing] section of
+ *  the "rc" file).  The default matches the legacy trigger width,
+ *  SEQ64_DEFAULT_TRIGWIDTH_MS.
+ */
+
+#define SEQ64_FRAME_PERIOD_US_MIN       250
+#define SEQ64_FRAME_PERIOD_US_MAX       20000
+#define SEQ64_FRAME_PERIOD_US_DEFAULT   (SEQ64_DEFAULT_TRIGWIDTH_MS * 1000)
+
+/**
+ *  Provides the range of the spin-wait tail, in microseconds.  The output
+ *  thread sleeps until this much time before each deadline, and then spins
+ *  on the clock for the rest.  0 disables spinning.
+ */
+
+#define SEQ64_SPIN_TAIL_US_MIN          0
+#define SEQ64_SPIN_TAIL_US_MAX          1000
+#define SEQ64_SPIN_TAIL_US_DEFAULT      50
+
+/**
+ *  Provides the range of the output lookahead, in milliseconds.  When
+ *  greater than 0, patterns are played this far ahead of the current
+ *  position, and the events are scheduled on the MIDI API's queue (ALSA
+ *  only) instead of being sent directly.  0, the default, disables it.
+ */
+
+#define SEQ64_LOOKAHEAD_MS_MIN          0
+#define SEQ64_LOOKAHEAD_MS_MAX          200
+#define SEQ64_LOOKAHEAD_MS_DEFAULT      0
+
+/**
+ *  Provides the range of the MIDI clock offset of an output buss, in
+ *  microseconds.  A positive offset sends the clock of the buss that much
+ *  earlier, to make up for the input latency of the device on the buss.
+ */
+
+#define SEQ64_CLOCK_OFFSET_US_MIN       (-100000)
+#define SEQ64_CLOCK_OFFSET_US_MAX       100000
+
+/**
+ *  Provides the range of the rate at which SysEx is sent to an output buss,
+ *  in bytes per second.  The default is the rate of a DIN MIDI cable, 31250
+ *  baud at 10 bits per byte.  USB devices can usually take SysEx much
+ *  faster.
+ */
+
+#define SEQ64_SYSEX_RATE_MIN            100
+#define SEQ64_SYSEX_RATE_MAX            1000000
+#define SEQ64_SYSEX_RATE_DEFAULT        3125
+
+/**
+ *  Provides the range of the size of the ring-buffer of each JACK port, in
+ *  bytes.  The output ring-buffer must hold all of the messages written
+ *  ahead of the JACK process cycle that sends them.
+ */
+
+#define SEQ64_JACK_RING_SIZE_MIN        1024
+#define SEQ64_JACK_RING_SIZE_MAX        4194304
+#define SEQ64_JACK_RING_SIZE_DEFAULT    16384
+
 #endif      // SEQ64_APP_LIMITS_H
 
 /*
@@ -56,6 +56,7 @@ namespace seq64
 {
     class event;
     class midibus;
+    class render_buffer;
 
 /**
  *  A new class to consolidate a number of bus-related arrays into one array.
@@ -329,8 +330,16 @@ public:
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void clock (midipulse tick);
+    void clock (bussbyte bus, midipulse tick);
     void sysex (event * ev);
+    void notes_off (bool allnotesoff);
     void play (bussbyte bus, event * e24, midibyte channel);
+    void play_at (bussbyte bus, event * e24, midibyte channel, midipulse tick);
+    void play
+    (
+        const render_buffer & batch, bussbyte bus,
+        bool stamped, midipulse offset
+    );
     bool set_clock (bussbyte bus, clock_e clocktype);
     void set_all_clocks ();
     clock_e get_clock (bussbyte bus);
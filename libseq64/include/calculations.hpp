@@ -125,6 +125,10 @@ extern std::string pulses_to_timestring
 (
     midipulse pulses, midibpm bpm, int ppqn, bool showus = true
 );
+extern std::string microseconds_to_timestring
+(
+    unsigned long microseconds, bool showus = true
+);
 extern midipulse measurestring_to_pulses
 (
     const std::string & measures,
@@ -0,0 +1,272 @@
+#ifndef SEQ64_CLOCK_DLL_HPP
+#define SEQ64_CLOCK_DLL_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          clock_dll.hpp
+ *
+ *  This module declares a delay-locked loop that follows an incoming MIDI
+ *  clock.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ *  The loop is the second-order one described by Fons Adriaensen in "Using
+ *  a DLL to filter time".  Each MIDI clock is fed in with the time at which
+ *  it came in.  The loop keeps a filtered time for the latest clock and a
+ *  prediction for the next one, from which it gives the tempo and the tick
+ *  at any time between the clocks.  The jitter of the clocks is filtered
+ *  out, while a slow change of tempo is followed.
+ */
+
+#include "midibyte.hpp"                 /* midipulse, midibpm           */
+#include "mutex.hpp"                    /* seq64::mutex, automutex      */
+
+/**
+ *  The bandwidth of the loop, in Hz.  A lower bandwidth filters more of the
+ *  jitter, but follows a change of tempo more slowly.
+ */
+
+#define SEQ64_CLOCK_DLL_BANDWIDTH       1.0
+
+/**
+ *  The number of clocks in a row that must come in close to the prediction
+ *  for the loop to be deemed locked.  24 clocks is one beat.
+ */
+
+#define SEQ64_CLOCK_DLL_LOCK_CLOCKS     24
+
+/**
+ *  The error, as a fraction of the clock period, that a clock may have and
+ *  still count toward the lock.
+ */
+
+#define SEQ64_CLOCK_DLL_LOCK_ERROR      0.1
+
+/**
+ *  The error, as a fraction of the clock period, at which the loop gives up
+ *  the lock and starts over from the latest clock.
+ */
+
+#define SEQ64_CLOCK_DLL_UNLOCK_ERROR    0.5
+
+/**
+ *  The number of clock periods without a clock after which the loop gives
+ *  up the lock, and holds the position until the clock comes back.
+ */
+
+#define SEQ64_CLOCK_DLL_TIMEOUT_CLOCKS  4
+
+/**
+ *  The change in the estimated tempo, in BPM, that is big enough to be
+ *  passed along as the tempo of the performance.  Smaller changes are just
+ *  the jitter of the estimate.
+ */
+
+#define SEQ64_CLOCK_DLL_BPM_STEP        0.05
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Follows an incoming MIDI clock.  The input thread feeds in the clocks,
+ *  and the output thread asks how far to advance, so the state is guarded
+ *  by a mutex.
+ */
+
+class clock_dll
+{
+
+private:
+
+    /**
+     *  Guards the state against the input and output threads.
+     */
+
+    mutable mutex m_mutex;
+
+    /**
+     *  The number of ticks per clock, PPQN / 24.
+     */
+
+    int m_increment;
+
+    /**
+     *  The number of clocks since the start (or continue).  The first clock
+     *  is at the start, so clock n puts playback at tick (n - 1) *
+     *  m_increment, as counted from the start.
+     */
+
+    long m_clocks;
+
+    /**
+     *  The number of ticks handed out by advance() since the start.
+     */
+
+    midipulse m_given;
+
+    /**
+     *  True if the loop has a period and a phase, that is, a clock has come
+     *  in since the start or since the last unlock.
+     */
+
+    bool m_running;
+
+    /**
+     *  The time at which the latest clock came in, in microseconds, or 0 if
+     *  not known.  Used to get the period afresh after an unlock.
+     */
+
+    long long m_last_us;
+
+    /**
+     *  The filtered time of the latest clock, in microseconds.
+     */
+
+    double m_t0;
+
+    /**
+     *  The predicted time of the next clock, in microseconds.
+     */
+
+    double m_t1;
+
+    /**
+     *  The filtered period of the clock, in microseconds.
+     */
+
+    double m_period;
+
+    /**
+     *  The number of clocks in a row that came in close to the prediction.
+     */
+
+    int m_good_clocks;
+
+    /**
+     *  True if the loop is locked to the clock.
+     */
+
+    bool m_locked;
+
+    /**
+     *  The number of times the loop got a lock, a statistic.
+     */
+
+    int m_locks;
+
+    /**
+     *  The number of times the loop lost the lock, a statistic.
+     */
+
+    int m_unlocks;
+
+    /**
+     *  The last error of a clock against the prediction, in microseconds.
+     *  A positive error is a clock that came in late.  A statistic.
+     */
+
+    double m_drift_us;
+
+    /**
+     *  The largest error, in microseconds, since the loop was locked.  A
+     *  statistic.
+     */
+
+    double m_max_drift_us;
+
+public:
+
+    clock_dll ();
+
+    void start (int increment, midibpm bpm);
+    void stop ();
+    void clock (long long us);
+    midipulse advance (long long us);
+    midibpm bpm () const;
+
+    /**
+     * \getter m_locked
+     */
+
+    bool locked () const
+    {
+        return m_locked;
+    }
+
+    /**
+     * \getter m_locks
+     */
+
+    int locks () const
+    {
+        return m_locks;
+    }
+
+    /**
+     * \getter m_unlocks
+     */
+
+    int unlocks () const
+    {
+        return m_unlocks;
+    }
+
+    /**
+     * \getter m_drift_us
+     */
+
+    double drift_us () const
+    {
+        return m_drift_us;
+    }
+
+    /**
+     * \getter m_max_drift_us
+     */
+
+    double max_drift_us () const
+    {
+        return m_max_drift_us;
+    }
+
+private:
+
+    void unlock ();
+
+};          // class clock_dll
+
+}           // namespace seq64
+
+#endif      // SEQ64_CLOCK_DLL_HPP
+
+/*
+ * clock_dll.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
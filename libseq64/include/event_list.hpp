@@ -184,6 +184,16 @@ private:
 
     bool m_has_time_signature;
 
+    /**
+     *  Counts the structural changes (insertions, removals, sorting,
+     *  assignment) made to the container.  Unlike m_is_modified, this value
+     *  is never reset, so that a client holding an iterator into the
+     *  container (such as the playback cursor of the sequence class) can
+     *  detect that the iterator might no longer be valid.
+     */
+
+    unsigned long m_generation;
+
 public:
 
     event_list ();
@@ -301,6 +311,7 @@ public:
     void push_back (const event & e)
     {
         m_events.push_back(e);
+        ++m_generation;
     }
 
 #endif
@@ -314,6 +325,15 @@ public:
         return m_is_modified;
     }
 
+    /**
+     * \getter m_generation
+     */
+
+    unsigned long generation () const
+    {
+        return m_generation;
+    }
+
     /**
      * \getter m_has_tempo
      */
@@ -356,6 +376,7 @@ public:
     {
         m_events.erase(ie);
         m_is_modified = true;
+        ++m_generation;
     }
 
     /**
@@ -366,6 +387,7 @@ public:
     {
         m_events.clear();
         m_is_modified = true;
+        ++m_generation;
     }
 
     void merge (event_list & el, bool presort = true);
@@ -380,6 +402,7 @@ public:
         // we need nothin' for sorting a multimap
 #else
         m_events.sort();
+        ++m_generation;
 #endif
     }
 
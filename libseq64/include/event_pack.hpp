@@ -0,0 +1,162 @@
+#ifndef SEQ64_EVENT_PACK_HPP
+#define SEQ64_EVENT_PACK_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_pack.hpp
+ *
+ *  This module declares a compact, copyable snapshot of an event list.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ *  An event object is about 64 bytes:  besides the timestamp, status, and
+ *  data bytes, it carries a SysEx vector, a link pointer, four flags, and a
+ *  vtable pointer.  Each one in an event_list is also a node of its own.
+ *  Yet almost every event is a three-byte channel message.  The undo and
+ *  redo stacks and the clipboard used to hold whole copies of the
+ *  event_list, so that each edit copied every event node by node, SysEx
+ *  vector and all.  The event_pack holds the events as 16-byte items in
+ *  one array, with the SysEx and Meta data of all the events kept in one
+ *  byte array on the side.  Copying a pack is copying three arrays.  The
+ *  links are not kept; the caller relinks the events after unpack(), as
+ *  sequence::pop_undo() always did.
+ */
+
+#include <vector>                       /* std::vector                  */
+
+#include "midibyte.hpp"                 /* midipulse, midibyte          */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class event_list;
+
+/**
+ *  Holds the events of an event_list in a compact form, for the undo and
+ *  redo stacks and the clipboard of the sequence class.
+ */
+
+class event_pack
+{
+
+public:
+
+    /**
+     *  One event.  It is trivially copyable, and is 16 bytes where a
+     *  midipulse is 8 bytes.
+     */
+
+    struct item
+    {
+        midipulse pe_tick;          /**< The timestamp of the event.        */
+        midibyte pe_status;         /**< The status, without channel.       */
+        midibyte pe_channel;        /**< The channel, or the Meta type.     */
+        midibyte pe_d0;             /**< The first data byte.               */
+        midibyte pe_d1;             /**< The second data byte.              */
+        unsigned pe_payload : 24;   /**< Index of the SysEx/Meta data.      */
+        unsigned pe_flags : 8;      /**< The selected/marked/painted flags. */
+    };
+
+private:
+
+    /**
+     *  The start and size of the data of a SysEx or Meta event in
+     *  m_bytes.
+     */
+
+    struct span
+    {
+        int ps_offset;              /**< The index of the first byte.       */
+        int ps_size;                /**< The number of bytes.               */
+    };
+
+    /**
+     *  The events, in the order of the event list.
+     */
+
+    std::vector<item> m_items;
+
+    /**
+     *  The data of each SysEx and Meta event, indexed by item::pe_payload.
+     */
+
+    std::vector<span> m_spans;
+
+    /**
+     *  The data bytes of all of the SysEx and Meta events.
+     */
+
+    std::vector<midibyte> m_bytes;
+
+public:
+
+    event_pack ();
+    event_pack (const event_list & evl);
+
+    void pack (const event_list & evl);
+    void unpack (event_list & evl) const;
+    void clear ();
+
+    /**
+     *  Returns the number of events.
+     */
+
+    int count () const
+    {
+        return int(m_items.size());
+    }
+
+    /**
+     *  Returns true if there are no events.
+     */
+
+    bool empty () const
+    {
+        return m_items.empty();
+    }
+
+    /**
+     *  Returns the given item.  The index is not checked.
+     */
+
+    const item & at (int i) const
+    {
+        return m_items[i];
+    }
+
+};          // class event_pack
+
+}           // namespace seq64
+
+#endif      // SEQ64_EVENT_PACK_HPP
+
+/*
+ * event_pack.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -27,7 +27,7 @@
  * \library       sequencer64 application
  * \author        Seq24 team; modifications by Chris Ahlstrom
  * \date          2016-11-23
- * \updates       2018-06-02
+ * \updates       2026-10-17
  * \license       GNU GPLv2 or above
  *
  *  The mastermidibase module is the base-class version of the mastermidibus
@@ -41,6 +41,8 @@
 #include "businfo.hpp"                  /* seq64::businfo & busarray        */
 #include "midibus_common.hpp"
 #include "mutex.hpp"
+#include "sysex_sender.hpp"             /* seq64::sysex_sender              */
+#include "tick_clock.hpp"               /* seq64::tick_clock                */
 #include "user_midi_bus.hpp"
 
 /*
@@ -51,8 +53,44 @@ namespace seq64
 {
     class event;
     class midibus;
+    class render_buffer;
     class sequence;
 
+/**
+ *  The number of events that one process cycle can render in engine mode.
+ *  The MIDI API holds an array of this many engine_event items.
+ */
+
+#define SEQ64_ENGINE_EVENTS     1024
+
+/**
+ *  One event rendered in engine mode, placed at a frame of the current
+ *  process cycle.  Only channel messages are rendered, so three bytes are
+ *  enough.
+ */
+
+struct engine_event
+{
+    long ee_frame;              /**< The offset of the event in the cycle.  */
+    bussbyte ee_bus;            /**< The output buss of the event.          */
+    midibyte ee_size;           /**< The number of bytes in ee_data.        */
+    midibyte ee_data[3];        /**< The status and data bytes.             */
+};
+
+/**
+ *  The function a MIDI API calls from its process cycle to render one
+ *  period, when the API drives the timing of playback.  It must not block
+ *  or allocate.  The parameters are the user argument, the number of frames
+ *  in the period, the frame rate, and the array for the events and its
+ *  size.  It returns the number of events rendered into the array.  See
+ *  mastermidibase::engine().
+ */
+
+typedef int (* engine_callback_t)
+(
+    void * arg, long frames, long rate, engine_event * events, int capacity
+);
+
 /**
  *  The class that "supervises" all of the midibus objects?
  */
@@ -155,6 +193,67 @@ protected:
 
     sequence * m_seq;
 
+    /**
+     *  True while events are scheduled on the queue of the MIDI API, rather
+     *  than sent directly.  See start_scheduling() and play_at().
+     */
+
+    bool m_scheduling;
+
+    /**
+     *  The tick of the queue, minus the tick of the performance.  It is set
+     *  by the output thread for each frame, and changes only when the
+     *  position of the performance jumps, such as at the end of a loop.
+     */
+
+    midipulse m_schedule_offset;
+
+    /**
+     *  True if the MIDI API places each event at the frame given by its
+     *  tick, relative to the current tick of the performance (see
+     *  frame_tick()), rather than sending it as soon as it is played.  Set
+     *  by the JACK implementation.
+     */
+
+    bool m_frame_stamping;
+
+    /**
+     *  Maps the time at which an input event came in to the tick of the
+     *  performance at that time.  It is marked by frame_tick(), and read by
+     *  input_tick().
+     */
+
+    tick_clock m_tick_clock;
+
+    /**
+     *  Sends SysEx to the output busses from a thread of its own, paced at
+     *  the "rc" [sysex-output] rate.  See sysex().
+     */
+
+    sysex_sender m_sysex_sender;
+
+    /**
+     *  The function that renders a period when the MIDI API drives
+     *  playback, or a null pointer.  See engine().
+     */
+
+    engine_callback_t m_engine_callback;
+
+    /**
+     *  The argument passed to m_engine_callback, normally the perform
+     *  object.
+     */
+
+    void * m_engine_arg;
+
+    /**
+     *  If not null, the events that would be sent to the busses are added to
+     *  this buffer instead, with their ticks.  Used by the offline render of
+     *  the song (see perform::render_song()).
+     */
+
+    render_buffer * m_capture;
+
     /**
      *  The locking mutex.  This object is passed to an automutex object that
      *  lends exception-safety to the mutex locking.
@@ -295,13 +394,31 @@ public:
     void port_start (int client, int port);
     void port_exit (int client, int port);
     void play (bussbyte bus, event * e24, midibyte channel);
+    void play_at (bussbyte bus, event * e24, midibyte channel, midipulse tick);
+    void play (const render_buffer & batch);
+    bool start_scheduling ();
+    bool stop_scheduling ();
+    midipulse schedule_tick ();
+    void schedule_offset (midipulse offset);
+    void frame_tick (midipulse tick);
+    midipulse input_tick (midipulse stamp);
+    long long input_time (midipulse stamp);
+    bool engine (engine_callback_t callback, void * arg);
+    int engine_cycle
+    (
+        long frames, long rate, engine_event * events, int capacity
+    );
+    void capture (render_buffer * sink);
     void continue_from (midipulse tick);
     void init_clock (midipulse tick);
     void emit_clock (midipulse tick);
+    void emit_clock (bussbyte bus, midipulse tick);
     void sysex (event * event);
+    void stop_sysex ();
     void print () const;
     void flush ();
     void panic ();                                          /* kepler34 func  */
+    void notes_off ();
     void set_sequence_input (bool state, sequence * seq);
     void dump_midi_input (event in);                        /* seq32 function */
 
@@ -311,6 +428,8 @@ public:
     int poll_for_midi ();
     bool is_more_input ();
     bool get_midi_event (event * in);
+    int get_midi_events (event * evs, int count);
+    void wake_input ();
 
     bool set_clock (bussbyte bus, clock_e clock_type);
     bool set_input (bussbyte bus, bool inputing);
@@ -319,10 +438,22 @@ public:
     clock_e get_clock (bussbyte bus);
 
     void set_ppqn (int ppqn);
-    void set_beats_per_minute (midibpm bpm);
+    void set_beats_per_minute
+    (
+        midibpm bpm, midipulse tick = SEQ64_NULL_MIDIPULSE
+    );
 
 protected:
 
+    /**
+     * \setter m_frame_stamping
+     */
+
+    void frame_stamping (bool flag)
+    {
+        m_frame_stamping = flag;
+    }
+
     /**
      * \setter m_master_clocks, m_master_inputs.
      *      Used in the perform class to pass the settings read from the "rc"
@@ -439,6 +570,105 @@ protected:
         // no code for base
     }
 
+    /**
+     *  Provides MIDI API-specific functionality for the
+     *  set_beats_per_minute() function when the change is to be scheduled
+     *  on the queue at the given tick.  By default, the change is made now.
+     */
+
+    virtual void api_schedule_beats_per_minute
+    (
+        midibpm bpm, midipulse /* tick */
+    )
+    {
+        api_set_beats_per_minute(bpm);
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the start_scheduling()
+     *  function.  Only an API with a queue can schedule events.
+     *
+     * \return
+     *      Returns true if the queue was (re)started at tick 0.
+     */
+
+    virtual bool api_start_scheduling ()
+    {
+        return false;                   /* no code for base or portmidi */
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the stop_scheduling()
+     *  function.
+     */
+
+    virtual void api_cancel_scheduled ()
+    {
+        // no code for base or portmidi
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the schedule_tick()
+     *  function.
+     *
+     * \return
+     *      Returns the current tick of the queue, or SEQ64_NULL_MIDIPULSE if
+     *      it cannot be obtained.
+     */
+
+    virtual midipulse api_schedule_tick ()
+    {
+        return SEQ64_NULL_MIDIPULSE;    /* no code for base or portmidi */
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the frame_tick()
+     *  function.
+     */
+
+    virtual void api_frame_tick (midipulse /* tick */)
+    {
+        // no code for base, ALSA, or portmidi
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the input_tick()
+     *  function.
+     */
+
+    virtual midipulse api_input_tick (midipulse /* stamp */)
+    {
+        return SEQ64_NULL_MIDIPULSE;    /* no code for base, ALSA, portmidi */
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the input_tick()
+     *  function.
+     *
+     * \return
+     *      Returns the number of microseconds since the input event with the
+     *      given timestamp came in.  The base version, for an API that does
+     *      not stamp its input, returns 0, for "just now".
+     */
+
+    virtual long api_input_age (midipulse /* stamp */)
+    {
+        return 0;                       /* no code for base or portmidi */
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the engine() function.
+     *
+     * \return
+     *      Returns true if the API can call engine_cycle() from its process
+     *      cycle.
+     */
+
+    virtual bool api_engine (bool /* on */)
+    {
+        return false;                   /* no code for base, ALSA, portmidi */
+    }
+
     /**
      *  Provides MIDI API-specific functionality for the flush() function.
      */
@@ -463,8 +693,19 @@ protected:
     }
 
     virtual bool api_get_midi_event (event * inev) = 0;
+    virtual int api_get_midi_events (event * evs, int count);
     virtual int api_poll_for_midi ();
 
+    /**
+     *  Provides MIDI API-specific functionality for the wake_input()
+     *  function.
+     */
+
+    virtual void api_wake_input ()
+    {
+        // no code for base, portmidi, or rtmidi
+    }
+
 /*
  *  So far, there is no need for these API-specific functions.
  *
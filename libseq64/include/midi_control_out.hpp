@@ -28,7 +28,7 @@
  * \library       sequencer64 application
  * \author        Igor Angst
  * \date          2018-03-28
- * \updates       2019-06-10
+ * \updates       2026-10-17
  * \license       GNU GPLv2 or above
  *
  * The class contained in this file encapsulates most of the
@@ -262,6 +262,25 @@ public:
 
     void send_seq_event (int seq, seq_action what, bool flush = true);
 
+    /**
+     *  Looks up the event that send_seq_event() would send, for callers
+     *  that send it themselves.
+     *
+     * \param seq
+     *      The index of the sequence.
+     *
+     * \param what
+     *      The status action of the sequence.
+     *
+     * \param [out] ev
+     *      Receives the event, if any.
+     *
+     * \return
+     *      Returns true if an event is set up for the sequence and action.
+     */
+
+    bool seq_event (int seq, seq_action what, event & ev) const;
+
     /**
      *  Clears all visible sequences by sending "delete" messages for all
      *  sequences ranging from 0 to screenset_size().
@@ -35,6 +35,8 @@
  *  base class for all such classes.
  */
 
+#include <bitset>                       /* std::bitset<>                    */
+
 #include "app_limits.h"                 /* SEQ64_USE_DEFAULT_PPQN           */
 #include "daemonize.hpp"                /* milli- and microsleep()          */
 #include "easy_macros.h"                /* for autoconf header files        */
@@ -49,6 +51,7 @@
 namespace seq64
 {
     class event;
+    class render_buffer;
 
 /**
  *  This class implements with ALSA version of the midibase object.
@@ -182,6 +185,23 @@ private:
 
     bool m_is_system_port;
 
+    /**
+     *  The notes sounding on each channel of this buss, as far as the
+     *  events played on it tell.  A Note On sets the bit of its note, and a
+     *  Note Off (or a Note On of velocity 0) clears it.  An event scheduled
+     *  ahead counts as played when it is queued.  Used by notes_off() to
+     *  send Note Offs only for the notes that need them.
+     */
+
+    std::bitset<SEQ64_MIDI_COUNT_MAX> m_notes_on[SEQ64_MIDI_CHANNEL_MAX];
+
+    /**
+     *  One bit for each channel that has played a note since the last call
+     *  to notes_off() with the All Notes Off option.
+     */
+
+    unsigned m_channels_used;
+
     /**
      *  Locking mutex.
      */
@@ -494,7 +514,14 @@ public:
     bool init_out_sub ();
     bool init_in_sub ();
     void play (event * e24, midibyte channel);
+    void play_at (event * e24, midibyte channel, midipulse tick);
+    void play
+    (
+        const render_buffer & batch, bussbyte bus,
+        bool stamped, midipulse offset
+    );
     void sysex (event * e24);
+    void notes_off (bool allnotesoff);
     void flush ();
     void start ();
     void stop ();
@@ -504,6 +531,16 @@ public:
     void print ();
     bool set_input (bool inputing);
 
+    /**
+     *  Returns the most bytes of a SysEx message that sysex() is to be
+     *  given at a time, or 0 if the buss takes each message whole.
+     */
+
+    int sysex_chunk () const
+    {
+        return api_sysex_chunk();
+    }
+
 protected:
 
     /**
@@ -593,6 +630,19 @@ protected:
 
     virtual void api_play (event * e24, midibyte channel) = 0;
 
+    /**
+     *  Handles implementation details for the play_at() function.  An API
+     *  that has no queue to schedule on simply plays the event now.
+     */
+
+    virtual void api_play_at
+    (
+        event * e24, midibyte channel, midipulse /* tick */
+    )
+    {
+        api_play(e24, channel);
+    }
+
     /**
      *  Handles implementation details for SysEx messages.
      *
@@ -604,6 +654,17 @@ protected:
         // no code for portmidi
     }
 
+    /**
+     *  Returns the most bytes of a SysEx message that api_sysex() is to be
+     *  given at a time, or 0 if the API takes each message whole.  Used by
+     *  the sysex_sender.
+     */
+
+    virtual int api_sysex_chunk () const
+    {
+        return c_midibus_sysex_chunk;
+    }
+
     /**
      *  Handles implementation details for the flush() function.
      */
@@ -622,6 +683,10 @@ protected:
     virtual void api_stop () = 0;
     virtual void api_clock (midipulse tick) = 0;
 
+private:
+
+    void track_note (const event * e24, midibyte channel);
+
 };          // class midibase
 
 }           // namespace seq64
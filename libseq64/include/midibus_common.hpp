@@ -66,6 +66,20 @@ const int c_midibus_input_size  = 0x100000;     // 1048576
 
 const int c_midibus_sysex_chunk = 0x100;        // 256
 
+/**
+ *  The most MIDI input events that the input thread takes from the master
+ *  buss at one wakeup, into the array that perform preallocates for them.
+ */
+
+const int c_midibus_input_batch = 64;
+
+/**
+ *  The controller number of the All Notes Off channel-mode message, sent
+ *  by midibase::notes_off() when asked.
+ */
+
+const int c_midibus_all_notes_off = 0x7B;       // 123
+
 /**
  *  A clock enumeration, as used in the File / Options / MIDI Clock dialog.
  *  This enumeration was also defined in midibus_portmidi.h, but we put it
@@ -100,6 +100,15 @@
 
 #define PROP_CHUNK_TAG              SEQ64_MTRK_TAG
 
+/**
+ *  The track keys for midifile::write_render_track() that are not a buss
+ *  and channel:  all of the events and the meta events (the one track of
+ *  SMF 0), or only the meta events (the tempo track of SMF 1).
+ */
+
+#define SEQ64_RENDER_ALL            (-1)
+#define SEQ64_RENDER_META           (-2)
+
 /**
  *  Provides the sequence number for the proprietary/SeqSpec data when using
  *  the new format.  (There is no sequence number for the legacy format.)
@@ -133,6 +142,7 @@ namespace seq64
     class midi_splitter;
     class perform;
     class midi_vector;
+    class render_buffer;
 
 /**
  *  This class handles the parsing and writing of MIDI files.  In addition to
@@ -304,6 +314,10 @@ public:
     virtual bool write (perform & p, bool doseqspec = true);
 
     bool write_song (perform & p);
+    bool write_render
+    (
+        perform & p, const render_buffer & captured, int smfformat = 1
+    );
 
     /**
      * \getter m_error_message
@@ -453,13 +467,16 @@ protected:
     void write_seq_number (midishort seqnum);
     int read_seq_number ();
     void write_track_end ();
-    bool write_header (int numtracks);
+    bool write_header (int numtracks, int smfformat = 1);
 #ifdef USE_WRITE_START_TEMPO
     void write_start_tempo (midibpm start_tempo);
 #endif
-#ifdef USE_WRITE_TIME_SIG
     void write_time_sig (int beatsperbar, int beatwidth);
-#endif
+    void write_render_track
+    (
+        const perform & p, const render_buffer & captured,
+        int key, const std::string & trackname
+    );
     void write_prop_header (midilong tag, long len);
     bool write_proprietary_track (perform & a_perf);
     long varinum_size (long len) const;
@@ -523,6 +540,13 @@ extern bool save_midi_file
     const std::string & fn,
     std::string & errmsg
 );
+extern bool render_midi_file
+(
+    perform & p,
+    const std::string & fn,
+    int smfformat,
+    std::string & errmsg
+);
 
 }           // namespace seq64
 
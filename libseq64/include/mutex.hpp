@@ -79,6 +79,7 @@ public:
 
     mutex ();
     void lock () const;
+    bool try_lock () const;
     void unlock () const;
 
 };
@@ -161,6 +162,7 @@ public:
     condition_var ();
     void wait ();
     void signal ();
+    void broadcast ();
 
 };
 
@@ -57,6 +57,7 @@
  *      instead of raw pointers, to make truly exception-safe destructors.
  */
 
+#include "clock_dll.hpp"                /* seq64::clock_dll                 */
 #include "globals.h"                    /* globals, nullptr, & more         */
 #include "jack_assistant.hpp"           /* optional seq64::jack_assistant   */
 #include "gui_assistant.hpp"            /* seq64::gui_assistant             */
@@ -65,14 +66,18 @@
 #include "midi_control.hpp"             /* seq64::midi_control "struct"     */
 #include "midi_control_out.hpp"         /* seq64::midi_control_out          */
 #include "playlist.hpp"                 /* seq64::playlist, 0.96 and above  */
+#include "render_pool.hpp"              /* seq64::render_pool, etc.         */
 #include "sequence.hpp"                 /* seq64::sequence                  */
+#include "tempo_map.hpp"                /* seq64::tempo_map                 */
 
 #ifdef SEQ64_SONG_BOX_SELECT
 #include <functional>                   /* std::function, function objects  */
 #include <set>                          /* std::set, arbitary selection     */
 #endif
 
+#include <atomic>                       /* std::atomic<bool>                */
 #include <memory>                       /* std::unique_ptr<>                */
+#include <unordered_map>                /* std::unordered_map<>             */
 #include <vector>                       /* std::vector<>                    */
 #include <pthread.h>                    /* pthread_t C structure            */
 
@@ -269,6 +274,11 @@ class perform
     friend class wrkfile;
     friend void * input_thread_func (void * myperf);
     friend void * output_thread_func (void * myperf);
+    friend void * clock_thread_func (void * myperf);
+    friend int perform_engine_callback
+    (
+        void * arg, long frames, long rate, engine_event * events, int capacity
+    );
 
 #ifdef SEQ64_JACK_SUPPORT
 
@@ -386,6 +396,37 @@ public:
         FF_RW_FORWARD   =  1
     };
 
+private:
+
+    /**
+     *  Guards the play set, and the rest of the state of play(), for the
+     *  life of the object.  Outside of the JACK engine, it locks
+     *  m_play_set_mutex, then holds the engine off and waits out a render
+     *  in progress (see hold_play_set()).  Inside engine_cycle(), which
+     *  owns that state while it renders, it does nothing.
+     */
+
+    class play_set_locker
+    {
+
+    private:
+
+        perform & m_perf;
+
+    public:
+
+        play_set_locker (perform & p) : m_perf (p)
+        {
+            m_perf.hold_play_set();
+        }
+
+        ~play_set_locker ()
+        {
+            m_perf.release_play_set();
+        }
+
+    };
+
 private:
 
     /**
@@ -700,6 +741,20 @@ private:
 
     bool m_in_thread_launched;
 
+    /**
+     *  Provides a "handle" to the MIDI clock emitter thread, which is started
+     *  only if the "rc" [midi-clock-emitter] setting is on.
+     */
+
+    pthread_t m_clock_thread;
+
+    /**
+     *  Indicates that the MIDI clock emitter thread has been started.  The
+     *  output thread then leaves the MIDI clock to it.
+     */
+
+    bool m_clock_thread_launched;
+
     /**
      *  Indicates that playback is running.  However, this flag is conflated
      *  with some JACK support, and we have to supplement it with another
@@ -805,6 +860,14 @@ private:
 
     int m_tempo_track_number;
 
+    /**
+     *  Holds the tempo and time-signature changes of the tempo track, for
+     *  converting ticks to time and measures when the tempo changes during
+     *  the song.  Rebuilt when playback starts and when a tempo is logged.
+     */
+
+    tempo_map m_tempo_map;
+
     /**
      *  Augments the beats/bar and beat-width with the additional values
      *  included in a Time Signature meta event.  This value provides the
@@ -939,6 +1002,22 @@ private:
 
     int m_midiclockpos;
 
+    /**
+     *  Follows the incoming MIDI clock, if the [midi-clock-dll] option is on.
+     *  The input thread feeds it the clocks, and the output thread advances
+     *  playback by it.
+     */
+
+    clock_dll m_clock_dll;
+
+    /**
+     *  The events taken from the master buss at one wakeup of the input
+     *  thread.  Allocated once, holding c_midibus_input_batch events, and
+     *  used only by the input thread.
+     */
+
+    std::vector<event> m_input_events;
+
     /**
      *  Support for pause, which does not reset the "last tick" when playback
      *  stops/starts.  All this member is used for is keeping the last tick
@@ -973,6 +1052,18 @@ private:
 
     midi_control m_midi_cc_off[c_midi_controls_extended_2];
 
+    /**
+     *  Indexes the MIDI controls by the status and first data byte that they
+     *  match, with the key (status << 8) + d0.  Each entry lists, in order,
+     *  the controls that have an active toggle, on, or off setting for that
+     *  pair, so that an incoming event is checked only against those
+     *  controls.  Rebuilt by rebuild_midi_control_index() whenever the
+     *  controls are loaded, and guarded by m_midi_control_mutex.
+     */
+
+    std::unordered_map<unsigned, std::vector<int> > m_midi_control_index;
+    mutex m_midi_control_mutex;
+
     /**
      *  Provides the class encapsulating MIDI control output.
      */
@@ -1068,6 +1159,178 @@ private:
 
     int m_sequence_high;
 
+    /**
+     *  Holds the numbers of the sequences that can produce output in the
+     *  next frame:  those that are playing, queued, one-shot, recording, or
+     *  (in Song mode) have a trigger in the frame.  Only these sequences are
+     *  visited by play(), set_orig_ticks(), and reset_sequences().  The other
+     *  sequences are "parked" (see sequence::park()), and their last tick is
+     *  m_park_tick.  The list is trimmed by play() as sequences go idle, and
+     *  is rebuilt from all of the slots only when m_play_set_dirty is set.
+     *  Its capacity is reserved up front, so it never reallocates.
+     */
+
+    std::vector<int> m_play_set;
+
+    /**
+     *  Set by wake_play_set() when a parked sequence may need to play again,
+     *  and by play() when the position has moved backward, the playback
+     *  mode has changed, or m_play_set_wake has been reached.  This flag can
+     *  be set by any thread, without a lock; it is cleared by the output
+     *  thread, before the rebuild, so that a wake during the rebuild is not
+     *  lost.
+     */
+
+    std::atomic<bool> m_play_set_dirty;
+
+    /**
+     *  The earliest trigger start of the parked sequences, in Song mode.
+     *  When the playback tick reaches this value, the play set is rebuilt so
+     *  that the triggered sequence can start.  SEQ64_NULL_MIDIPULSE if no
+     *  parked sequence has a trigger ahead.
+     */
+
+    midipulse m_play_set_wake;
+
+    /**
+     *  The playback mode in force when the play set was last built.  The
+     *  criteria for parking a sequence differ between Live and Song mode.
+     */
+
+    bool m_play_set_mode;
+
+    /**
+     *  The "last tick" shared by all parked sequences, which is the value
+     *  that sequence::play() would have given each of them:  the tick after
+     *  the last frame played, or the value given to set_orig_ticks(), or 0
+     *  after reset_sequences().
+     */
+
+    midipulse m_park_tick;
+
+    /**
+     *  Serializes access to the play set between the output thread and the
+     *  callers of set_orig_ticks() and reset_sequences().  The JACK engine
+     *  does not take it; see play_set_locker.
+     */
+
+    mutex m_play_set_mutex;
+
+    /**
+     *  The threads that split the play set among themselves in play(), if
+     *  the "rc" [playback-threads] setting is greater than 1.  Otherwise
+     *  null, and the output thread plays the patterns itself.
+     */
+
+    std::unique_ptr<render_pool> m_render_pool;
+
+    /**
+     *  One render buffer per share of the render pool, or just one if there
+     *  is no pool.
+     */
+
+    std::vector<render_buffer> m_render_buffers;
+
+    /**
+     *  The merge of m_render_buffers, in deterministic order, that is sent
+     *  to the master bus.
+     */
+
+    render_buffer m_render_merge;
+
+    /**
+     *  For each entry of the play set, set by the render pool: true if the
+     *  sequence was parked after the frame, and its wake tick.  These are
+     *  applied by the output thread, in order, after the frame.  A vector of
+     *  char, not bool, so that the threads write separate bytes.
+     */
+
+    std::vector<char> m_play_set_parked;
+    std::vector<midipulse> m_play_set_wakes;
+
+    /**
+     *  Frame parameters for the render pool threads:  the start of the frame
+     *  and the resume-note-ons flag.  The end of the frame is m_tick.
+     */
+
+    midipulse m_render_start;
+    bool m_render_resume;
+
+    /**
+     *  True if the "rc" [jack-engine] setting is on and the MIDI API took
+     *  over playback.  The JACK process callback then calls engine_cycle()
+     *  once per period, which renders the period into the output ports of
+     *  the same cycle, and the output thread only starts and stops playback
+     *  (see engine_run()).
+     */
+
+    bool m_engine;
+
+    /**
+     *  True while the output thread is playing in engine mode.  Only then
+     *  does engine_cycle() render.
+     */
+
+    std::atomic<bool> m_engine_rolling;
+
+    /**
+     *  True while engine_cycle() is running.  Together with m_engine_holds,
+     *  it keeps the engine and hold_play_set() apart without a lock:  each
+     *  side raises its own flag, then checks that of the other.
+     */
+
+    std::atomic<bool> m_engine_busy;
+
+    /**
+     *  The number of threads in hold_play_set().  While it is not 0,
+     *  engine_cycle() skips its period, and adds its frames to
+     *  m_engine_lag.
+     */
+
+    std::atomic<int> m_engine_holds;
+
+    /**
+     *  The scratchpad, the render buffer, and the frames of the periods
+     *  skipped, of engine_cycle().  Used only by engine_cycle() while
+     *  m_engine_rolling is true, and set up by engine_run() before that.
+     *  The buffer is reserved, and drops what does not fit, so that the
+     *  process callback never allocates.
+     */
+
+    jack_scratchpad m_engine_pad;
+    render_buffer m_engine_buffer;
+    long m_engine_lag;
+
+    /**
+     *  What engine_cycle() cannot do in the process callback, since it takes
+     *  the master bus lock, is left to the output thread (see
+     *  engine_follow()):  a change of tempo (0.0 if none), the starting of
+     *  the MIDI clock (the tick, or -1 if none), the MIDI clock itself, and
+     *  the stopping of playback when JACK transport stops.
+     */
+
+    std::atomic<midibpm> m_engine_tempo;
+    std::atomic<long> m_engine_init_clock;
+    std::atomic<long> m_engine_clock;
+    std::atomic<bool> m_engine_stopped;
+
+    /**
+     *  The time base of the MIDI clock emitter.  The clock tick
+     *  m_clock_anchor_tick falls due at the monotonic time
+     *  m_clock_anchor_us, and the later ones follow at m_clock_bpm.  The
+     *  output thread sets the anchor when playback starts, and moves it when
+     *  the tempo changes.  m_clock_run is bumped at each start and stop, so
+     *  that the emitter knows to start over, and m_clock_rolling is true
+     *  while playback runs.  All are guarded by m_clock_mutex.
+     */
+
+    long long m_clock_anchor_us;
+    midipulse m_clock_anchor_tick;
+    midibpm m_clock_bpm;
+    long m_clock_run;
+    bool m_clock_rolling;
+    mutex m_clock_mutex;
+
 #ifdef SEQ64_EDIT_SEQUENCE_HIGHLIGHT
 
     /**
@@ -1656,6 +1919,7 @@ public:
     void set_beats_per_bar (int bpm)
     {
         m_beats_per_bar = bpm;
+        m_tempo_map.default_time_signature(m_beats_per_bar, m_beat_width);
 #ifdef SEQ64_JACK_SUPPORT
         m_jack_asst.set_beats_per_measure(bpm);
 #endif
@@ -1681,6 +1945,7 @@ public:
     void set_beat_width (int bw)
     {
         m_beat_width = bw;
+        m_tempo_map.default_time_signature(m_beats_per_bar, m_beat_width);
 #ifdef SEQ64_JACK_SUPPORT
         m_jack_asst.set_beat_width(bw);
 #endif
@@ -2183,6 +2448,28 @@ public:
 
     void set_tick (midipulse tick);
 
+    /**
+     * \getter m_park_tick
+     *      Used by parked sequences in place of their own last tick.
+     */
+
+    midipulse park_tick () const
+    {
+        return m_park_tick;
+    }
+
+    /**
+     * \setter m_play_set_dirty
+     *      Called by a parked sequence when its state changes in a way that
+     *      might make it produce output.  The output thread rebuilds the play
+     *      set before the next frame.
+     */
+
+    void wake_play_set ()
+    {
+        m_play_set_dirty = true;
+    }
+
     /**
      * \getter m_jack_tick
      */
@@ -2336,6 +2623,27 @@ public:
             m_master_bus->get_beats_per_minute() : 0.0 ;
     }
 
+    /**
+     * \getter m_clock_dll
+     *      Provides the lock and drift statistics of the MIDI clock loop.
+     */
+
+    const clock_dll & midi_clock_dll () const
+    {
+        return m_clock_dll;
+    }
+
+    /**
+     * \getter m_tempo_map
+     *      Used by the user-interface and JACK to show and report the
+     *      position when the tempo changes during the song.
+     */
+
+    const tempo_map & get_tempo_map () const
+    {
+        return m_tempo_map;
+    }
+
     bool reload_mute_groups (std::string & errmessage);
     bool clear_mute_groups ();
     void set_sequence_control_status (int status);
@@ -2386,6 +2694,25 @@ public:
     void toggle_playing_tracks ();
     void mute_screenset (int ss, bool flag = true);
     void output_func ();
+    midipulse midi_clock_ticks ();
+    void engine_run (const jack_scratchpad & startpad);
+    void engine_follow ();
+    int engine_cycle
+    (
+        long frames, long rate, engine_event * events, int capacity
+    );
+    int engine_render
+    (
+        long frames, long rate, engine_event * events, int capacity
+    );
+    void engine_emit
+    (
+        midipulse start, long base, double fpt, long frames,
+        engine_event * events, int capacity, int & count
+    );
+    bool engine_lock (sequence * s);
+    void engine_unlock (sequence * s);
+    static bool in_engine_cycle ();
     void input_func ();
     bool poll_cycle ();
     void set_group_mute_state (int gtrack, bool muted);
@@ -3064,9 +3391,14 @@ public:         // GUI-support functions
         return m_mode_group_learn;
     }
 
-    void set_beats_per_minute (midibpm bpm);    /* more than just a setter  */
+    void set_beats_per_minute                   /* more than just a setter  */
+    (
+        midibpm bpm, midipulse tick = SEQ64_NULL_MIDIPULSE
+    );
     void set_ppqn (int p);
     void panic ();                              /* from kepler43        */
+    void rebuild_tempo_map ();
+    bool render_song (render_buffer & captured);
 
 private:
 
@@ -3105,6 +3437,7 @@ private:
     midi_control & midi_control_toggle (int ctl);
     midi_control & midi_control_on (int ctl);
     midi_control & midi_control_off (int ctl);
+    void rebuild_midi_control_index ();
     bool midi_control_event (const event & ev, bool recording = false);
     bool midi_control_record (const event & ev);
     bool handle_midi_control (int control, bool state);
@@ -3176,6 +3509,10 @@ private:
 
     void play (midipulse tick);
     void set_orig_ticks (midipulse tick);
+    void rebuild_play_set (midipulse tick);
+    void set_play_set_wake (midipulse waketick);
+    void hold_play_set ();
+    void release_play_set ();
     int max_active_set () const;
 
     /*
@@ -3184,6 +3521,13 @@ private:
 
     void launch_input_thread ();
     void launch_output_thread ();
+    void launch_clock_thread ();
+    void launch_render_pool ();
+    void clock_func ();
+    void clock_mark (midipulse tick, midibpm bpm, bool start = false);
+    void clock_stop ();
+    long long clock_due_us (midipulse tick) const;
+    void play_share (int share);
     bool init_jack_transport ();
     bool deinit_jack_transport ();
     bool seq_in_playing_screen (int seq);
@@ -3307,6 +3651,7 @@ private:
 private:
 
     bool log_current_tempo ();
+    void seek_tempo (midipulse tick, midipulse when = SEQ64_NULL_MIDIPULSE);
     bool create_master_bus ();
 
 #ifdef USE_STAZED_PARSE_SYSEX               // specific to Seq32
@@ -3446,7 +3791,12 @@ private:
  */
 
 extern void * output_thread_func (void * p);
+extern void * clock_thread_func (void * p);
 extern void * input_thread_func (void * p);
+extern int perform_engine_callback
+(
+    void * arg, long frames, long rate, engine_event * events, int capacity
+);
 
 }           // namespace seq64
 
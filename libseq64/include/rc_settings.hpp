@@ -45,6 +45,7 @@
  */
 
 #include <string>
+#include <vector>
 
 #include "seq64_features.h"             /* SEQ64_USE_ZOOM_POWER_OF_2    */
 #include "app_limits.h"                 /* SEQ64_ALSA_OUTPUT_BUSS_MAX   */
@@ -265,6 +266,97 @@ private:
 
     int m_tempo_track_number;
 
+    /**
+     *  The number of threads that render the patterns in perform::play(),
+     *  counting the output thread.  1 means the patterns are played serially
+     *  by the output thread, as in Seq24.  See the [playback-threads]
+     *  section of the "rc" file.
+     */
+
+    int m_playback_threads;
+
+    /**
+     *  If true, the output thread paces itself with CLOCK_MONOTONIC and
+     *  absolute deadlines, and derives the tick position from the time
+     *  elapsed since the start of playback, instead of adding up the time
+     *  of each pass.  Linux only.  See the [output-timing] section of the
+     *  "rc" file.
+     */
+
+    bool m_absolute_timing;
+
+    /**
+     *  The period of the output thread, in microseconds, when
+     *  m_absolute_timing is true.
+     */
+
+    int m_frame_period_us;
+
+    /**
+     *  The last part of each wait of the output thread, in microseconds,
+     *  that is spent spinning on the clock, when m_absolute_timing is true.
+     */
+
+    int m_spin_tail_us;
+
+    /**
+     *  If greater than 0, the output thread plays the patterns this many
+     *  milliseconds ahead, and the MIDI API schedules the events on its
+     *  queue.  See the [output-lookahead] section of the "rc" file.
+     */
+
+    int m_lookahead_ms;
+
+    /**
+     *  If true, and JACK MIDI is in use, the JACK process callback renders
+     *  the patterns for each period and writes them to the output ports,
+     *  instead of the output thread.  See the [jack-engine] section of the
+     *  "rc" file.
+     */
+
+    bool m_jack_engine;
+
+    /**
+     *  If true, an incoming MIDI clock is followed by a delay-locked loop,
+     *  which estimates the tempo and phase of the clock, and playback moves
+     *  smoothly between the clocks, at full PPQN.  Otherwise playback moves
+     *  by a whole clock at each clock.  See the [midi-clock-dll] section of
+     *  the "rc" file.
+     */
+
+    bool m_midi_clock_dll;
+
+    /**
+     *  If true, the MIDI clock is sent by a thread of its own, at absolute
+     *  deadlines, rather than by the output thread as it plays the patterns.
+     *  See the [midi-clock-emitter] section of the "rc" file.
+     */
+
+    bool m_clock_emitter;
+
+    /**
+     *  Holds the MIDI clock offset of each output buss, in microseconds.  A
+     *  buss not in the vector has an offset of 0.  Used only by the clock
+     *  emitter.
+     */
+
+    std::vector<long> m_clock_offsets;
+
+    /**
+     *  The rate at which SysEx messages are sent to an output buss, in bytes
+     *  per second.  The default, 3125, is the rate of a DIN MIDI cable at
+     *  31.25 kbaud.  See the [sysex-output] section of the "rc" file.
+     */
+
+    int m_sysex_rate;
+
+    /**
+     *  The size, in bytes, of the ring-buffer of each JACK port.  See the
+     *  [jack-ringbuffer] section of the "rc" file.
+     */
+
+    int m_jack_ring_size;
+
     /**
      *  Holds a few MIDI file-names most recently used.  Although this is a
      *  vector, we do not let it grow past SEQ64_RECENT_FILES_MAX.
@@ -740,6 +832,112 @@ public:
         return m_tempo_track_number;
     }
 
+    /**
+     * \getter m_playback_threads
+     */
+
+    int playback_threads () const
+    {
+        return m_playback_threads;
+    }
+
+    /**
+     * \getter m_absolute_timing
+     */
+
+    bool absolute_timing () const
+    {
+        return m_absolute_timing;
+    }
+
+    /**
+     * \getter m_frame_period_us
+     */
+
+    int frame_period_us () const
+    {
+        return m_frame_period_us;
+    }
+
+    /**
+     * \getter m_spin_tail_us
+     */
+
+    int spin_tail_us () const
+    {
+        return m_spin_tail_us;
+    }
+
+    /**
+     * \getter m_lookahead_ms
+     */
+
+    int lookahead_ms () const
+    {
+        return m_lookahead_ms;
+    }
+
+    /**
+     * \getter m_jack_engine
+     */
+
+    bool jack_engine () const
+    {
+        return m_jack_engine;
+    }
+
+    /**
+     * \getter m_midi_clock_dll
+     */
+
+    bool midi_clock_dll () const
+    {
+        return m_midi_clock_dll;
+    }
+
+    /**
+     * \getter m_clock_emitter
+     */
+
+    bool clock_emitter () const
+    {
+        return m_clock_emitter;
+    }
+
+    /**
+     * \getter m_clock_offsets
+     *
+     * \param bus
+     *      The output buss.
+     *
+     * \return
+     *      Returns the MIDI clock offset of the buss, in microseconds.
+     */
+
+    long clock_offset_us (int bus) const
+    {
+        return bus >= 0 && bus < int(m_clock_offsets.size()) ?
+            m_clock_offsets[bus] : 0 ;
+    }
+
+    /**
+     * \getter m_sysex_rate
+     */
+
+    int sysex_rate () const
+    {
+        return m_sysex_rate;
+    }
+
+    /**
+     * \getter m_jack_ring_size
+     */
+
+    int jack_ring_size () const
+    {
+        return m_jack_ring_size;
+    }
+
     std::string recent_file (int index, bool shorten = true) const;
 
     /**
@@ -834,6 +1032,42 @@ protected:
         m_priority = flag;
     }
 
+    /**
+     * \setter m_absolute_timing
+     */
+
+    void absolute_timing (bool flag)
+    {
+        m_absolute_timing = flag;
+    }
+
+    /**
+     * \setter m_jack_engine
+     */
+
+    void jack_engine (bool flag)
+    {
+        m_jack_engine = flag;
+    }
+
+    /**
+     * \setter m_midi_clock_dll
+     */
+
+    void midi_clock_dll (bool flag)
+    {
+        m_midi_clock_dll = flag;
+    }
+
+    /**
+     * \setter m_clock_emitter
+     */
+
+    void clock_emitter (bool flag)
+    {
+        m_clock_emitter = flag;
+    }
+
     /**
      * \setter m_stats
      */
@@ -938,6 +1172,13 @@ protected:
      */
 
     void tempo_track_number (int track);
+    void playback_threads (int count);
+    void frame_period_us (int us);
+    void spin_tail_us (int us);
+    void lookahead_ms (int ms);
+    void clock_offset_us (int bus, long us);
+    void sysex_rate (int rate);
+    void jack_ring_size (int bytes);
     void device_ignore_num (int value);
     bool interaction_method (interaction_method_t value);
     bool mute_group_saving (mute_group_handling_t mgh);
@@ -0,0 +1,222 @@
+#ifndef SEQ64_RENDER_LIST_HPP
+#define SEQ64_RENDER_LIST_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          render_list.hpp
+ *
+ *  This module declares a flat, playback-only copy of the events of a
+ *  sequence.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ *  The event_list used for editing is a node-based container of fairly
+ *  large event objects (each carries a SysEx vector, a link pointer, and
+ *  some flags).  Walking it during playback is a series of pointer chases.
+ *  The render_list is derived from the event_list and holds only what
+ *  sequence::play() and sequence::resume_note_ons() need, in contiguous
+ *  arrays:  the timestamps in one array, the packed status and data bytes in
+ *  another.  Tempo values and the note-off times of linked notes are kept in
+ *  arrays of their own.  SysEx and Meta events other than Set Tempo are never
+ *  sent by play(), so they are left out.
+ */
+
+#include <vector>
+
+#include "event.hpp"                    /* seq64::event, EVENT_MIDI_META    */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class event_list;
+
+/**
+ *  Holds the playable events of a sequence in a structure-of-arrays layout.
+ *  The owning sequence builds a new one after the event list has been
+ *  changed, and publishes it to the output thread, which never changes it.
+ */
+
+class render_list
+{
+
+private:
+
+    /**
+     *  The timestamp of each entry, in ascending order.
+     */
+
+    std::vector<midipulse> m_timestamps;
+
+    /**
+     *  The packed message of each entry.  For a channel event, the status
+     *  byte (without channel) is in bits 0 to 7, the first data byte in bits
+     *  8 to 15, and the second data byte in bits 16 to 23.  For a tempo
+     *  event, the status byte is EVENT_MIDI_META and the rest of the value
+     *  is the index of the tempo in m_tempos.
+     */
+
+    std::vector<midilong> m_messages;
+
+    /**
+     *  The tempo values of the Set Tempo events, in beats/minute.
+     */
+
+    std::vector<midibpm> m_tempos;
+
+    /**
+     *  The entry indices of the Note On events that are linked to a Note
+     *  Off, for use in resuming notes.
+     */
+
+    std::vector<int> m_note_ons;
+
+    /**
+     *  The timestamp of the Note Off linked to each entry in m_note_ons.
+     */
+
+    std::vector<midipulse> m_note_offs;
+
+public:
+
+    render_list ();
+
+    void build (const event_list & evl);
+    void clear ();
+    int lower_bound (midipulse tick) const;
+
+    /**
+     *  Returns the number of entries.
+     */
+
+    int count () const
+    {
+        return int(m_timestamps.size());
+    }
+
+    /**
+     *  Returns true if there is nothing to play.
+     */
+
+    bool empty () const
+    {
+        return m_timestamps.empty();
+    }
+
+    /**
+     *  Returns the timestamp of the given entry.  The index is not checked,
+     *  for speed.
+     */
+
+    midipulse timestamp (int i) const
+    {
+        return m_timestamps[i];
+    }
+
+    /**
+     *  Returns the status byte of the given entry.
+     */
+
+    midibyte status (int i) const
+    {
+        return midibyte(m_messages[i] & 0xFF);
+    }
+
+    /**
+     *  Returns the first data byte of the given entry.
+     */
+
+    midibyte d0 (int i) const
+    {
+        return midibyte((m_messages[i] >> 8) & 0xFF);
+    }
+
+    /**
+     *  Returns the second data byte of the given entry.
+     */
+
+    midibyte d1 (int i) const
+    {
+        return midibyte((m_messages[i] >> 16) & 0xFF);
+    }
+
+    /**
+     *  Indicates if the given entry is a tempo entry.
+     */
+
+    bool is_tempo (int i) const
+    {
+        return status(i) == EVENT_MIDI_META;
+    }
+
+    /**
+     *  Returns the tempo of the given entry, which must be a tempo entry.
+     */
+
+    midibpm tempo (int i) const
+    {
+        return m_tempos[m_messages[i] >> 8];
+    }
+
+    /**
+     *  Returns the number of linked Note Ons.
+     */
+
+    int note_on_count () const
+    {
+        return int(m_note_ons.size());
+    }
+
+    /**
+     *  Returns the entry index of the given linked Note On.
+     */
+
+    int note_on (int n) const
+    {
+        return m_note_ons[n];
+    }
+
+    /**
+     *  Returns the timestamp of the Note Off linked to the given Note On.
+     */
+
+    midipulse note_off_time (int n) const
+    {
+        return m_note_offs[n];
+    }
+
+};          // class render_list
+
+}           // namespace seq64
+
+#endif      // SEQ64_RENDER_LIST_HPP
+
+/*
+ * render_list.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
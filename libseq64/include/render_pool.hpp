@@ -0,0 +1,285 @@
+#ifndef SEQ64_RENDER_POOL_HPP
+#define SEQ64_RENDER_POOL_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          render_pool.hpp
+ *
+ *  This module declares the classes for rendering the patterns of a frame on
+ *  more than one thread.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ *  With hundreds of active patterns at a high PPQN, having the output thread
+ *  play every pattern serially can overrun the frame.  If the "rc" file
+ *  [playback-threads] setting is greater than 1, perform::play() splits the
+ *  play set among the threads of a render_pool.  Each thread plays its
+ *  patterns into its own render_buffer, rather than onto the master bus.
+ *  The output thread then merges the buffers into one, ordered by tick,
+ *  then by the rank of the pattern in the play set, then by the order in
+ *  which the pattern emitted the events.  Since this order does not depend
+ *  on which thread played what, or when, the output is deterministic.  The
+ *  merged buffer goes to mastermidibase in one batch.
+ */
+
+#include <functional>                   /* std::function                */
+#include <vector>                       /* std::vector                  */
+#include <pthread.h>                    /* pthread_t                    */
+
+#include "midibyte.hpp"                 /* midipulse, midibpm, bussbyte */
+#include "mutex.hpp"                    /* seq64::condition_var         */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class event;
+
+/**
+ *  Holds the events rendered by some patterns during one frame.
+ */
+
+class render_buffer
+{
+
+public:
+
+    /**
+     *  One rendered event, or a tempo change.
+     */
+
+    struct item
+    {
+        midipulse ri_tick;          /**< The absolute tick, the sort key.   */
+        int ri_order;               /**< The rank of the pattern.           */
+        int ri_serial;              /**< The order of emission.             */
+        bussbyte ri_bus;            /**< The output buss of the pattern.    */
+        midibyte ri_channel;        /**< The channel of the pattern.        */
+        midibyte ri_status;         /**< Status, EVENT_MIDI_META for tempo. */
+        midibyte ri_d0;             /**< The first data byte.               */
+        midibyte ri_d1;             /**< The second data byte.              */
+        midibpm ri_tempo;           /**< The tempo of a tempo item.         */
+    };
+
+private:
+
+    /**
+     *  The rendered items, in order of emission until merge() sorts them.
+     *  The storage is reused from frame to frame.
+     */
+
+    std::vector<item> m_items;
+
+    /**
+     *  The start of the frame.
+     */
+
+    midipulse m_tick;
+
+    /**
+     *  The tick given to events that are not played at a tick of their own,
+     *  such as the Note Offs sent when a pattern is turned off.  This is
+     *  the latest tick added so far for the current pattern, or the start
+     *  of the frame, so that these events sort after the ones the pattern
+     *  has already played in the frame, as they would go out serially.
+     */
+
+    midipulse m_last_tick;
+
+    /**
+     *  The rank, in the play set, of the pattern now being played into this
+     *  buffer.
+     */
+
+    int m_order;
+
+    /**
+     *  The most items the buffer holds, or 0 for no limit.  Set by
+     *  reserve(), for a buffer filled where nothing may allocate.
+     */
+
+    int m_limit;
+
+public:
+
+    render_buffer ();
+
+    void reserve (int limit);
+    void reset (midipulse tick);
+    void add (midipulse tick, bussbyte bus, midibyte channel, const event & ev);
+    void add (const item & ri);
+    void add_tempo (midipulse tick, midibpm bpm);
+    void merge (const std::vector<render_buffer> & buffers);
+    void sort ();
+
+    /**
+     * \setter m_order
+     *      Called before playing each pattern into the buffer.  Also resets
+     *      m_last_tick to the start of the frame.
+     */
+
+    void order (int rank)
+    {
+        m_order = rank;
+        m_last_tick = m_tick;
+    }
+
+    /**
+     *  Returns the number of items.
+     */
+
+    int count () const
+    {
+        return int(m_items.size());
+    }
+
+    /**
+     *  Returns true if the buffer is at its limit, so that add() drops.
+     */
+
+    bool full () const
+    {
+        return m_limit > 0 && count() >= m_limit;
+    }
+
+    /**
+     *  Returns the given item.  The index is not checked.
+     */
+
+    const item & at (int i) const
+    {
+        return m_items[i];
+    }
+
+};          // class render_buffer
+
+/**
+ *  A small pool of worker threads, each pinned to a CPU, that runs one job
+ *  per frame.  The calling thread does share 0 of the job itself, and the
+ *  workers do shares 1 and up; run() returns when all of the shares are
+ *  done.
+ */
+
+class render_pool
+{
+
+public:
+
+    /**
+     *  The work to do for each share.  The parameter is the share number,
+     *  which ranges from 0 to count() - 1.
+     */
+
+    typedef std::function<void (int)> job;
+
+private:
+
+    /**
+     *  The work to do.  Set once, so that run() does not allocate.
+     */
+
+    job m_job;
+
+    /**
+     *  The worker threads.
+     */
+
+    std::vector<pthread_t> m_threads;
+
+    /**
+     *  Wakes up the workers when a frame is ready, or when stopping.  Also
+     *  protects m_generation and m_stop.
+     */
+
+    condition_var m_start;
+
+    /**
+     *  Signals the caller of run() when the last worker is done, and the
+     *  constructor when each worker has started.  Also protects m_pending
+     *  and m_started.
+     */
+
+    condition_var m_done;
+
+    /**
+     *  Incremented for each run(), so that a worker can tell a new frame
+     *  from a spurious wakeup.
+     */
+
+    unsigned long m_generation;
+
+    /**
+     *  Counts the workers as they start, to give each a share number.
+     */
+
+    int m_started;
+
+    /**
+     *  The number of workers not yet done with the current frame.
+     */
+
+    int m_pending;
+
+    /**
+     *  Tells the workers to exit.
+     */
+
+    bool m_stop;
+
+public:
+
+    render_pool (int count, const job & work);
+    ~render_pool ();
+
+    void run ();
+
+    /**
+     *  Returns the number of shares, which is the number of worker threads
+     *  plus the calling thread.
+     */
+
+    int count () const
+    {
+        return int(m_threads.size()) + 1;
+    }
+
+private:
+
+    static void * worker_func (void * mypool);
+    void work ();
+
+};          // class render_pool
+
+}           // namespace seq64
+
+#endif      // SEQ64_RENDER_POOL_HPP
+
+/*
+ * render_pool.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -38,6 +38,7 @@
  *  module, and now just call its member functions to do the actual work.
  */
 
+#include <atomic>
 #include <string>
 #include <stack>
 
@@ -45,10 +46,14 @@
 #include "calculations.hpp"             /* measures_to_ticks()          */
 #include "palette.hpp"                  /* enum class ThumbColor        */
 #include "event_list.hpp"               /* seq64::event_list            */
+#include "event_pack.hpp"               /* seq64::event_pack            */
 #include "midi_container.hpp"           /* seq64::midi_container        */
+#include "midi_control_out.hpp"         /* seq64::midi_control_out      */
 #include "midibus.hpp"                  /* seq64::midibus               */
 #include "mutex.hpp"                    /* seq64::mutex, automutex      */
+#include "render_list.hpp"              /* seq64::render_list           */
 #include "scales.h"                     /* key and scale constants      */
+#include "snapshot.hpp"                 /* seq64::snapshot template     */
 #include "triggers.hpp"                 /* seq64::triggers, etc.        */
 
 /**
@@ -65,6 +70,8 @@ namespace seq64
 {
     class mastermidibus;
     class perform;
+    class tempo_map;
+    class render_buffer;
 
 /**
  *  Provides a set of methods for drawing certain items.  These values are
@@ -169,11 +176,43 @@ public:
 private:
 
     /**
-     *  Provides a stack of event-lists for use with the undo and redo
-     *  facility.
+     *  Provides a stack of packed event-lists for use with the undo and redo
+     *  facility.  An event_list can be pushed directly; it is packed on the
+     *  way in.
      */
 
-    typedef std::stack<event_list> EventStack;
+    typedef std::stack<event_pack> EventStack;
+
+    /**
+     *  Locks m_mutex for an edit.  When the outermost edit_locker of a
+     *  thread is released, the playback data are published (see publish()),
+     *  so that a function made of several locked edits publishes once.
+     */
+
+    class edit_locker
+    {
+
+    private:
+
+        sequence & m_seq;
+
+    public:
+
+        edit_locker (sequence & s) : m_seq (s)
+        {
+            m_seq.m_mutex.lock();
+            ++m_seq.m_edit_depth;
+        }
+
+        ~edit_locker ()
+        {
+            if (--m_seq.m_edit_depth == 0)
+                m_seq.publish();
+
+            m_seq.m_mutex.unlock();
+        }
+
+    };
 
 private:
 
@@ -181,7 +220,7 @@ private:
      * Documented at the definition point in the cpp module.
      */
 
-    static event_list m_events_clipboard;   /* shared between sequences */
+    static event_pack m_events_clipboard;   /* shared between sequences */
 
     /**
      *  For pause support, we need a way for the sequence to find out if JACK
@@ -205,7 +244,9 @@ private:
 
     /**
      *  Holds the list of triggers associated with the sequence, used in the
-     *  performance/song editor.
+     *  performance/song editor.  The editors change it under m_mutex; the
+     *  output thread plays the index that it publishes (see
+     *  triggers::publish()).
      */
 
     triggers m_triggers;
@@ -227,9 +268,11 @@ private:
      *  the sequence::Events typedef.
      *
      *      Events m_events_undo_hold;
+     *
+     *  Now packed, like the undo stack it is pushed onto.
      */
 
-    event_list m_events_undo_hold;
+    event_pack m_events_undo_hold;
 
     /**
      *  A stazed flag indicating that we have some undo information.
@@ -490,6 +533,72 @@ private:
     midipulse m_queued_tick;        /**< Provides the tick for queuing.     */
     midipulse m_trigger_offset;     /**< Provides the trigger offset.       */
 
+    /**
+     *  Holds the published flat copy of the playable events, which is all
+     *  that play() and resume_note_ons() read.  The editor builds a new one
+     *  at the end of an edit (see publish()) if the event list has changed
+     *  structurally (see event_list::generation()), or if modify() or an
+     *  in-place edit of event data flagged m_render_dirty.  Changes of the
+     *  playing state do not flag it, so that muting and queuing do not
+     *  rebuild it.  Playback carries on with the events as they were before
+     *  an edit until the edit is done.  The generation is protected by
+     *  m_mutex; m_render_dirty is set by modify() without a lock, and so is
+     *  atomic.
+     */
+
+    snapshot<render_list> m_render_snapshot;
+    unsigned long m_render_generation;  /**< Event list generation built.   */
+    std::atomic<bool> m_render_dirty;   /**< Forces a rebuild when edited.  */
+
+    /**
+     *  The published render list that play() is walking, and that
+     *  m_play_cursor indexes.  It is replaced by the next one published when
+     *  play() sees it.  Protected by m_play_mutex.
+     */
+
+    std::shared_ptr<const render_list> m_play_render;
+
+    /**
+     *  Counts the edit_locker objects that hold m_mutex, so that only the
+     *  outermost one publishes.  Protected by m_mutex.
+     */
+
+    int m_edit_depth;
+
+    /**
+     *  Provides a persistent playback cursor, so that play() can resume at
+     *  the next due event rather than rescanning the events from the
+     *  beginning on every output frame.  The cursor is an index into
+     *  m_play_render plus the multiple of m_length added to the timestamp of
+     *  the entry it points to.  It is reused only if the next frame starts
+     *  at m_play_cursor_tick and the render list has not been rebuilt since;
+     *  otherwise it is repositioned.
+     */
+
+    int m_play_cursor;
+    midipulse m_play_cursor_base;   /**< Offset of the event at the cursor. */
+    midipulse m_play_cursor_tick;   /**< Offset tick where next frame goes. */
+    bool m_play_cursor_valid;       /**< True if the cursor can be reused.  */
+
+    /**
+     *  Set when the performance has dropped this idle sequence from its play
+     *  set (see park() and perform::play()).  While parked, play() is not
+     *  called, and the last tick is the performance's park tick, not
+     *  m_last_tick (see last_tick()).  Protected by m_play_mutex.
+     */
+
+    bool m_parked;
+
+    /**
+     *  If not null, the buffer into which a render_pool thread, or the JACK
+     *  engine, is playing this sequence (see perform::play()).  Events go
+     *  there instead of to the master bus, and tempo changes are deferred,
+     *  until the output thread merges the buffers.  Set only while
+     *  m_play_mutex is held.
+     */
+
+    render_buffer * m_render_buffer;
+
     /**
      *  This constant provides the scaling used to calculate the time position
      *  in ticks (pulses), based also on the PPQN value.  Hardwired to
@@ -642,11 +751,24 @@ private:
 
     /**
      *  Provides locking for the sequence.  Made mutable for use in
-     *  certain locked getter functions.
+     *  certain locked getter functions.  It protects the event list and the
+     *  other editing data, including the triggers.  An edit can hold it for
+     *  a long time, so the output thread never locks it, and reads only what
+     *  the editors publish (see publish()).
      */
 
     mutable mutex m_mutex;
 
+    /**
+     *  Protects the playback state:  the playing, queued, and one-shot
+     *  flags, the last tick, the playing notes, the buss and channel, the
+     *  render list being played, and the playback cursor.  It is held only
+     *  briefly, and play() only tries to lock it.  A function that needs
+     *  both mutexes locks m_mutex first.
+     */
+
+    mutable mutex m_play_mutex;
+
     /**
      *  Provides the number of ticks to shave off of the end of painted notes.
      *  Also used when the user attempts to shrink a note to zero (or less
@@ -1039,6 +1161,7 @@ public:
     {
         m_song_mute = mute;
         set_dirty_mp();
+        wake();
     }
 
     /**
@@ -1050,6 +1173,7 @@ public:
     {
         m_song_mute = ! m_song_mute;
         set_dirty_mp();
+        wake();
     }
 
     /**
@@ -1208,7 +1332,8 @@ public:
 
     midipulse mod_last_tick ()
     {
-        return (m_length > 1) ? (m_last_tick % m_length) : m_last_tick ;
+        midipulse lt = last_tick();
+        return (m_length > 1) ? (lt % m_length) : lt ;
     }
 
     /*
@@ -1334,6 +1459,7 @@ public:
     void off_one_shot ();
     void song_recording_start (midipulse tick);
     void song_recording_stop (midipulse tick);
+    void song_recording_grow (midipulse tick);
 
     /**
      * \getter m_one_shot_tick
@@ -1421,6 +1547,11 @@ public:
     void print_triggers () const;
     void play (midipulse tick, bool playback_mode, bool resume = false);
     void play_queue (midipulse tick, bool playbackmode, bool resume);
+    void play_queue
+    (
+        midipulse tick, bool playbackmode, bool resume,
+        render_buffer & buffer
+    );
     bool add_note
     (
         midipulse tick, midipulse len, int note,
@@ -1655,14 +1786,28 @@ public:
         set_last_tick(0);
     }
 
+    /**
+     *  Forces play() to reposition the playback cursor on the next frame.
+     */
+
+    void invalidate_play_cursor ()
+    {
+        m_play_cursor_valid = false;
+    }
+
+    void reset_play_cursor (midipulse tick);
+    const render_list & render_events ();
+
     void play_note_on (int note);
     void play_note_off (int note);
     void off_playing_notes ();
     void stop (bool song_mode = false);
     void pause (bool song_mode = false);
+    void fill_tempo_map (tempo_map & tm) const;
     void inc_draw_marker ();
     void reset_draw_marker ();
     void reset_draw_trigger_marker ();
+    void reset_draw_trigger_marker (midipulse starttick, midipulse endtick);
     void reset_ex_iterator (event_list::const_iterator & evi);
     draw_type_t get_next_note_event
     (
@@ -1829,7 +1974,11 @@ private:
     ) const;
 
     void set_parent (perform * p);
-    void put_event_on_bus (event & ev);
+    void publish ();
+    bool try_lock_play (render_buffer * rb);
+    void unlock_play ();
+    void send_seq_event (midi_control_out::seq_action what);
+    void put_event_on_bus (event & ev, midipulse tick = SEQ64_NULL_MIDIPULSE);
     void reset_loop ();
     void set_trigger_offset (midipulse trigger_offset);
     void adjust_trigger_offsets_to_length (midipulse newlen);
@@ -1837,6 +1986,19 @@ private:
     void remove (event_list::iterator i);
     void remove (event & e);
     void remove_all ();
+    midipulse last_tick () const;
+    bool idle
+    (
+        midipulse starttick, midipulse endtick,
+        bool songmode, midipulse & waketick
+    ) const;
+    bool park (bool songmode, midipulse & waketick);
+    bool unpark
+    (
+        midipulse lasttick, midipulse tick,
+        bool songmode, midipulse & waketick
+    );
+    void wake ();
 
     /**
      *  Checks to see if the event's channel matches the sequence's nominal
@@ -0,0 +1,183 @@
+#ifndef SEQ64_SNAPSHOT_HPP
+#define SEQ64_SNAPSHOT_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          snapshot.hpp
+ *
+ *  This module declares a holder of immutable data that the editing threads
+ *  publish for the output thread.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ *  A sequence keeps the data that its editors change (the event list, the
+ *  trigger list) apart from the data that the output thread plays (the
+ *  render list, the trigger index).  After an edit, the editor builds a new
+ *  copy of the playback data, and swaps it in atomically.  The output thread
+ *  only loads the current copy; it never locks out an editor, and is never
+ *  locked out by one.  The copies are never changed once published.
+ */
+
+#include <atomic>                       /* std::atomic<>                */
+#include <memory>                       /* std::shared_ptr              */
+#include <vector>                       /* std::vector                  */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Holds the current published copy of a T.  Only one thread at a time may
+ *  publish, which the owner ensures by its edit lock.  Any thread may load.
+ *
+ *  A copy that is replaced is kept, rather than freed, until no reader
+ *  holds it any more, so that the last reference to it is always dropped by
+ *  the publishing thread.  Thus the output thread never frees memory.
+ *
+ *  The current copy is reached through a pointer to a shared pointer, which
+ *  is swapped atomically.  Unlike std::atomic_load() of a shared pointer,
+ *  which libstdc++ guards with a lock, a load is then only an atomic read
+ *  and a count increment, so that the JACK process callback can load.
+ */
+
+template <typename T>
+class snapshot
+{
+
+private:
+
+    typedef std::shared_ptr<const T> pointer;
+
+    /**
+     *  The holder of the copy that load() returns.
+     */
+
+    std::atomic<const pointer *> m_current;
+
+    /**
+     *  The number of load() calls in progress.  The publishing thread frees
+     *  a replaced holder only when it is zero, since a reader might still be
+     *  copying the shared pointer out of it.
+     */
+
+    mutable std::atomic<int> m_loading;
+
+    /**
+     *  All of the holders, the current one included, that have not been
+     *  freed.  Used only by the publishing thread.
+     */
+
+    std::vector<const pointer *> m_holders;
+
+public:
+
+    /**
+     * \ctor snapshot
+     *      Publishes a default T, so that load() never returns null.
+     */
+
+    snapshot ()
+     :
+        m_current   (nullptr),
+        m_loading   (0),
+        m_holders   ()
+    {
+        const pointer * h = new pointer(std::make_shared<T>());
+        m_holders.push_back(h);
+        m_current = h;
+    }
+
+    /**
+     *  Frees all of the holders.  No thread may load any more.
+     */
+
+    ~snapshot ()
+    {
+        for (size_t i = 0; i < m_holders.size(); ++i)
+            delete m_holders[i];
+    }
+
+    /**
+     *  Returns the current copy.  Does not allocate, lock, or wait on the
+     *  publishing thread.
+     *
+     * \threadsafe
+     */
+
+    pointer load () const
+    {
+        ++m_loading;
+        pointer result = *m_current.load();
+        --m_loading;
+        return result;
+    }
+
+    /**
+     *  Makes a new copy current, and frees the replaced copies that no
+     *  reader still holds.  A replaced copy can no longer be loaded, so a
+     *  use count of 1 (that of its holder) means that it is done with.  If
+     *  a load() is under way, the freeing waits for the next publish().
+     *
+     * \param p
+     *      The new copy.  The caller must not change it after this call.
+     */
+
+    void publish (const pointer & p)
+    {
+        const pointer * h = new pointer(p);
+        m_holders.push_back(h);
+
+        m_current = h;
+        if (m_loading == 0)
+        {
+            for (size_t i = 0; i < m_holders.size(); /* see body */ )
+            {
+                const pointer * r = m_holders[i];
+                if (r != h && r->use_count() == 1)
+                {
+                    delete r;
+                    m_holders[i] = m_holders.back();
+                    m_holders.pop_back();
+                }
+                else
+                    ++i;
+            }
+        }
+    }
+
+};          // class snapshot
+
+}           // namespace seq64
+
+#endif      // SEQ64_SNAPSHOT_HPP
+
+/*
+ * snapshot.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
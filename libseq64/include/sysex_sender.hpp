@@ -0,0 +1,138 @@
+#ifndef SEQ64_SYSEX_SENDER_HPP
+#define SEQ64_SYSEX_SENDER_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          sysex_sender.hpp
+ *
+ *  This module declares a background sender of SysEx messages.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ *  The ALSA busses used to send a SysEx message in pieces of
+ *  c_midibus_sysex_chunk bytes, sleeping 80 ms after each piece, on the
+ *  thread of the caller.  A long dump passed through from the input thread
+ *  held up everything for many seconds.  Now mastermidibase::sysex() just
+ *  copies the message into the outbox of each output buss, and the thread
+ *  of the sysex_sender sends the pieces, paced at the "rc" [sysex-output]
+ *  rate.  A buss that takes each message whole, such as a JACK port, gets
+ *  it whole, and is paced message by message.  Each buss is paced on its
+ *  own, and the buss is locked only while a piece goes out, so the pieces
+ *  interleave with the playback events.
+ */
+
+#include <deque>                        /* std::deque                   */
+#include <vector>                       /* std::vector                  */
+#include <pthread.h>                    /* pthread_t                    */
+
+#include "event.hpp"                    /* seq64::event, SysexContainer */
+#include "mutex.hpp"                    /* seq64::condition_var         */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class midibase;
+
+/**
+ *  Sends SysEx messages to the output busses from a thread of its own, a
+ *  piece at a time, at the rate set in the "rc" file.
+ */
+
+class sysex_sender
+{
+
+private:
+
+    /**
+     *  The SysEx messages waiting to go out on one buss.
+     */
+
+    struct outbox
+    {
+        midibase * ob_bus;          /**< The output buss.                   */
+        std::deque<event::SysexContainer> ob_messages;  /**< The queue.     */
+        int ob_offset;              /**< The bytes of the front one sent.   */
+        long long ob_due_us;        /**< Time the next piece may go out.    */
+    };
+
+    /**
+     *  One outbox for each buss that has been sent SysEx.
+     */
+
+    std::vector<outbox> m_outboxes;
+
+    /**
+     *  Wakes up the sender thread when a message is queued, or when
+     *  stopping.  Also protects m_outboxes and m_stop.
+     */
+
+    condition_var m_cond;
+
+    /**
+     *  The sender thread, started by the first send().
+     */
+
+    pthread_t m_thread;
+
+    /**
+     *  True if m_thread was started.
+     */
+
+    bool m_launched;
+
+    /**
+     *  Tells the sender thread to exit.
+     */
+
+    bool m_stop;
+
+public:
+
+    sysex_sender ();
+    ~sysex_sender ();
+
+    void send (midibase * bus, const event & ev);
+    void stop ();
+
+private:
+
+    static void * sender_func (void * mysender);
+    void work ();
+    midibase * next_piece (long long now_us, event & piece, long long & due_us);
+
+};          // class sysex_sender
+
+}           // namespace seq64
+
+#endif      // SEQ64_SYSEX_SENDER_HPP
+
+/*
+ * sysex_sender.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
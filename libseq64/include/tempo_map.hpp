@@ -0,0 +1,208 @@
+#ifndef SEQ64_TEMPO_MAP_HPP
+#define SEQ64_TEMPO_MAP_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempo_map.hpp
+ *
+ *  This module declares a map of the tempo and time-signature changes of a
+ *  song, for converting between ticks and time.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ *  The functions in the calculations module, such as pulse_length_us(),
+ *  assume one tempo for the whole song.  Once the tempo track has tempo
+ *  changes, a tick no longer maps to a time by a simple product.  The
+ *  tempo_map holds the changes, sorted by tick, as segments of constant
+ *  tempo and time signature.  Each segment caches the time and the bar at
+ *  which it starts, so that a conversion is a binary search plus one
+ *  product, in either direction.
+ */
+
+#include <string>                       /* std::string                  */
+#include <vector>                       /* std::vector                  */
+
+#include "midibyte.hpp"                 /* midipulse, midi_measures     */
+#include "mutex.hpp"                    /* seq64::mutex, automutex      */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+    class event_list;
+
+/**
+ *  Maps ticks to microseconds and back, and ticks to measures, following the
+ *  tempo and time-signature events of the tempo track.  It is built by the
+ *  output thread and read by the GUI, so it is guarded by a mutex.
+ */
+
+class tempo_map
+{
+
+private:
+
+    /**
+     *  A tempo change or a time-signature change, as found in the tempo
+     *  track.
+     */
+
+    struct change
+    {
+        midipulse tc_tick;          /**< The tick of the change.            */
+        midibpm tc_bpm;             /**< The new tempo, or 0 if none.       */
+        int tc_beats_per_bar;       /**< The new numerator, or 0 if none.   */
+        int tc_beat_width;          /**< The new denominator.               */
+
+        /**
+         *  Orders the changes by tick, for std::stable_sort(), which keeps
+         *  the changes at the same tick in the order of the tempo track.
+         */
+
+        bool operator < (const change & rhs) const
+        {
+            return tc_tick < rhs.tc_tick;
+        }
+    };
+
+    /**
+     *  A stretch of the song with one tempo and one time signature.
+     */
+
+    struct segment
+    {
+        midipulse ts_tick;          /**< The tick at which it starts.       */
+        double ts_us;               /**< The time at which it starts.       */
+        double ts_us_per_tick;      /**< The length of a tick in it.        */
+        midibpm ts_bpm;             /**< The tempo in it.                   */
+        int ts_beats_per_bar;       /**< The numerator in it.               */
+        int ts_beat_width;          /**< The denominator in it.             */
+        midipulse ts_bar_tick;      /**< Start of the bar grid in force.    */
+        int ts_bar;                 /**< The bar, re 0, at ts_bar_tick.     */
+    };
+
+    /**
+     *  Guards the map against the output thread and the GUI.
+     */
+
+    mutable mutex m_mutex;
+
+    /**
+     *  The changes found in the tempo track, sorted by tick.
+     */
+
+    std::vector<change> m_changes;
+
+    /**
+     *  The segments built from the defaults and m_changes.  There is always
+     *  at least one, starting at tick 0.
+     */
+
+    std::vector<segment> m_segments;
+
+    /**
+     *  The PPQN of the song.
+     */
+
+    int m_ppqn;
+
+    /**
+     *  The tempo in force before the first tempo change.
+     */
+
+    midibpm m_bpm;
+
+    /**
+     *  The numerator in force before the first time-signature change.
+     */
+
+    int m_beats_per_bar;
+
+    /**
+     *  The denominator in force before the first time-signature change.
+     */
+
+    int m_beat_width;
+
+    /**
+     *  True if m_changes holds a tempo change.
+     */
+
+    bool m_has_tempo;
+
+    /**
+     *  True if m_changes holds a time-signature change.
+     */
+
+    bool m_has_time_signature;
+
+public:
+
+    tempo_map ();
+
+    void defaults (int ppqn, midibpm bpm, int beatsperbar, int beatwidth);
+    void build (const event_list & events);
+    void clear ();
+    void default_bpm (midibpm bpm);
+    void default_time_signature (int beatsperbar, int beatwidth);
+    double tick_to_us (midipulse tick) const;
+    midipulse us_to_tick (double us) const;
+    midibpm bpm_at (midipulse tick) const;
+    bool tick_to_measures (midipulse tick, midi_measures & measures) const;
+    std::string measure_string (midipulse tick) const;
+    std::string time_string (midipulse tick, bool showus = true) const;
+
+    /**
+     * \threadsafe
+     *
+     * \return
+     *      Returns true if the tempo track has a tempo change, in which case
+     *      the tempo depends on the position in the song.
+     */
+
+    bool has_tempo_changes () const
+    {
+        automutex locker(m_mutex);
+        return m_has_tempo;
+    }
+
+private:
+
+    void compute ();
+    int find_tick (midipulse tick) const;
+
+};          // class tempo_map
+
+}           // namespace seq64
+
+#endif      // SEQ64_TEMPO_MAP_HPP
+
+/*
+ * tempo_map.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
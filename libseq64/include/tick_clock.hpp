@@ -0,0 +1,127 @@
+#ifndef SEQ64_TICK_CLOCK_HPP
+#define SEQ64_TICK_CLOCK_HPP
+
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tick_clock.hpp
+ *
+ *  This module declares a map from the time of the monotonic clock to the
+ *  tick of the performance.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ *  The output thread marks the tick it is at, and the tempo, at the start of
+ *  each frame.  The input side can then tell the tick at which an event came
+ *  in, from the time at which it came in, rather than taking the tick at
+ *  which the input thread got around to it.  A few of the latest marks are
+ *  kept, so that an event that came in before a tempo change or a loop wrap
+ *  is mapped with the mark that was in force at the time.
+ */
+
+#include "midibyte.hpp"                 /* midipulse, midibpm           */
+
+/**
+ *  The number of marks kept by a tick_clock.  The output thread marks one
+ *  per frame, so this covers the last few frames.
+ */
+
+#define SEQ64_TICK_CLOCK_MARKS      16
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Maps monotonic time, in microseconds, to the tick of the performance.
+ *  It is not locked; mastermidibase guards it with its own mutex.
+ */
+
+class tick_clock
+{
+
+private:
+
+    /**
+     *  The tick of the performance at a given time, and the rate at which
+     *  the ticks go by from then on.
+     */
+
+    struct mark
+    {
+        long long tm_us;            /**< The monotonic time of the mark.    */
+        midipulse tm_tick;          /**< The tick at that time.             */
+        double tm_ticks_per_us;     /**< The tempo, in ticks per us.        */
+    };
+
+    /**
+     *  The latest marks, in a ring.
+     */
+
+    mark m_marks[SEQ64_TICK_CLOCK_MARKS];
+
+    /**
+     *  The index of the next mark to be written.
+     */
+
+    int m_next;
+
+    /**
+     *  The number of marks held, up to SEQ64_TICK_CLOCK_MARKS.
+     */
+
+    int m_count;
+
+public:
+
+    tick_clock ();
+
+    static long long now_us ();
+
+    /**
+     *  Forgets all of the marks, as when playback starts again.
+     */
+
+    void clear ()
+    {
+        m_next = m_count = 0;
+    }
+
+    void set_mark (midipulse tick, midibpm bpm, int ppqn, long long us);
+    midipulse tick_at (long long us) const;
+
+};          // class tick_clock
+
+}           // namespace seq64
+
+#endif      // SEQ64_TICK_CLOCK_HPP
+
+/*
+ * tick_clock.hpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -38,6 +38,9 @@
 #include <string>
 #include <list>
 #include <stack>
+#include <vector>
+
+#include "snapshot.hpp"                 /* seq64::snapshot<>            */
 
 /**
  *  Indicates that there is no paste-trigger.  This is a new feature from the
@@ -320,6 +323,40 @@ private:
 
     typedef std::stack<List> Stack;
 
+    /**
+     *  One entry of the trigger index.  The tick values are copied from the
+     *  trigger, so that the searches do not chase the list nodes.
+     */
+
+    struct span
+    {
+        midipulse ts_start;         /**< The start tick of the trigger.     */
+        midipulse ts_end;           /**< The end tick of the trigger.       */
+        midipulse ts_offset;        /**< The offset of the trigger.         */
+        List::iterator ts_trigger;  /**< The trigger itself, for drawing.   */
+    };
+
+    /**
+     *  The trigger index, as published for the output thread.  It is a copy
+     *  of m_index and m_index_ordered, and is never changed once published.
+     *  The output thread reads only the ticks, never the list iterators,
+     *  which belong to the editors.
+     */
+
+    struct play_index
+    {
+        std::vector<span> pi_spans; /**< The index, in list order.          */
+        bool pi_ordered;            /**< The spans can be searched.         */
+
+        play_index ()
+         :
+            pi_spans    (),
+            pi_ordered  (true)
+        {
+            // Empty body
+        }
+    };
+
 private:
 
     /**
@@ -361,10 +398,62 @@ private:
     Stack m_redo_stack;
 
     /**
-     *  An iterator for cycling through the triggers during playback.
+     *  A flat copy of the trigger list, in the same order, for binary
+     *  searches by the editing functions.  It is rebuilt lazily by index(),
+     *  after any change to the list.  It is mutable so that the const
+     *  lookups can rebuild it.  The output thread does not use it; see
+     *  m_play_index.
+     */
+
+    mutable std::vector<span> m_index;
+
+    /**
+     *  Set when the trigger list changes, to tell index() to rebuild the
+     *  index.
+     */
+
+    mutable bool m_index_dirty;
+
+    /**
+     *  Set by index() if the start ticks and the end ticks both ascend, and
+     *  no trigger ends before it starts.  This is true of any list that the
+     *  editing functions produce; if it is not true, the searches fall back
+     *  to walking the list.
+     */
+
+    mutable bool m_index_ordered;
+
+    /**
+     *  The trigger index published for the output thread by publish(),
+     *  which the editing thread calls, with the sequence's edit lock held,
+     *  when an edit is done.  play() and covers() read only this, and so do
+     *  not need the edit lock.
+     */
+
+    snapshot<play_index> m_play_index;
+
+    /**
+     *  Set, along with m_index_dirty, when the trigger list changes, to tell
+     *  publish() to publish a new index.
+     */
+
+    bool m_play_dirty;
+
+    /**
+     *  The published index that play() last used, and that m_play_cursor
+     *  indexes.  Used only by the output thread.
+     */
+
+    std::shared_ptr<const play_index> m_play_current;
+
+    /**
+     *  The index of the first trigger not yet ended at the end of the last
+     *  frame played.  Since playback moves forward a little at a time, the
+     *  next frame usually starts its search here.  Used only by the output
+     *  thread.
      */
 
-    List::iterator m_iterator_play_trigger;
+    int m_play_cursor;
 
     /**
      *  An iterator for cycling through the triggers during drawing.
@@ -372,6 +461,14 @@ private:
 
     List::iterator m_iterator_draw_trigger;
 
+    /**
+     *  The tick past which next() stops returning triggers, or
+     *  SEQ64_NULL_MIDIPULSE to return them all.  See
+     *  reset_draw_trigger_marker().
+     */
+
+    midipulse m_draw_limit;
+
     /**
      *  Set to true if there is an active trigger in the trigger clipboard.
      */
@@ -445,10 +542,13 @@ public:
 
     /**
      * \getter m_triggers
+     *      Since the caller can change the list, the index is marked for
+     *      rebuilding.
      */
 
     List & triggerlist ()
     {
+        list_changed();
         return m_triggers;
     }
 
@@ -473,6 +573,7 @@ public:
     void push_undo ();
     void pop_undo ();
     void pop_redo ();
+    void publish ();
     void print (const std::string & seqname) const;
     bool play (midipulse & starttick, midipulse & endtick, bool resume = false);
     void add
@@ -493,6 +594,10 @@ public:
     bool unselect ();
     bool intersect (midipulse position, midipulse & start, midipulse & end);
     bool intersect (midipulse position);
+    bool covers
+    (
+        midipulse starttick, midipulse endtick, midipulse & nexttick
+    ) const;
 
     void remove_selected ();
     void copy_selected ();
@@ -516,6 +621,7 @@ public:
     {
         m_triggers.clear();
         m_number_selected = 0;
+        list_changed();
     }
 
     bool next
@@ -532,8 +638,11 @@ public:
     void reset_draw_trigger_marker ()
     {
         m_iterator_draw_trigger = m_triggers.begin();
+        m_draw_limit = SEQ64_NULL_MIDIPULSE;
     }
 
+    void reset_draw_trigger_marker (midipulse starttick, midipulse endtick);
+
     void set_trigger_paste_tick (midipulse tick)
     {
         m_paste_tick = tick;
@@ -546,6 +655,36 @@ public:
 
 private:
 
+    /**
+     *  Notes that the trigger list has changed, so that the index is rebuilt
+     *  and published again.
+     */
+
+    void list_changed ()
+    {
+        m_index_dirty = true;
+        m_play_dirty = true;
+    }
+
+    /**
+     *  The trigger::at_trigger_transition() test, for an entry of a
+     *  published index.
+     */
+
+    static bool at_transition (const span & ts, midipulse s, midipulse e)
+    {
+        return
+        (
+            s == ts.ts_start || e == ts.ts_start ||
+            s == ts.ts_end   || e == ts.ts_end
+        );
+    }
+
+    bool index () const;
+    static int find_end
+    (
+        const std::vector<span> & spans, midipulse tick, bool after
+    );
     midipulse adjust_offset (midipulse offset);
     void offset_selected (midipulse tick, grow_edit_t editmode);
     void split (trigger & t, midipulse splittick);
@@ -850,6 +850,21 @@ private:
 
     std::string m_user_option_logfile;
 
+    /**
+     *  If not empty, seq64cli renders the song given on the command line to
+     *  this MIDI file, as fast as it can, and exits, instead of running.
+     *  Set by the "-o render=filename" option.  Not saved.
+     */
+
+    std::string m_user_option_render;
+
+    /**
+     *  The format of the rendered MIDI file, 0 or 1.  Set by the
+     *  "-o render-format=0" option.  Not saved.
+     */
+
+    int m_user_option_render_format;
+
     /*
      *  [user-work-arounds]
      */
@@ -1836,6 +1851,24 @@ public:
 
     std::string option_logfile () const;
 
+    /**
+     * \getter m_user_option_render
+     */
+
+    const std::string & option_render () const
+    {
+        return m_user_option_render;
+    }
+
+    /**
+     * \getter m_user_option_render_format
+     */
+
+    int option_render_format () const
+    {
+        return m_user_option_render_format;
+    }
+
     /**
      * \getter m_work_around_play_image
      */
@@ -2015,6 +2048,28 @@ public:         // used in main application module and the userfile class
         m_user_option_logfile = logfile;
     }
 
+    /**
+     * \setter m_user_option_render
+     */
+
+    void option_render (const std::string & filename)
+    {
+        m_user_option_render = filename;
+    }
+
+    /**
+     * \setter m_user_option_render_format
+     *
+     * \param smfformat
+     *      The format, 0 or 1.  Other values are ignored.
+     */
+
+    void option_render_format (int smfformat)
+    {
+        if (smfformat == 0 || smfformat == 1)
+            m_user_option_render_format = smfformat;
+    }
+
     /**
      * \setter m_work_around_play_image
      */
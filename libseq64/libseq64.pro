@@ -38,6 +38,7 @@ HEADERS += \
  include/businfo.hpp \
  include/calculations.hpp \
  include/click.hpp \
+ include/clock_dll.hpp \
  include/cmdlineopts.hpp \
  include/configfile.hpp \
  include/controllers.hpp \
@@ -47,6 +48,7 @@ HEADERS += \
  include/editable_events.hpp \
  include/event.hpp \
  include/event_list.hpp \
+ include/event_pack.hpp \
  include/file_functions.hpp \
  include/gdk_basic_keys.h \
  include/globals.h \
@@ -77,10 +79,16 @@ HEADERS += \
  include/rc_settings.hpp \
  include/recent.hpp \
  include/rect.hpp \
+ include/render_list.hpp \
+ include/render_pool.hpp \
  include/scales.h \
  include/seq64_features.h \
  include/sequence.hpp \
  include/settings.hpp \
+ include/snapshot.hpp \
+ include/sysex_sender.hpp \
+ include/tempo_map.hpp \
+ include/tick_clock.hpp \
  include/triggers.hpp \
  include/user_instrument.hpp \
  include/user_midi_bus.hpp \
@@ -92,6 +100,7 @@ SOURCES += \
  src/businfo.cpp \
  src/calculations.cpp \
  src/click.cpp \
+ src/clock_dll.cpp \
  src/cmdlineopts.cpp \
  src/configfile.cpp \
  src/controllers.cpp \
@@ -101,6 +110,7 @@ SOURCES += \
  src/editable_events.cpp \
  src/event.cpp \
  src/event_list.cpp \
+ src/event_pack.cpp \
  src/file_functions.cpp \
  src/gui_assistant.cpp \
  src/jack_assistant.cpp \
@@ -125,9 +135,14 @@ SOURCES += \
  src/rc_settings.cpp \
  src/recent.cpp \
  src/rect.cpp \
+ src/render_list.cpp \
+ src/render_pool.cpp \
  src/seq64_features.cpp \
  src/sequence.cpp \
  src/settings.cpp \
+ src/sysex_sender.cpp \
+ src/tempo_map.cpp \
+ src/tick_clock.cpp \
  src/triggers.cpp \
  src/user_instrument.cpp \
  src/user_midi_bus.cpp \
@@ -460,6 +460,24 @@ busarray::clock (midipulse tick)
         bi->clock(tick);
 }
 
+/**
+ *  Clocks at the given tick for one buss, if it is valid; used for output
+ *  busses only.
+ *
+ * \param bus
+ *      The MIDI buss to clock.
+ *
+ * \param tick
+ *      Provides the tick value to use as the clock tick.
+ */
+
+void
+busarray::clock (bussbyte bus, midipulse tick)
+{
+    if (bus < count())
+        m_container[bus].clock(tick);
+}
+
 /**
  *  Handles SysEx events; used for output busses.
  *
@@ -475,6 +493,25 @@ busarray::sysex (event * ev)
         bi->sysex(ev);
 }
 
+/**
+ *  Sends Note Offs for the notes sounding on each active buss.  See
+ *  midibase::notes_off().
+ *
+ * \param allnotesoff
+ *      If true, an All Notes Off is also sent on each channel used.
+ */
+
+void
+busarray::notes_off (bool allnotesoff)
+{
+    std::vector<businfo>::iterator bi;
+    for (bi = m_container.begin(); bi != m_container.end(); ++bi)
+    {
+        if (bi->active())
+            bi->bus()->notes_off(allnotesoff);
+    }
+}
+
 /**
  *  Plays an event, if the bus is proper.
  *
@@ -498,6 +535,59 @@ busarray::play (bussbyte bus, event * e24, midibyte channel)
         m_container[bus].bus()->play(e24, channel);
 }
 
+/**
+ *  Schedules an event on the given buss, if it is valid and active.
+ *
+ * \param bus
+ *      The MIDI buss on which to play the event.
+ *
+ * \param e24
+ *      A pointer to the event to be played.
+ *
+ * \param channel
+ *      The MIDI channel on which to play the event.
+ *
+ * \param tick
+ *      The tick of the MIDI API's queue at which the event is due.
+ */
+
+void
+busarray::play_at
+(
+    bussbyte bus, event * e24, midibyte channel, midipulse tick
+)
+{
+    if (bus < count() && m_container[bus].active())
+        m_container[bus].bus()->play_at(e24, channel, tick);
+}
+
+/**
+ *  Plays the events of a frame that belong to the given buss, if it is
+ *  valid and active.  See midibase::play(const render_buffer &, ...).
+ *
+ * \param batch
+ *      The merged render buffer of the frame.
+ *
+ * \param bus
+ *      The MIDI buss whose events are to be played.
+ *
+ * \param stamped
+ *      If true, the events are scheduled at their ticks plus the offset.
+ *
+ * \param offset
+ *      The offset of the queue ticks from the ticks of the performance.
+ */
+
+void
+busarray::play
+(
+    const render_buffer & batch, bussbyte bus, bool stamped, midipulse offset
+)
+{
+    if (bus < count() && m_container[bus].active())
+        m_container[bus].bus()->play(batch, bus, stamped, offset);
+}
+
 /**
  *  Sets the clock type for the given bus, usually the output buss.
  *  This code is a bit more restrictive than the original code in
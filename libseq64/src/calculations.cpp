@@ -405,7 +405,31 @@ pulses_to_timestring (midipulse p, const midi_timing & timinginfo)
 std::string
 pulses_to_timestring (midipulse p, midibpm bpm, int ppqn, bool showus)
 {
-    unsigned long microseconds = ticks_to_delta_time_us(p, bpm, ppqn);
+    return microseconds_to_timestring
+    (
+        ticks_to_delta_time_us(p, bpm, ppqn), showus
+    );
+}
+
+/**
+ *  Converts a time in microseconds into a string that represents
+ *  "hours:minutes:seconds.fraction", as described for
+ *  pulses_to_timestring().  Used by the tempo_map, where the time of a tick
+ *  depends on the tempo changes before it.
+ *
+ * \param microseconds
+ *      Provides the time from the start of the song.
+ *
+ * \param showus
+ *      If true (the default), shows the microseconds as well.
+ *
+ * \return
+ *      Returns the time-string representation of the time.
+ */
+
+std::string
+microseconds_to_timestring (unsigned long microseconds, bool showus)
+{
     int seconds = int(microseconds / 1000000UL);
     int minutes = seconds / 60;
     int hours = seconds / (60 * 60);
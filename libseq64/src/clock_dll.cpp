@@ -0,0 +1,292 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          clock_dll.cpp
+ *
+ *  This module defines a delay-locked loop that follows an incoming MIDI
+ *  clock.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ */
+
+#include <cmath>                        /* std::fabs(), std::sqrt()         */
+
+#include "app_limits.h"                 /* SEQ64_DEFAULT_BPM, etc.          */
+#include "clock_dll.hpp"                /* seq64::clock_dll                 */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Two pi, for the angular bandwidth of the loop.  M_PI is not portable.
+ */
+
+static const double s_two_pi = 6.283185307179586;
+
+/**
+ *  Gets the period of the MIDI clock, 24 clocks per beat, at a tempo, kept
+ *  within the range of tempos that Sequencer64 allows.
+ *
+ * \param bpm
+ *      The tempo, in beats per minute.
+ *
+ * \return
+ *      Returns the period of one clock, in microseconds.
+ */
+
+static double
+clock_period (double bpm)
+{
+    if (bpm < SEQ64_MINIMUM_BPM)
+        bpm = SEQ64_MINIMUM_BPM;
+    else if (bpm > SEQ64_MAXIMUM_BPM)
+        bpm = SEQ64_MAXIMUM_BPM;
+
+    return 60000000.0 / (bpm * 24.0);
+}
+
+/**
+ * \defaultctor
+ */
+
+clock_dll::clock_dll ()
+ :
+    m_mutex         (),
+    m_increment     (1),
+    m_clocks        (0),
+    m_given         (0),
+    m_running       (false),
+    m_last_us       (0),
+    m_t0            (0.0),
+    m_t1            (0.0),
+    m_period        (clock_period(SEQ64_DEFAULT_BPM)),
+    m_good_clocks   (0),
+    m_locked        (false),
+    m_locks         (0),
+    m_unlocks       (0),
+    m_drift_us      (0.0),
+    m_max_drift_us  (0.0)
+{
+    // Empty body
+}
+
+/**
+ *  Starts following the clock afresh, as on a MIDI Start or Continue.  The
+ *  statistics are kept.
+ *
+ * \param increment
+ *      The number of ticks per clock, PPQN / 24.
+ *
+ * \param bpm
+ *      The current tempo, used as the period of the clock until a second
+ *      clock comes in.
+ */
+
+void
+clock_dll::start (int increment, midibpm bpm)
+{
+    automutex locker(m_mutex);
+    m_increment = increment > 0 ? increment : 1;
+    m_clocks = 0;
+    m_given = 0;
+    m_running = false;
+    m_last_us = 0;
+    m_period = clock_period(bpm);
+    m_good_clocks = 0;
+    m_locked = false;
+}
+
+/**
+ *  Stops following the clock, as on a MIDI Stop.  The position is held.
+ */
+
+void
+clock_dll::stop ()
+{
+    automutex locker(m_mutex);
+    m_running = false;
+    m_last_us = 0;
+    m_good_clocks = 0;
+    m_locked = false;
+}
+
+/**
+ *  Gives up the lock, counting the unlock if the loop was locked.  The
+ *  caller holds the mutex.
+ */
+
+void
+clock_dll::unlock ()
+{
+    if (m_locked)
+    {
+        m_locked = false;
+        ++m_unlocks;
+    }
+    m_good_clocks = 0;
+}
+
+/**
+ *  Feeds in a clock.  The error of the clock against the prediction moves
+ *  both the filtered time of the clock and the period.  The coefficients
+ *  follow from the bandwidth of the loop and the period, so the loop
+ *  behaves the same at any tempo.  A clock that is far off the prediction
+ *  starts the loop over from that clock.
+ *
+ * \threadsafe
+ *
+ * \param us
+ *      The monotonic time at which the clock came in, in microseconds.
+ */
+
+void
+clock_dll::clock (long long us)
+{
+    automutex locker(m_mutex);
+    double t = double(us);
+    ++m_clocks;
+    if (m_running)
+    {
+        double e = t - m_t1;
+        double error = std::fabs(e);
+        m_drift_us = e;
+        if (error > m_period * SEQ64_CLOCK_DLL_UNLOCK_ERROR)
+        {
+            unlock();
+            if (m_last_us > 0 && us > m_last_us)
+                m_period = clock_period(60000000.0 / ((us - m_last_us) * 24.0));
+
+            m_t0 = t;
+            m_t1 = t + m_period;
+        }
+        else
+        {
+            double w = s_two_pi * SEQ64_CLOCK_DLL_BANDWIDTH * m_period / 1e6;
+            m_t0 = m_t1;
+            m_t1 += std::sqrt(2.0) * w * e + m_period;
+            m_period += w * w * e;
+            if (error < m_period * SEQ64_CLOCK_DLL_LOCK_ERROR)
+                ++m_good_clocks;
+            else
+                m_good_clocks = 0;
+
+            if (m_locked)
+            {
+                if (error > m_max_drift_us)
+                    m_max_drift_us = error;
+            }
+            else if (m_good_clocks >= SEQ64_CLOCK_DLL_LOCK_CLOCKS)
+            {
+                m_locked = true;
+                m_max_drift_us = error;
+                ++m_locks;
+            }
+        }
+    }
+    else
+    {
+        m_running = true;
+        m_t0 = t;
+        m_t1 = t + m_period;
+        m_drift_us = 0.0;
+    }
+    m_last_us = us;
+}
+
+/**
+ *  Gets the number of ticks to advance playback by, since the last call.
+ *  The position at the given time is interpolated between the filtered
+ *  time of the latest clock and the predicted time of the next one, at full
+ *  PPQN.  It never goes past the tick of the next clock, so that playback
+ *  waits for a late clock rather than running ahead, and it never goes
+ *  backward.  If the clock has gone missing, the lock is given up and the
+ *  position is held.
+ *
+ * \threadsafe
+ *
+ * \param us
+ *      The current monotonic time, in microseconds.
+ *
+ * \return
+ *      Returns the number of ticks to advance by, 0 or more.
+ */
+
+midipulse
+clock_dll::advance (long long us)
+{
+    automutex locker(m_mutex);
+    midipulse result = 0;
+    if (m_running)
+    {
+        double t = double(us);
+        if (t > m_t1 + m_period * SEQ64_CLOCK_DLL_TIMEOUT_CLOCKS)
+        {
+            unlock();
+            m_running = false;
+            m_last_us = 0;
+        }
+
+        double fraction = (t - m_t0) / (m_t1 - m_t0);
+        if (fraction < 0.0)
+            fraction = 0.0;
+        else if (fraction > 1.0)
+            fraction = 1.0;
+
+        double clocks = double(m_clocks - 1) + fraction;
+        midipulse position = midipulse(clocks * m_increment);
+        if (position > m_given)
+        {
+            result = position - m_given;
+            m_given = position;
+        }
+    }
+    return result;
+}
+
+/**
+ * \threadsafe
+ *
+ * \return
+ *      Returns the tempo of the clock, as estimated from the filtered period.
+ */
+
+midibpm
+clock_dll::bpm () const
+{
+    automutex locker(m_mutex);
+    return 60000000.0 / (m_period * 24.0);
+}
+
+}           // namespace seq64
+
+/*
+ * clock_dll.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
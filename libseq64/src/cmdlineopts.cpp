@@ -327,6 +327,9 @@ static const char * const s_help_4 =
 " seq64cli:\n"
 "              daemonize     Makes this application fork to the background.\n"
 "              no-daemonize  Or not.  These options do not apply to Windows.\n"
+"              render=file   Renders the song in Song mode to a MIDI file,\n"
+"                            as fast as possible, and exits.\n"
+"              render-format=0|1  Writes the render as SMF 0 or 1 (default).\n"
 "\n"
 "The 'daemonize' option works only in the CLI build. The 'sets' option works in\n"
 "the CLI build as well.  Specify the '--user-save' option to make these options\n"
@@ -576,6 +579,23 @@ parse_o_options (int argc, char * argv [])
                                     }
                                 }
                             }
+                            else if (optionname == "render")
+                            {
+                                if (! arg.empty())
+                                {
+                                    usr().option_render(arg);
+                                    result = true;
+                                }
+                            }
+                            else if (optionname == "render-format")
+                            {
+                                if (arg == "0" || arg == "1")
+                                {
+                                    int smf = atoi(arg.c_str());
+                                    usr().option_render_format(smf);
+                                    result = true;
+                                }
+                            }
                             else if (optionname == "scale")
                             {
                                 if (arg.length() >= 1)
@@ -121,7 +121,8 @@ event_list::event_list ()
     m_events                (),
     m_is_modified           (false),
     m_has_tempo             (false),
-    m_has_time_signature    (false)
+    m_has_time_signature    (false),
+    m_generation            (0)
 {
     // No code needed
 }
@@ -138,14 +139,17 @@ event_list::event_list (const event_list & rhs)
     m_events                (rhs.m_events),
     m_is_modified           (rhs.m_is_modified),
     m_has_tempo             (rhs.m_has_tempo),
-    m_has_time_signature    (rhs.m_has_time_signature)
+    m_has_time_signature    (rhs.m_has_time_signature),
+    m_generation            (0)
 {
     // No code needed
 }
 
 /**
  *  Principal assignment operator.  Follows the stock rules for such an
- *  operator, just assigning member values.
+ *  operator, just assigning member values.  The generation count is not
+ *  copied; it is bumped, since all iterators into this container are now
+ *  invalid.
  *
  * \param rhs
  *      Provides the event list to be assigned.
@@ -160,6 +164,7 @@ event_list::operator = (const event_list & rhs)
         m_is_modified           = rhs.m_is_modified;
         m_has_tempo             = rhs.m_has_tempo;
         m_has_time_signature    = rhs.m_has_time_signature;
+        ++m_generation;
     }
     return *this;
 }
@@ -253,6 +258,7 @@ event_list::append (const event & e)
 #endif
 
     m_is_modified = true;
+    ++m_generation;
     if (e.is_tempo())
         m_has_tempo = true;
 
@@ -309,6 +315,7 @@ event_list::merge (event_list & el, bool /*presort*/ )
     int initialsize = count();
     int addedsize = el.count();
     m_events.insert(el.events().begin(), el.events().end());
+    ++m_generation;
     if (count() != (initialsize + addedsize))
     {
         char tmp[64];
@@ -330,6 +337,7 @@ event_list::merge (event_list & el, bool presort)
         el.sort();                          // el.m_events.sort();
 
     m_events.merge(el.m_events);
+    ++m_generation;
 }
 
 #endif  // SEQ64_USE_EVENT_MAP
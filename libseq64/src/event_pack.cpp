@@ -0,0 +1,205 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          event_pack.cpp
+ *
+ *  This module defines a compact, copyable snapshot of an event list.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ */
+
+#include <type_traits>                  /* std::is_trivially_copyable   */
+
+#include "event_list.hpp"               /* seq64::event_list, event     */
+#include "event_pack.hpp"               /* seq64::event_pack            */
+
+/**
+ *  The bits of event_pack::item::pe_flags.  The link of a Note event is not
+ *  kept, just the flags of the event.
+ */
+
+#define SEQ64_EVENT_PACK_SELECTED       0x01
+#define SEQ64_EVENT_PACK_MARKED         0x02
+#define SEQ64_EVENT_PACK_PAINTED        0x04
+#define SEQ64_EVENT_PACK_PAYLOAD        0x08
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+static_assert
+(
+    std::is_trivially_copyable<event_pack::item>::value,
+    "event_pack::item must be trivially copyable"
+);
+
+static_assert
+(
+    sizeof(event_pack::item) <= 16, "event_pack::item must fit in 16 bytes"
+);
+
+/**
+ * \defaultctor
+ */
+
+event_pack::event_pack ()
+ :
+    m_items     (),
+    m_spans     (),
+    m_bytes     ()
+{
+    // Empty body
+}
+
+/**
+ *  Packs the given event list.  This constructor is not explicit, so that
+ *  an event list can be pushed directly onto a stack of packs.
+ *
+ * \param evl
+ *      The events to pack.
+ */
+
+event_pack::event_pack (const event_list & evl)
+ :
+    m_items     (),
+    m_spans     (),
+    m_bytes     ()
+{
+    pack(evl);
+}
+
+/**
+ *  Replaces the contents of the pack with the events of the given list,
+ *  in the order of the list.
+ *
+ * \param evl
+ *      The events to pack.
+ */
+
+void
+event_pack::pack (const event_list & evl)
+{
+    clear();
+    m_items.reserve(evl.count());
+    for (event_list::const_iterator i = evl.begin(); i != evl.end(); ++i)
+    {
+        const event & e = event_list::dref(i);
+        item pe;
+        pe.pe_tick = e.get_timestamp();
+        pe.pe_status = e.get_status();
+        pe.pe_channel = e.get_channel();
+        e.get_data(pe.pe_d0, pe.pe_d1);
+        pe.pe_payload = 0;
+        pe.pe_flags = 0;
+        if (e.is_selected())
+            pe.pe_flags |= SEQ64_EVENT_PACK_SELECTED;
+
+        if (e.is_marked())
+            pe.pe_flags |= SEQ64_EVENT_PACK_MARKED;
+
+        if (e.is_painted())
+            pe.pe_flags |= SEQ64_EVENT_PACK_PAINTED;
+
+        if (e.get_sysex_size() > 0)
+        {
+            const event::SysexContainer & data = e.get_sysex();
+            span ps;
+            ps.ps_offset = int(m_bytes.size());
+            ps.ps_size = int(data.size());
+            pe.pe_payload = unsigned(m_spans.size());
+            pe.pe_flags |= SEQ64_EVENT_PACK_PAYLOAD;
+            m_spans.push_back(ps);
+            m_bytes.insert(m_bytes.end(), data.begin(), data.end());
+        }
+        m_items.push_back(pe);
+    }
+}
+
+/**
+ *  Replaces the events of the given list with the events of the pack.  The
+ *  events come back unlinked, so the caller must call verify_and_link() on
+ *  the sequence or the list.
+ *
+ * \param [out] evl
+ *      The list to fill.
+ */
+
+void
+event_pack::unpack (event_list & evl) const
+{
+    evl.clear();
+
+#ifdef SEQ64_USE_EVENT_MAP
+    for (int i = 0; i < count(); ++i)       /* the multimap keeps the order */
+#else
+    for (int i = count() - 1; i >= 0; --i)  /* append() does push_front()   */
+#endif
+    {
+        const item & pe = m_items[i];
+        event e;
+        e.set_timestamp(pe.pe_tick);
+        e.set_status(pe.pe_status, pe.pe_channel);
+        e.set_data(pe.pe_d0, pe.pe_d1);
+        if (pe.pe_flags & SEQ64_EVENT_PACK_SELECTED)
+            e.select();
+
+        if (pe.pe_flags & SEQ64_EVENT_PACK_MARKED)
+            e.mark();
+
+        if (pe.pe_flags & SEQ64_EVENT_PACK_PAINTED)
+            e.paint();
+
+        if (pe.pe_flags & SEQ64_EVENT_PACK_PAYLOAD)
+        {
+            const span & ps = m_spans[pe.pe_payload];
+            const midibyte * data = &m_bytes[ps.ps_offset];
+            e.get_sysex().assign(data, data + ps.ps_size);
+        }
+        evl.append(e);
+    }
+}
+
+/**
+ *  Empties the pack.  The storage is kept for the next pack().
+ */
+
+void
+event_pack::clear ()
+{
+    m_items.clear();
+    m_spans.clear();
+    m_bytes.clear();
+}
+
+}           // namespace seq64
+
+/*
+ * event_pack.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
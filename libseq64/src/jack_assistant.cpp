@@ -1063,21 +1063,20 @@ jack_assistant::position (bool songmode, midipulse tick)
         printf("jack position() tick = 0\n");
 #endif
 
-    if (songmode)                               /* master in song mode  */
-    {
-        if (is_null_midipulse(tick))
-            tick = 0;
-        else
-            tick *= 10;
-    }
-    else
+    if (! songmode || is_null_midipulse(tick))  /* master in song mode  */
         tick = 0;
 
-    int ticks_per_beat = m_ppqn * 10;
-    int beats_per_minute = parent().get_beats_per_minute();
-    uint64_t tick_rate = (uint64_t(m_jack_frame_rate) * tick * 60.0);
-    long tpb_bpm = ticks_per_beat * beats_per_minute * 4.0 / m_beat_width;
-    uint64_t jack_frame = tick_rate / tpb_bpm;
+    /*
+     *  The tempo map gives the time of the tick across the tempo changes of
+     *  the song.  The beat-width scaling is kept from the old calculation,
+     *  which located to tick * 60 * bw / (ppqn * bpm * 4) seconds.
+     */
+
+    double us = parent().get_tempo_map().tick_to_us(tick);
+    uint64_t jack_frame = uint64_t
+    (
+        us * m_jack_frame_rate * m_beat_width / 4000000.0
+    );
     if (m_jack_master)
     {
         /*
@@ -37,6 +37,7 @@
 #include "easy_macros.h"
 #include "event.hpp"                    /* seq64::event                     */
 #include "mastermidibase.hpp"           /* seq64::mastermidibase            */
+#include "render_pool.hpp"              /* seq64::render_buffer             */
 #include "sequence.hpp"                 /* seq64::sequence                  */
 #include "settings.hpp"                 /* seq64::rc()                      */
 
@@ -79,6 +80,14 @@ mastermidibase::mastermidibase
     m_vector_sequence   (),             /* stazed feature                   */
     m_filter_by_channel (false),        /* set based on configuration       */
     m_seq               (nullptr),
+    m_scheduling        (false),
+    m_schedule_offset   (0),
+    m_frame_stamping    (false),
+    m_tick_clock        (),
+    m_sysex_sender      (),
+    m_engine_callback   (nullptr),
+    m_engine_arg        (nullptr),
+    m_capture           (nullptr),
     m_mutex             ()
 {
     // Empty body now
@@ -117,6 +126,7 @@ void
 mastermidibase::start ()
 {
     automutex locker(m_mutex);
+    m_tick_clock.clear();
     api_start();
     m_outbus_array.start();
 }
@@ -136,6 +146,7 @@ void
 mastermidibase::continue_from (midipulse tick)
 {
     automutex locker(m_mutex);
+    m_tick_clock.clear();
     api_continue_from(tick);
     m_outbus_array.continue_from(tick);
 }
@@ -201,6 +212,26 @@ mastermidibase::emit_clock (midipulse tick)
     m_outbus_array.clock(tick);
 }
 
+/**
+ *  Generates the MIDI clock for one output buss.  Used by the clock emitter
+ *  of the performance, which clocks each buss at its own time.
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      Provides the buss to clock.
+ *
+ * \param tick
+ *      Provides the tick value with which to set the buss clock.
+ */
+
+void
+mastermidibase::emit_clock (bussbyte bus, midipulse tick)
+{
+    automutex locker(m_mutex);
+    m_outbus_array.clock(bus, tick);
+}
+
 /**
  *  Set the PPQN value (parts per quarter note). Then call the
  *  implementation-specific API function to complete the PPQN setting.
@@ -221,20 +252,35 @@ mastermidibase::set_ppqn (int ppqn)
 
 /**
  *  Set the BPM value (beats per minute).  Then call the
- *  implementation-specific API function to complete the BPM setting.
+ *  implementation-specific API function to complete the BPM setting.  If
+ *  events are being scheduled, and the change comes from a tempo event
+ *  played ahead of time, the change of the queue tempo is scheduled too, so
+ *  that the events queued before it keep their timing.
  *
  * \threadsafe
  *
  * \param bpm
  *      Provides the beats-per-minute value to set.
+ *
+ * \param tick
+ *      The tick of the performance at which the tempo changes, or
+ *      SEQ64_NULL_MIDIPULSE (the default) to change it now.
  */
 
 void
-mastermidibase::set_beats_per_minute (midibpm bpm)
+mastermidibase::set_beats_per_minute (midibpm bpm, midipulse tick)
 {
     automutex locker(m_mutex);
     m_beats_per_minute = bpm;
-    api_set_beats_per_minute(bpm);
+    if (not_nullptr(m_capture))
+        m_capture->add_tempo(tick, bpm);
+    else if (m_scheduling && ! is_null_midipulse(tick))
+    {
+        midipulse qtick = tick + m_schedule_offset;
+        api_schedule_beats_per_minute(bpm, qtick > 0 ? qtick : 0);
+    }
+    else
+        api_set_beats_per_minute(bpm);
 }
 
 /**
@@ -254,46 +300,76 @@ mastermidibase::flush ()
 
 /**
  *  Stops all notes on all channels on all busses.  Adapted from Oli Kester's
- *  Kepler34 project.
+ *  Kepler34 project.  This used to send a Note Off for every note on every
+ *  channel of every possible buss, which took seconds on a slow port.  Now
+ *  each buss sends a Note Off only for the notes it has sounding, then an
+ *  All Notes Off on each channel it has used.
+ *
+ * \threadsafe
  */
 
 void
 mastermidibase::panic ()
 {
-    event e;
-    e.set_status(EVENT_NOTE_OFF);
-    flush();
-    for (int bus = 0; bus < SEQ64_DEFAULT_BUSS_MAX; ++bus)
-    {
-        for (int channel = 0; channel < SEQ64_MIDI_CHANNEL_MAX; ++channel)
-        {
-            for (int note = 0; note < SEQ64_MIDI_COUNT_MAX; ++note)
-            {
-                e.set_data(note, SEQ64_MAX_NOTE_ON_VELOCITY);   /* 0 better? */
-                play(bus, &e, channel);
-            }
-        }
-    }
+    automutex locker(m_mutex);
+    api_flush();
+    m_outbus_array.notes_off(true);
+}
+
+/**
+ *  Sends a Note Off for each note still sounding on any output buss.  The
+ *  sequences turn off their own notes when stopped; this catches the rest,
+ *  such as notes that came in through MIDI thru.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibase::notes_off ()
+{
+    automutex locker(m_mutex);
+    m_outbus_array.notes_off(false);
 }
 
 /**
- *  Handle the sending of SYSEX events.  The event is sent to all MIDI output
- *  busses.  Then flush() is called.
+ *  Handle the sending of SYSEX events.  The event is queued for all MIDI
+ *  output busses, and m_sysex_sender sends it in the background, paced at
+ *  the "rc" [sysex-output] rate.  Hence this function returns at once, even
+ *  for a long dump, and does not hold up the input or output thread.
  *
  *  There's currently no implementation-specific API function for this call.
  *
  * \threadsafe
  *
  * \param ev
- *      Provides the event pointer to be set.
+ *      Provides the event pointer to be set.  The SysEx data is copied.
  */
 
 void
 mastermidibase::sysex (event * ev)
 {
     automutex locker(m_mutex);
-    m_outbus_array.sysex(ev);
-    flush();                /* recursive locking! */
+    if (not_nullptr(m_capture))
+        return;                             /* not part of a render     */
+
+    for (int bus = 0; bus < m_outbus_array.count(); ++bus)
+    {
+        midibus * b = m_outbus_array.bus(bussbyte(bus));
+        if (not_nullptr(b))
+            m_sysex_sender.send(b, *ev);
+    }
+}
+
+/**
+ *  Drops any SysEx not yet sent, and stops the sender thread.  Called by
+ *  perform before it deletes the master buss, since the busses, and the
+ *  MIDI API under them, are gone before the sender would be.
+ */
+
+void
+mastermidibase::stop_sysex ()
+{
+    m_sysex_sender.stop();
 }
 
 /**
@@ -320,7 +396,359 @@ void
 mastermidibase::play (bussbyte bus, event * e24, midibyte channel)
 {
     automutex locker(m_mutex);
-    m_outbus_array.play(bus, e24, channel);
+    if (not_nullptr(m_capture))
+        m_capture->add(SEQ64_NULL_MIDIPULSE, bus, channel, *e24);
+    else
+        m_outbus_array.play(bus, e24, channel);
+}
+
+/**
+ *  Plays an event that is due at the given tick of the performance.  If
+ *  events are being scheduled (see start_scheduling()), the tick is mapped
+ *  to the tick of the queue, and the MIDI API queues the event for that
+ *  time.  Otherwise, or if the tick is SEQ64_NULL_MIDIPULSE, the event is
+ *  played now, as in play().  A tick already in the past is sent at once.
+ *  With JACK, which places events by frame, the tick of the performance is
+ *  passed on as is (see frame_tick()).
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      The buss to play on.
+ *
+ * \param e24
+ *      The event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param tick
+ *      The tick of the performance at which the event is due.
+ */
+
+void
+mastermidibase::play_at
+(
+    bussbyte bus, event * e24, midibyte channel, midipulse tick
+)
+{
+    automutex locker(m_mutex);
+    if (not_nullptr(m_capture))
+        m_capture->add(tick, bus, channel, *e24);
+    else if (m_scheduling && ! is_null_midipulse(tick))
+    {
+        midipulse qtick = tick + m_schedule_offset;
+        m_outbus_array.play_at(bus, e24, channel, qtick > 0 ? qtick : 0);
+    }
+    else if (m_frame_stamping)
+        m_outbus_array.play_at(bus, e24, channel, tick);
+    else
+        m_outbus_array.play(bus, e24, channel);
+}
+
+/**
+ *  Turns on scheduled output, if the MIDI API supports it.  The queue is
+ *  restarted at tick 0, which the output thread maps to the tick of the
+ *  performance (see schedule_offset()).  Called by the output thread when
+ *  playback starts, if the "rc" [output-lookahead] setting is not 0.
+ *
+ * \threadsafe
+ *
+ * \return
+ *      Returns true if events are now scheduled.  If false, they are still
+ *      sent directly, and the output thread must not play ahead.
+ */
+
+bool
+mastermidibase::start_scheduling ()
+{
+    automutex locker(m_mutex);
+    m_schedule_offset = 0;
+    m_scheduling = api_start_scheduling();
+    return m_scheduling;
+}
+
+/**
+ *  Turns off scheduled output, and removes the events still in the queue,
+ *  except the Note Offs, which are left to go out on time, so that no note
+ *  is left hanging.  Called when playback stops or pauses, before the
+ *  sequences send their own Note Offs.
+ *
+ * \threadsafe
+ *
+ * \return
+ *      Returns true if events were being scheduled.  The sequences have then
+ *      been played ahead of the current tick.
+ */
+
+bool
+mastermidibase::stop_scheduling ()
+{
+    automutex locker(m_mutex);
+    bool result = m_scheduling;
+    if (result)
+    {
+        api_cancel_scheduled();
+        m_scheduling = false;
+    }
+    return result;
+}
+
+/**
+ *  Gets the current tick of the queue.  While events are scheduled, the
+ *  output thread advances the performance by this tick, rather than by its
+ *  own clock, so that the performance follows the tempo changes scheduled
+ *  on the queue.
+ *
+ * \threadsafe
+ *
+ * \return
+ *      Returns the tick of the queue, or SEQ64_NULL_MIDIPULSE if events are
+ *      not scheduled, or the tick is not available.
+ */
+
+midipulse
+mastermidibase::schedule_tick ()
+{
+    automutex locker(m_mutex);
+    return m_scheduling ? api_schedule_tick() : SEQ64_NULL_MIDIPULSE ;
+}
+
+/**
+ * \setter m_schedule_offset
+ *
+ * \threadsafe
+ *
+ * \param offset
+ *      The tick of the queue minus the tick of the performance.
+ */
+
+void
+mastermidibase::schedule_offset (midipulse offset)
+{
+    automutex locker(m_mutex);
+    m_schedule_offset = offset;
+}
+
+/**
+ *  Tells the MIDI API the tick of the performance at the current time, as
+ *  the output thread starts to play a frame.  A MIDI API that places events
+ *  by frame, such as JACK, uses it to convert the tick of each event to the
+ *  frame at which it is due.  It is called again after the position jumps,
+ *  as at the end of a loop.  The tick is also marked in the tick clock, for
+ *  input_tick().
+ *
+ * \threadsafe
+ *
+ * \param tick
+ *      The current tick.
+ */
+
+void
+mastermidibase::frame_tick (midipulse tick)
+{
+    automutex locker(m_mutex);
+    m_tick_clock.set_mark
+    (
+        tick, m_beats_per_minute, m_ppqn, tick_clock::now_us()
+    );
+    if (m_frame_stamping)
+        api_frame_tick(tick);
+}
+
+/**
+ *  Converts the timestamp of an input event to the tick of the performance
+ *  at which it came in.  A MIDI API that places events by frame, such as
+ *  JACK, converts the frame at which they came in with the same
+ *  tick-to-frame mapping it uses for output (see frame_tick()).  Otherwise,
+ *  the MIDI API tells how long ago the event came in, and the tick clock
+ *  gives the tick at that time.  An API that does not stamp its input
+ *  events gets the tick of the current time.
+ *
+ * \threadsafe
+ *
+ * \param stamp
+ *      The timestamp of the input event.
+ *
+ * \return
+ *      Returns the tick of the event, or SEQ64_NULL_MIDIPULSE if no tick
+ *      has been marked since playback started, in which case the caller
+ *      uses the current tick.
+ */
+
+midipulse
+mastermidibase::input_tick (midipulse stamp)
+{
+    automutex locker(m_mutex);
+    midipulse result = SEQ64_NULL_MIDIPULSE;
+    if (m_frame_stamping)
+        result = api_input_tick(stamp);
+
+    if (is_null_midipulse(result))
+        result = m_tick_clock.tick_at(input_time(stamp));
+
+    return result;
+}
+
+/**
+ *  Converts the timestamp of an input event to the monotonic time at which
+ *  it came in, from how long ago the MIDI API says it came in.  Used for
+ *  following an incoming MIDI clock.
+ *
+ * \threadsafe
+ *
+ * \param stamp
+ *      The timestamp of the input event.
+ *
+ * \return
+ *      Returns the time, in microseconds, as per tick_clock::now_us().  An
+ *      API that does not stamp its input events gets the current time.
+ */
+
+long long
+mastermidibase::input_time (midipulse stamp)
+{
+    automutex locker(m_mutex);
+    long age = api_input_age(stamp);
+    if (age < 0 || age > 1000000)           /* a stale or bogus stamp   */
+        age = 0;
+
+    return tick_clock::now_us() - age;
+}
+
+/**
+ *  Hands the timing of playback to the process cycle of the MIDI API, if
+ *  it has one (JACK).  The API then calls engine_cycle() once per period,
+ *  which calls the given function to render the period.
+ *
+ * \threadsafe
+ *
+ * \param callback
+ *      The function that renders one period.  A null pointer turns the
+ *      engine off.
+ *
+ * \param arg
+ *      The argument for the callback.
+ *
+ * \return
+ *      Returns true if the MIDI API now drives playback.
+ */
+
+bool
+mastermidibase::engine (engine_callback_t callback, void * arg)
+{
+    automutex locker(m_mutex);
+    m_engine_callback = callback;
+    m_engine_arg = arg;
+    bool result = api_engine(not_nullptr(callback));
+    if (! result)
+    {
+        m_engine_callback = nullptr;
+        m_engine_arg = nullptr;
+    }
+    return result;
+}
+
+/**
+ *  Called by the MIDI API at the start of each process cycle, before it
+ *  writes its output ports, to render that period.  No lock is taken here;
+ *  the callback is set before the engine is turned on.
+ *
+ * \param frames
+ *      The number of frames in the period.
+ *
+ * \param rate
+ *      The frame rate.
+ *
+ * \param events
+ *      The array to render the events of the period into, each at its
+ *      frame offset in the period.
+ *
+ * \param capacity
+ *      The number of items in the array.
+ *
+ * \return
+ *      Returns the number of events rendered.
+ */
+
+int
+mastermidibase::engine_cycle
+(
+    long frames, long rate, engine_event * events, int capacity
+)
+{
+    return not_nullptr(m_engine_callback) ?
+        m_engine_callback(m_engine_arg, frames, rate, events, capacity) : 0 ;
+}
+
+/**
+ *  Starts or stops the capture of the output.  While capturing, the events
+ *  played, and the tempo changes, are added to the given buffer instead of
+ *  going to the busses, and SysEx is dropped.  The clock is not captured.
+ *
+ * \threadsafe
+ *
+ * \param sink
+ *      The buffer to capture into, or a null pointer to stop capturing.
+ */
+
+void
+mastermidibase::capture (render_buffer * sink)
+{
+    automutex locker(m_mutex);
+    m_capture = sink;
+}
+
+/**
+ *  Plays the merged events of a frame (see render_buffer), in order.  The
+ *  master lock is taken once for the whole batch, and each buss that has
+ *  events in it plays all of them under one taking of its own lock, so
+ *  that the cost of locking is per frame, not per event.  Tempo items are
+ *  skipped; perform applies them.  The events are scheduled at their ticks,
+ *  if scheduling is on.  The events of different busses are not ordered
+ *  against each other, but those of each buss stay in order.  While
+ *  capturing (see capture()), the events go to the capture instead.
+ *
+ * \threadsafe
+ *
+ * \param batch
+ *      The merged render buffer of the frame.
+ */
+
+void
+mastermidibase::play (const render_buffer & batch)
+{
+    automutex locker(m_mutex);
+    if (not_nullptr(m_capture))
+    {
+        for (int i = 0; i < batch.count(); ++i)
+        {
+            const render_buffer::item & ri = batch.at(i);
+            if (ri.ri_status != EVENT_MIDI_META)
+                m_capture->add(ri);
+        }
+        return;
+    }
+
+    const int slots = 256;                      /* every bussbyte value     */
+    bool used[slots];
+    for (int b = 0; b < slots; ++b)
+        used[b] = false;
+
+    for (int i = 0; i < batch.count(); ++i)
+    {
+        const render_buffer::item & ri = batch.at(i);
+        if (ri.ri_status != EVENT_MIDI_META)
+            used[ri.ri_bus] = true;
+    }
+
+    bool stamped = m_scheduling || m_frame_stamping;
+    midipulse offset = m_scheduling ? m_schedule_offset : 0 ;
+    for (int b = 0; b < slots; ++b)
+    {
+        if (used[b])
+            m_outbus_array.play(batch, bussbyte(b), stamped, offset);
+    }
 }
 
 /**
@@ -695,6 +1123,68 @@ mastermidibase::get_midi_event (event * ev)
     return api_get_midi_event(ev);
 }
 
+/**
+ *  Grabs all of the pending MIDI events, up to a limit, via the
+ *  currently-selected MIDI API.  Call it after poll_for_midi() finds input.
+ *
+ * \param evs
+ *      The array of events to be set based on the found input events.
+ *
+ * \param count
+ *      The number of events that the array can hold.
+ *
+ * \return
+ *      Returns the number of events set, which can be 0 if only events that
+ *      are not MIDI, such as ALSA port events, were pending.
+ */
+
+int
+mastermidibase::get_midi_events (event * evs, int count)
+{
+    return api_get_midi_events(evs, count);
+}
+
+/**
+ *  Provides a default implementation of api_get_midi_events(), which grabs
+ *  one event at a time until is_more_input() finds no more.
+ *
+ * \param evs
+ *      The array of events to be set based on the found input events.
+ *
+ * \param count
+ *      The number of events that the array can hold.
+ *
+ * \return
+ *      Returns the number of events set.
+ */
+
+int
+mastermidibase::api_get_midi_events (event * evs, int count)
+{
+    int result = 0;
+    do
+    {
+        evs[result] = event();
+        if (api_get_midi_event(&evs[result]))
+            ++result;
+    }
+    while (result < count && is_more_input());
+    return result;
+}
+
+/**
+ *  Wakes up the input thread if it is waiting in poll_for_midi(), so that it
+ *  sees at once that it is to stop, instead of at the next timeout.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibase::wake_input ()
+{
+    api_wake_input();
+}
+
 /**
  *  Set the input sequence object, and set the m_dumping_input value to
  *  the given state.
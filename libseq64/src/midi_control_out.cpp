@@ -25,7 +25,7 @@
  * \library       sequencer64 application
  * \author        Igor Angst
  * \date          2018-03-28
- * \updates       2019-06-09
+ * \updates       2026-10-17
  * \license       GNU GPLv2 or above
  *
  * The class contained in this file encapsulates most of the functionality to
@@ -235,6 +235,25 @@ midi_control_out::send_seq_event (int seq, seq_action what, bool flush)
     }
 }
 
+/**
+ *  Adjusts the sequence number for the current screen-set as
+ *  send_seq_event() does, and copies the event if it is active.
+ */
+
+bool
+midi_control_out::seq_event (int seq, seq_action what, event & ev) const
+{
+    bool result = false;
+    seq -= m_screenset_offset;      // adjust relative to current screen-set
+    if (seq >= 0 && seq < screenset_size())
+    {
+        result = m_seq_events[seq][what].apt_action_status;
+        if (result)
+            ev = m_seq_events[seq][what].apt_action_event;
+    }
+    return result;
+}
+
 /**
  *  Clears all visible sequences by sending "delete" messages for all
  *  sequences ranging from 0 to 31.
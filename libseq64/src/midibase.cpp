@@ -50,6 +50,7 @@
 #include "calculations.hpp"             /* clock_ticks_from_ppqn()          */
 #include "event.hpp"                    /* seq64::event (MIDI event)        */
 #include "midibase.hpp"                 /* seq64::midibase for ALSA         */
+#include "render_pool.hpp"              /* seq64::render_buffer             */
 #include "settings.hpp"                 /* seq64::rc()                      */
 
 /*
@@ -170,6 +171,8 @@ midibase::midibase
     m_is_virtual_port   (makevirtual),
     m_is_input_port     (isinput),
     m_is_system_port    (makesystem),
+    m_notes_on          (),
+    m_channels_used     (0),
     m_mutex             ()
 {
     if (! makevirtual)
@@ -574,9 +577,164 @@ void
 midibase::play (event * e24, midibyte channel)
 {
     automutex locker(m_mutex);
+    track_note(e24, channel);
     api_play(e24, channel);
 }
 
+/**
+ *  Schedules an event to be sent at the given tick of the MIDI API's queue.
+ *  See mastermidibase::play_at().
+ *
+ * \threadsafe
+ *
+ * \param e24
+ *      The event to be played on this bus.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param tick
+ *      The tick of the queue at which the event is due.
+ */
+
+void
+midibase::play_at (event * e24, midibyte channel, midipulse tick)
+{
+    automutex locker(m_mutex);
+    track_note(e24, channel);
+    api_play_at(e24, channel, tick);
+}
+
+/**
+ *  Plays the events of a frame that belong to this buss, in order, taking
+ *  the lock of the buss once for the whole frame rather than once per event.
+ *  See mastermidibase::play(const render_buffer &).
+ *
+ * \threadsafe
+ *
+ * \param batch
+ *      The merged render buffer of the frame.  Tempo items are skipped.
+ *
+ * \param bus
+ *      The number of this buss, which selects the items to play.
+ *
+ * \param stamped
+ *      If true, each event is handed to api_play_at() at its tick plus the
+ *      offset, or at 0 if that is in the past.  Otherwise it is played now.
+ *
+ * \param offset
+ *      The offset of the queue ticks from the ticks of the performance.
+ */
+
+void
+midibase::play
+(
+    const render_buffer & batch, bussbyte bus, bool stamped, midipulse offset
+)
+{
+    automutex locker(m_mutex);
+    event ev;
+    for (int i = 0; i < batch.count(); ++i)
+    {
+        const render_buffer::item & ri = batch.at(i);
+        if (ri.ri_bus == bus && ri.ri_status != EVENT_MIDI_META)
+        {
+            ev.set_timestamp(ri.ri_tick);
+            ev.set_status(ri.ri_status);
+            ev.set_data(ri.ri_d0, ri.ri_d1);
+            track_note(&ev, ri.ri_channel);
+            if (stamped)
+            {
+                midipulse qtick = ri.ri_tick + offset;
+                api_play_at(&ev, ri.ri_channel, qtick > 0 ? qtick : 0);
+            }
+            else
+                api_play(&ev, ri.ri_channel);
+        }
+    }
+}
+
+/**
+ *  Updates m_notes_on for an event about to be played.  The channel is
+ *  figured as the MIDI API figures it, by adding the channel to the status.
+ *  The caller holds the lock.
+ *
+ * \param e24
+ *      The event to be played.
+ *
+ * \param channel
+ *      The channel of the playback.
+ */
+
+void
+midibase::track_note (const event * e24, midibyte channel)
+{
+    midibyte status = e24->get_status() + (channel & EVENT_GET_CHAN_MASK);
+    midibyte kind = status & EVENT_CLEAR_CHAN_MASK;
+    if (kind == EVENT_NOTE_ON || kind == EVENT_NOTE_OFF)
+    {
+        int ch = status & EVENT_GET_CHAN_MASK;
+        midibyte note, velocity;
+        e24->get_data(note, velocity);
+        if (note < SEQ64_MIDI_COUNT_MAX)
+        {
+            if (kind == EVENT_NOTE_ON && velocity > 0)
+            {
+                m_notes_on[ch].set(note);
+                m_channels_used |= 1u << ch;
+            }
+            else
+                m_notes_on[ch].reset(note);
+        }
+    }
+}
+
+/**
+ *  Sends a Note Off, now, for each note that m_notes_on shows as sounding
+ *  on this buss, rather than for every note on every channel.  Then the
+ *  buss is flushed.
+ *
+ * \threadsafe
+ *
+ * \param allnotesoff
+ *      If true, an All Notes Off controller is also sent on each channel
+ *      that has played a note since the last time, to catch notes that the
+ *      tracking missed, such as those a device held before we started.
+ */
+
+void
+midibase::notes_off (bool allnotesoff)
+{
+    automutex locker(m_mutex);
+    event ev;
+    for (int ch = 0; ch < SEQ64_MIDI_CHANNEL_MAX; ++ch)
+    {
+        if (m_notes_on[ch].any())
+        {
+            ev.set_status(EVENT_NOTE_OFF);
+            for (int note = 0; note < SEQ64_MIDI_COUNT_MAX; ++note)
+            {
+                if (m_notes_on[ch].test(note))
+                {
+                    ev.set_data(midibyte(note), 0);
+                    api_play(&ev, midibyte(ch));
+                }
+            }
+            m_notes_on[ch].reset();
+        }
+        if (allnotesoff && (m_channels_used & (1u << ch)) != 0)
+        {
+            ev.set_status(EVENT_CONTROL_CHANGE);
+            ev.set_data(midibyte(c_midibus_all_notes_off), 0);
+            api_play(&ev, midibyte(ch));
+        }
+    }
+    if (allnotesoff)
+        m_channels_used = 0;
+
+    api_flush();
+}
+
 /**
  *  Takes a native SYSEX event, encodes it to an ALSA event, and then
  *  puts it in the queue.
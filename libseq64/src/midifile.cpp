@@ -65,14 +65,17 @@
 
 #include <fstream>                      /* std::ifstream and std::ofstream  */
 #include <memory>                       /* std::unique_ptr<>                */
+#include <set>                          /* std::set<>                       */
 
 #include "calculations.hpp"             /* seq64::bpm_from_tempo_us()       */
 #include "file_functions.hpp"           /* seq64::get_full_path()           */
 #include "perform.hpp"                  /* must precede midifile.hpp !      */
 #include "midifile.hpp"                 /* seq64::midifile                  */
 #include "midi_vector.hpp"              /* seq64::midi_vector container     */
+#include "render_pool.hpp"              /* seq64::render_buffer             */
 #include "sequence.hpp"                 /* seq64::sequence                  */
 #include "settings.hpp"                 /* seq64::rc() and choose_ppqn()    */
+#include "tick_clock.hpp"               /* seq64::tick_clock::now_us()      */
 #include "wrkfile.hpp"                  /* seq64::wrkfile class             */
 
 /*
@@ -1534,6 +1537,7 @@ midifile::parse_proprietary_track (perform & p, int file_size)
                 read_byte_array(a, 6);
                 p.midi_control_off(i).set(a);
             }
+            p.rebuild_midi_control_index();
         }
         seqspec = parse_prop_header(file_size);
         if (seqspec == c_midiclocks)
@@ -1972,11 +1976,11 @@ midifile::varinum_size (long len) const
  */
 
 bool
-midifile::write_header (int numtracks)
+midifile::write_header (int numtracks, int smfformat)
 {
     write_long(0x4D546864);                 /* MIDI Format 1 header MThd    */
     write_long(6);                          /* Length of the header         */
-    write_short(1);                         /* MIDI Format 1                */
+    write_short(smfformat);                 /* MIDI Format 1, or 0          */
     write_short(numtracks);                 /* number of tracks             */
     write_short(m_ppqn);                    /* parts per quarter note       */
     return numtracks > 0;
@@ -2003,8 +2007,6 @@ midifile::write_start_tempo (midibpm start_tempo)
 
 #endif  // USE_WRITE_START_TEMPO
 
-#ifdef USE_WRITE_TIME_SIG
-
 /**
  *  Writes the main time signature, in a more simplistic manner than
  *  midi_container::fill_time_sig_and_tempo().
@@ -2031,8 +2033,6 @@ midifile::write_time_sig (int beatsperbar, int beatwidth)
     write_short(0x1808);                    /* cc bb                        */
 }
 
-#endif  // USE_WRITE_TIME_SIG
-
 /**
  *  Writes a "proprietary" (SeqSpec) Seq24 footer header in either the new
  *  MIDI-compliant format, or the legacy Seq24 format.  This function does not
@@ -2446,6 +2446,187 @@ midifile::write_song (perform & p)
     return result;
 }
 
+/**
+ *  Writes the capture of an offline render (see perform::render_song()) as
+ *  a standard MIDI file, with no SeqSpec data.  In SMF 0, all of the events
+ *  go into one track.  In SMF 1, the first track holds the time signature
+ *  and the tempo changes, and the events of each buss and channel go into a
+ *  track of their own, named for them.
+ *
+ * \param p
+ *      Provides the time signature, and the tick of the end of the song.
+ *
+ * \param captured
+ *      The events and tempo changes played, sorted by tick.
+ *
+ * \param smfformat
+ *      The format of the file, 0 or 1.  The default is 1.
+ *
+ * \return
+ *      Returns true if the write operations succeeded.  If false is returned,
+ *      then m_error_message will contain a description of the error.
+ */
+
+bool
+midifile::write_render
+(
+    perform & p,
+    const render_buffer & captured,
+    int smfformat
+)
+{
+    automutex locker(m_mutex);
+    std::set<int> keys;                         /* buss * 16 + channel      */
+    m_error_message.clear();
+    for (int i = 0; i < captured.count(); ++i)
+    {
+        const render_buffer::item & ri = captured.at(i);
+        if (ri.ri_status != EVENT_MIDI_META)
+            keys.insert(int(ri.ri_bus) * 16 + (ri.ri_channel & 0x0F));
+    }
+
+    bool smf0 = smfformat == 0;
+    bool result = ! keys.empty();
+    if (result)
+    {
+        int numtracks = smf0 ? 1 : 1 + int(keys.size()) ;
+        printf
+        (
+            "[Rendering song as SMF %d MIDI file, %d ppqn]\n",
+            smf0 ? 0 : 1, m_ppqn
+        );
+        result = write_header(numtracks, smf0 ? 0 : 1);
+    }
+    else
+        m_error_message = "The song played no events to render";
+
+    if (result)
+    {
+        if (smf0)
+            write_render_track(p, captured, SEQ64_RENDER_ALL, "Song");
+        else
+            write_render_track(p, captured, SEQ64_RENDER_META, "Tempo");
+
+        if (! smf0)
+        {
+            std::set<int>::const_iterator k;
+            for (k = keys.begin(); k != keys.end(); ++k)
+            {
+                char name[32];
+                snprintf
+                (
+                    name, sizeof name, "Buss %d Channel %d",
+                    *k / 16, *k % 16 + 1
+                );
+                write_render_track(p, captured, *k, name);
+            }
+        }
+
+        std::ofstream file
+        (
+            m_name.c_str(), std::ios::out | std::ios::binary | std::ios::trunc
+        );
+        if (file.is_open())
+        {
+            char file_buffer[SEQ64_MIDI_LINE_MAX];  /* enable bufferization */
+            file.rdbuf()->pubsetbuf(file_buffer, sizeof file_buffer);
+
+            std::list<midibyte>::const_iterator it;
+            for (it = m_char_list.begin(); it != m_char_list.end(); ++it)
+            {
+                const char c = *it;
+                file.write(&c, 1);
+            }
+            m_char_list.clear();
+        }
+        else
+        {
+            m_error_message = "Error opening MIDI file for rendering";
+            result = false;
+        }
+    }
+    return result;
+}
+
+/**
+ *  Writes one track of a render.  The track is built by itself, so that its
+ *  length is known, and is then spliced onto the data written so far.
+ *
+ * \param p
+ *      Provides the time signature, for the track that holds the tempo.
+ *
+ * \param captured
+ *      The events and tempo changes played, sorted by tick.
+ *
+ * \param key
+ *      The buss * 16 + channel of the events to write, with no meta events.
+ *      If SEQ64_RENDER_ALL, all of the events and the meta events are
+ *      written (SMF 0).  If SEQ64_RENDER_META, only the meta events are
+ *      written (the first track of SMF 1).
+ *
+ * \param trackname
+ *      The name of the track.
+ */
+
+void
+midifile::write_render_track
+(
+    const perform & p,
+    const render_buffer & captured,
+    int key,
+    const std::string & trackname
+)
+{
+    std::list<midibyte> data;
+    m_char_list.swap(data);                 /* build the track by itself    */
+    write_track_name(trackname);
+    bool meta = key == SEQ64_RENDER_ALL || key == SEQ64_RENDER_META;
+    if (meta)
+        write_time_sig(p.get_beats_per_bar(), p.get_beat_width());
+
+    midipulse last = 0;
+    for (int i = 0; i < captured.count(); ++i)
+    {
+        const render_buffer::item & ri = captured.at(i);
+        bool tempo = ri.ri_status == EVENT_MIDI_META;
+        if (tempo)
+        {
+            if (! meta)
+                continue;
+        }
+        else if (key != SEQ64_RENDER_ALL)
+        {
+            if (key != int(ri.ri_bus) * 16 + (ri.ri_channel & 0x0F))
+                continue;
+        }
+
+        midipulse tick = ri.ri_tick > last ? ri.ri_tick : last ;
+        write_varinum(midilong(tick - last));
+        last = tick;
+        if (tempo)
+        {
+            write_short(0xFF51);
+            write_byte(0x03);                   /* message length, must be 3 */
+            write_triple(midilong(tempo_us_from_bpm(ri.ri_tempo)));
+        }
+        else
+        {
+            write_byte(ri.ri_status | (ri.ri_channel & 0x0F));
+            write_byte(ri.ri_d0);
+            if (! event::is_one_byte_msg(ri.ri_status))
+                write_byte(ri.ri_d1);
+        }
+    }
+    write_byte(0x00);                           /* delta time               */
+    write_track_end();
+
+    midilong tracksize = midilong(m_char_list.size());
+    m_char_list.swap(data);
+    write_long(SEQ64_MTRK_TAG);                 /* magic number 'MTrk'      */
+    write_long(tracksize);
+    m_char_list.splice(m_char_list.end(), data);
+}
+
 /**
  *  Writes out the final proprietary/SeqSpec section, using the new format if
  *  the legacy format is not in force.
@@ -2924,6 +3105,59 @@ save_midi_file
     return result;
 }
 
+/**
+ *  Renders the song offline (see perform::render_song()) and writes what
+ *  was played to a standard MIDI file.  Used by the "-o render=filename"
+ *  option of seq64cli.  The current file-name is not changed.
+ *
+ * \param p
+ *      Provides the performance to render.  It must not be playing.
+ *
+ * \param fn
+ *      The full path specification for the file to be written.
+ *
+ * \param smfformat
+ *      The format of the file, 0 or 1.
+ *
+ * \param [out] errmsg
+ *      If the function fails, this string is filled with the error message.
+ *
+ * \return
+ *      Returns true if the render and the writing succeeded.
+ */
+
+bool
+render_midi_file
+(
+    perform & p,
+    const std::string & fn,
+    int smfformat,
+    std::string & errmsg
+)
+{
+    render_buffer captured;
+    long long start_us = tick_clock::now_us();
+    bool result = p.render_song(captured);
+    if (result)
+    {
+        long long us = tick_clock::now_us() - start_us;
+        printf
+        (
+            "[Rendered %d events in %lld.%03lld ms]\n",
+            captured.count(), us / 1000, us % 1000
+        );
+
+        midifile f(fn, p.get_ppqn());
+        result = f.write_render(p, captured, smfformat);
+        if (! result)
+            errmsg = f.error_message();
+    }
+    else
+        errmsg = "Cannot render the song; it is playing or has no triggers";
+
+    return result;
+}
+
 }           // namespace seq64
 
 /*
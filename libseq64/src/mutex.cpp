@@ -87,6 +87,20 @@ mutex::lock () const
     pthread_mutex_lock(&m_mutex_lock);
 }
 
+/**
+ *  Locks the mutex only if no other thread holds it.
+ *
+ * \return
+ *      Returns true if the mutex is now locked by the caller, who must then
+ *      unlock it.
+ */
+
+bool
+mutex::try_lock () const
+{
+    return pthread_mutex_trylock(&m_mutex_lock) == 0;
+}
+
 /**
  *  Unlock the mutex.
  */
@@ -119,6 +133,16 @@ condition_var::signal ()
     pthread_cond_signal(&m_cond);
 }
 
+/**
+ *  Signals the condition variable to all of the threads waiting on it.
+ */
+
+void
+condition_var::broadcast ()
+{
+    pthread_cond_broadcast(&m_cond);
+}
+
 /**
  *  Waits for the condition variable.
  */
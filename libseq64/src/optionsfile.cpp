@@ -753,6 +753,76 @@ optionsfile::parse (perform & p)
         rc().tempo_track_number(track);
         p.set_tempo_track_number(track);    /* MIDI file can override this  */
     }
+    if (line_after(file, "[playback-threads]"))
+    {
+        int count = SEQ64_PLAYBACK_THREADS_DEFAULT;
+        sscanf(m_line, "%d", &count);
+        rc().playback_threads(count);
+    }
+    if (line_after(file, "[output-timing]"))
+    {
+        sscanf(m_line, "%ld", &flag);
+        rc().absolute_timing(bool(flag));
+        if (next_data_line(file))
+        {
+            int us = SEQ64_FRAME_PERIOD_US_DEFAULT;
+            sscanf(m_line, "%d", &us);
+            rc().frame_period_us(us);
+        }
+        if (next_data_line(file))
+        {
+            int us = SEQ64_SPIN_TAIL_US_DEFAULT;
+            sscanf(m_line, "%d", &us);
+            rc().spin_tail_us(us);
+        }
+    }
+    if (line_after(file, "[output-lookahead]"))
+    {
+        int ms = SEQ64_LOOKAHEAD_MS_DEFAULT;
+        sscanf(m_line, "%d", &ms);
+        rc().lookahead_ms(ms);
+    }
+    if (line_after(file, "[jack-engine]"))
+    {
+        sscanf(m_line, "%ld", &flag);
+        rc().jack_engine(bool(flag));
+    }
+    if (line_after(file, "[midi-clock-dll]"))
+    {
+        sscanf(m_line, "%ld", &flag);
+        rc().midi_clock_dll(bool(flag));
+    }
+    if (line_after(file, "[midi-clock-emitter]"))
+    {
+        long buses = 0;
+        sscanf(m_line, "%ld", &flag);
+        rc().clock_emitter(bool(flag));
+        if (next_data_line(file))
+            sscanf(m_line, "%ld", &buses);
+
+        for (int i = 0; i < buses; ++i)
+        {
+            int bus = 0;
+            long us = 0;
+            if (! next_data_line(file))
+                break;
+
+            if (sscanf(m_line, "%d %ld", &bus, &us) == 2)
+                rc().clock_offset_us(bus, us);
+        }
+    }
+    if (line_after(file, "[sysex-output]"))
+    {
+        int rate = SEQ64_SYSEX_RATE_DEFAULT;
+        sscanf(m_line, "%d", &rate);
+        rc().sysex_rate(rate);
+    }
+    if (line_after(file, "[jack-ringbuffer]"))
+    {
+        int bytes = SEQ64_JACK_RING_SIZE_DEFAULT;
+        sscanf(m_line, "%d", &bytes);
+        rc().jack_ring_size(bytes);
+    }
     if (line_after(file, "[manual-alsa-ports]"))
     {
         sscanf(m_line, "%ld", &flag);
@@ -1081,6 +1151,7 @@ optionsfile::parse_midi_control_section (const std::string & fname, perform & p)
     {
         warnprint("[midi-controls] specifies a count of 0, so skipped");
     }
+    p.rebuild_midi_control_index();
     if (ok)
         ok = parse_midi_control_out(fname, p);
 
@@ -1358,6 +1429,159 @@ optionsfile::write (const perform & p)
         << rc().tempo_track_number() << "    # tempo_track_number\n"
         ;
 
+    /*
+     * New section for multi-threaded pattern playback.
+     */
+
+    file
+        << "\n[playback-threads]\n\n"
+           "# Sets the number of threads that render the patterns during\n"
+           "# playback, counting the output thread.  The default, 1, plays\n"
+           "# the patterns serially.  Higher values (up to 16) split the\n"
+           "# active patterns among worker threads pinned to separate CPUs,\n"
+           "# and then merge their events in timestamp order.  Useful only\n"
+           "# for very large sets of patterns.\n"
+           "\n"
+        << rc().playback_threads() << "    # playback_threads\n"
+        ;
+
+    /*
+     * New section for the timing of the output thread.
+     */
+
+    file
+        << "\n[output-timing]\n\n"
+           "# The first value selects how the output thread keeps time.\n"
+           "# 0 (the default) sleeps for the rest of each 4 ms pass after\n"
+           "# playing, measuring with the wall clock.  1 (Linux only) uses\n"
+           "# the monotonic clock, wakes up at absolute deadlines, and\n"
+           "# computes the tick position from the start of playback, which\n"
+           "# reduces jitter and drift.  The second value is the period of\n"
+           "# a pass in microseconds (250 to 20000) for mode 1.  The third is\n"
+           "# the number of microseconds (0 to 1000) before each deadline\n"
+           "# that the thread spins on the clock instead of sleeping.\n"
+           "\n"
+        << (rc().absolute_timing() ? "1" : "0")
+        << "       # absolute_timing\n"
+        << rc().frame_period_us() << "    # frame_period_us\n"
+        << rc().spin_tail_us() << "      # spin_tail_us\n"
+        ;
+
+    /*
+     * New section for scheduled (lookahead) output.
+     */
+
+    file
+        << "\n[output-lookahead]\n\n"
+           "# Sets how far ahead, in milliseconds (0 to 200), the patterns\n"
+           "# are played.  The events are then scheduled on the ALSA queue,\n"
+           "# which delivers them on time, instead of being sent when the\n"
+           "# output thread wakes up.  Values of 20 to 50 are reasonable.\n"
+           "# 0, the default, sends the events directly.  Ignored with JACK\n"
+           "# transport, MIDI clock input, and the PortMidi and JACK MIDI\n"
+           "# engines.  Muting a pattern takes effect up to this much later.\n"
+           "\n"
+        << rc().lookahead_ms() << "    # lookahead_ms\n"
+        ;
+
+    /*
+     * New section for the JACK-driven engine.
+     */
+
+    file
+        << "\n[jack-engine]\n\n"
+           "# 1 lets the JACK process callback play the patterns, one JACK\n"
+           "# period at a time, and write the events straight to the JACK\n"
+           "# MIDI output ports, each at its own frame.  The output timing\n"
+           "# is then locked to the JACK cycle.  With JACK transport, the\n"
+           "# position follows the transport.  Needs JACK MIDI (the rtmidi\n"
+           "# build with --jack-midi).  0, the default, uses the output\n"
+           "# thread.\n"
+           "\n"
+        << (rc().jack_engine() ? "1" : "0") << "       # jack_engine\n"
+        ;
+
+    /*
+     * New section for the MIDI clock delay-locked loop.
+     */
+
+    file
+        << "\n[midi-clock-dll]\n\n"
+           "# 1 follows an incoming MIDI clock (input clock set to \"slave\")\n"
+           "# with a delay-locked loop, which estimates the tempo and the\n"
+           "# phase of the clock from the arrival times of the clocks.\n"
+           "# Playback then moves smoothly between the clocks, at full PPQN,\n"
+           "# and the estimated tempo is shown as the BPM.  0, the default,\n"
+           "# moves playback by a whole clock (PPQN / 24 ticks) at each\n"
+           "# clock.\n"
+           "\n"
+        << (rc().midi_clock_dll() ? "1" : "0") << "       # midi_clock_dll\n"
+        ;
+
+    /*
+     * New section for the MIDI clock emitter and the clock offsets.
+     */
+
+    file
+        << "\n[midi-clock-emitter]\n\n"
+           "# 1 sends the MIDI clock from a thread of its own, which wakes up\n"
+           "# at the due time of each clock, so that the clock does not pick\n"
+           "# up the jitter of playing the patterns.  0, the default, sends\n"
+           "# the clock from the output thread.  Not used with [jack-engine].\n"
+           "\n"
+        << (rc().clock_emitter() ? "1" : "0") << "       # clock_emitter\n"
+        << "\n"
+           "# The number of output busses, then, for each buss, the buss\n"
+           "# (re 0) and its MIDI clock offset in microseconds, used by the\n"
+           "# clock emitter.  A positive offset sends the clock of the buss\n"
+           "# that much early, to make up for the input latency of the device\n"
+           "# on the buss, so that devices with different latencies line up.\n"
+           "\n"
+        << buses << "       # number of busses\n"
+        ;
+
+    for (int bus = 0; bus < buses; ++bus)
+    {
+        snprintf
+        (
+            outs, sizeof outs, "%d %ld    # buss number, clock offset (us)",
+            bus, rc().clock_offset_us(bus)
+        );
+        file << outs << "\n";
+    }
+
+    /*
+     * New section for the pacing of SysEx output.
+     */
+
+    file
+        << "\n[sysex-output]\n\n"
+           "# The rate at which SysEx messages are sent to each output buss,\n"
+           "# in bytes per second.  A thread of its own sends the messages\n"
+           "# in pieces at this rate, so that a long SysEx dump neither\n"
+           "# overruns the device nor holds up playback.  3125, the default,\n"
+           "# is the rate of a DIN MIDI cable.  USB devices can usually take\n"
+           "# a much higher rate.\n"
+           "\n"
+        << rc().sysex_rate() << "       # sysex_rate (bytes/second)\n"
+        ;
+
+    /*
+     * New section for the size of the JACK ring-buffers.
+     */
+
+    file
+        << "\n[jack-ringbuffer]\n\n"
+           "# The size, in bytes, of the ring-buffer of each JACK MIDI port.\n"
+           "# The output ring-buffer holds the messages written ahead of the\n"
+           "# JACK cycle that sends them; a message that does not fit is\n"
+           "# dropped.  Run with --stats to see, at exit, the messages each\n"
+           "# output port dropped and the most bytes its ring-buffer held.\n"
+           "# The default is 16384.\n"
+           "\n"
+        << rc().jack_ring_size() << "       # jack_ring_size (bytes)\n"
+        ;
+
     /*
      * Bus input data
      */
@@ -219,6 +219,8 @@
  *          priority range.
  */
 
+#include <errno.h>                      /* EINTR                            */
+#include <math.h>                       /* ceil(), fabs()                   */
 #include <sched.h>
 #include <stdio.h>
 #include <string.h>                     /* memset()                         */
@@ -280,6 +282,15 @@ namespace seq64
 
 midi_control perform::sm_mc_dummy;
 
+/**
+ *  True on the thread that is running perform::engine_cycle(), while it
+ *  renders.  The functions that the render shares with the other threads
+ *  check it, so that they neither lock nor wait in the JACK process
+ *  callback (see perform::play_set_locker and perform::engine_lock()).
+ */
+
+static thread_local bool s_engine_cycle = false;
+
 /**
  *  This construction initializes a vast number of member variables, some
  *  of them public (but we're working on that)!
@@ -348,6 +359,8 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_in_thread                 (),
     m_out_thread_launched       (false),
     m_in_thread_launched        (false),
+    m_clock_thread              (),
+    m_clock_thread_launched     (false),
     m_is_running                (false),
     m_is_pattern_playing        (false),
     m_inputing                  (true),
@@ -362,6 +375,7 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_beats_per_bar             (SEQ64_DEFAULT_BEATS_PER_MEASURE),
     m_beat_width                (SEQ64_DEFAULT_BEAT_WIDTH),
     m_tempo_track_number        (0),
+    m_tempo_map                 (),
     m_clocks_per_metronome      (24),
     m_32nds_per_quarter         (8),
     m_us_per_quarter_note       (tempo_us_from_bpm(SEQ64_DEFAULT_BPM)),
@@ -380,11 +394,15 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_midiclocktick             (0),
     m_midiclockincrement        (clock_ticks_from_ppqn(m_ppqn)),
     m_midiclockpos              (0),
+    m_clock_dll                 (),
+    m_input_events              (c_midibus_input_batch),
     m_dont_reset_ticks          (false),
     m_screenset_notepad         (),         // string array [c_max_sets]
     m_midi_cc_toggle            (),         // midi_control []
     m_midi_cc_on                (),         // midi_control []
     m_midi_cc_off               (),         // midi_control []
+    m_midi_control_index        (),
+    m_midi_control_mutex        (),
     m_midi_ctrl_out             (nullptr),
     m_midi_ctrl_out_disabled    (true),
     m_control_status            (0),
@@ -396,6 +414,36 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_sequence_count            (0),
     m_sequence_max              (c_max_sequence),
     m_sequence_high             (-1),
+    m_play_set                  (),
+    m_play_set_dirty            (true),
+    m_play_set_wake             (SEQ64_NULL_MIDIPULSE),
+    m_play_set_mode             (false),
+    m_park_tick                 (0),
+    m_play_set_mutex            (),
+    m_render_pool               (),
+    m_render_buffers            (1),
+    m_render_merge              (),
+    m_play_set_parked           (),
+    m_play_set_wakes            (),
+    m_render_start              (0),
+    m_render_resume             (false),
+    m_engine                    (false),
+    m_engine_rolling            (false),
+    m_engine_busy               (false),
+    m_engine_holds              (0),
+    m_engine_pad                (),
+    m_engine_buffer             (),
+    m_engine_lag                (0),
+    m_engine_tempo              (0.0),
+    m_engine_init_clock         (-1),
+    m_engine_clock              (0),
+    m_engine_stopped            (false),
+    m_clock_anchor_us           (0),
+    m_clock_anchor_tick         (0),
+    m_clock_bpm                 (SEQ64_DEFAULT_BPM),
+    m_clock_run                 (0),
+    m_clock_rolling             (false),
+    m_clock_mutex               (),
 #ifdef SEQ64_EDIT_SEQUENCE_HIGHLIGHT
     m_edit_sequence             (-1),
 #endif
@@ -422,6 +470,9 @@ perform::perform (gui_assistant & mygui, int ppqn)
     m_gui_support               (mygui)
 {
     keys().group_max(m_max_groups);
+    m_play_set.reserve(size_t(c_max_sequence));     /* never reallocate     */
+    m_play_set_parked.reserve(size_t(c_max_sequence));
+    m_play_set_wakes.reserve(size_t(c_max_sequence));
     for (int i = 0; i < m_sequence_max; ++i)
     {
         m_seqs[i] = nullptr;
@@ -440,6 +491,8 @@ perform::perform (gui_assistant & mygui, int ppqn)
     midi_control zero;                          /* all members false or 0   */
     for (int i = 0; i < c_midi_controls_extended_2; ++i)
         m_midi_cc_toggle[i] = m_midi_cc_on[i] = m_midi_cc_off[i] = zero;
+
+    m_engine_buffer.reserve(SEQ64_ENGINE_EVENTS);   /* never reallocate */
 }
 
 /**
@@ -457,6 +510,8 @@ perform::~perform ()
     m_inputing = m_outputing = m_is_running = false;
     announce_exit();                                /* turn off lights      */
     m_condition_var.signal();                       /* signal end of play   */
+    if (not_nullptr(m_master_bus))
+        m_master_bus->wake_input();                 /* end poll_for_midi()  */
 
     if (m_out_thread_launched)
         pthread_join(m_out_thread, NULL);
@@ -464,6 +519,11 @@ perform::~perform ()
     if (m_in_thread_launched)
         pthread_join(m_in_thread, NULL);
 
+    if (m_clock_thread_launched)
+        pthread_join(m_clock_thread, NULL);
+
+    m_render_pool.reset();                          /* joins its threads    */
+
     for (int seq = 0; seq < m_sequence_high; ++seq) /* m_sequence_max       */
     {
         if (not_nullptr(m_seqs[seq]))
@@ -479,6 +539,7 @@ perform::~perform ()
     }
     if (not_nullptr(m_master_bus))
     {
+        m_master_bus->stop_sysex();                 /* joins its thread     */
         delete m_master_bus;
         m_master_bus = nullptr;
     }
@@ -605,6 +666,8 @@ perform::launch (int ppqn)
             ppqn = SEQ64_DEFAULT_PPQN;
 
         m_master_bus->init(ppqn, m_bpm);    /* calls api_init() per API     */
+        if (rc().jack_engine())
+            m_engine = m_master_bus->engine(perform_engine_callback, this);
 
         /*
          * We may need to copy the actually input buss settings back to here,
@@ -615,8 +678,14 @@ perform::launch (int ppqn)
 
         if (activate())
         {
+            if (! m_engine)
+                launch_render_pool();           /* engine renders serially  */
+
             launch_input_thread();
             launch_output_thread();
+            if (rc().clock_emitter() && ! m_engine)
+                launch_clock_thread();
+
             announce_playscreen();
         }
     }
@@ -635,6 +704,11 @@ perform::launch (int ppqn)
 void
 perform::finish ()
 {
+    if (m_engine)
+    {
+        (void) m_master_bus->engine(nullptr, nullptr);
+        m_engine = false;
+    }
     (void) deinit_jack_transport();
     if (not_nullptr(m_master_bus))
         m_master_bus->get_port_statuses(m_master_clocks, m_master_inputs);
@@ -1890,6 +1964,7 @@ perform::install_sequence (sequence * seq, int seqnum)
     {
         set_active(seqnum, true);
         seq->set_parent(this);
+        wake_play_set();                /* let play() pick it up    */
         ++m_sequence_count;
         if (seqnum >= m_sequence_high)
             m_sequence_high = seqnum + 1;
@@ -2313,17 +2388,27 @@ perform::needs_update (int seq)
  *      necessary, between the values SEQ64_MINIMUM_BPM to SEQ64_MAXIMUM_BPM.
  *      They provide a wide range of speeds, well beyond what normal music
  *      needs.
+ *
+ * \param tick
+ *      The tick at which a tempo event sets the tempo, so that the change
+ *      can be scheduled along with the events around it (see
+ *      mastermidibase::set_beats_per_minute()).  Defaults to
+ *      SEQ64_NULL_MIDIPULSE, for a change made now.  In engine_cycle(),
+ *      the change is left to the output thread (see engine_follow()), since
+ *      the master bus takes a lock; the tick is then not used.
  */
 
 void
-perform::set_beats_per_minute (midibpm bpm)
+perform::set_beats_per_minute (midibpm bpm, midipulse tick)
 {
     if (bpm < SEQ64_MINIMUM_BPM)
         bpm = SEQ64_MINIMUM_BPM;
     else if (bpm > SEQ64_MAXIMUM_BPM)
         bpm = SEQ64_MAXIMUM_BPM;
 
-    if (bpm != m_bpm)
+    if (s_engine_cycle)
+        m_engine_tempo = bpm;
+    else if (bpm != m_bpm)
     {
 
 #ifdef SEQ64_JACK_SUPPORT
@@ -2339,9 +2424,10 @@ perform::set_beats_per_minute (midibpm bpm)
 
 #endif
 
-        m_master_bus->set_beats_per_minute(bpm);
+        m_master_bus->set_beats_per_minute(bpm, tick);
         m_us_per_quarter_note = tempo_us_from_bpm(bpm);
         m_bpm = bpm;
+        m_tempo_map.default_bpm(bpm);
 
         /*
          * Do we need to adjust the BPM of all of the sequences, including the
@@ -2454,11 +2540,51 @@ perform::log_current_tempo ()
             modify();
             if (tick > seq->get_length())
                 seq->set_length(tick);
+
+            rebuild_tempo_map();
         }
 	}
 	return result;
 }
 
+/**
+ *  Rebuilds the tempo map from the tempo track, with the current PPQN,
+ *  tempo, and time signature in force before the first change.
+ */
+
+void
+perform::rebuild_tempo_map ()
+{
+    m_tempo_map.defaults(m_ppqn, m_bpm, m_beats_per_bar, m_beat_width);
+
+    sequence * seq = get_sequence(get_tempo_track_number());
+    if (not_nullptr(seq))
+        seq->fill_tempo_map(m_tempo_map);
+    else
+        m_tempo_map.clear();
+}
+
+/**
+ *  In song mode, sets the tempo in force at a position in the song, so that
+ *  starting or looping back into the middle of the song does not keep the
+ *  tempo of the last tempo event played.  Does nothing if the tempo track
+ *  has no tempo changes.
+ *
+ * \param tick
+ *      The position in the song.
+ *
+ * \param when
+ *      The tick at which the change is scheduled, or SEQ64_NULL_MIDIPULSE
+ *      (the default) to change the tempo now.
+ */
+
+void
+perform::seek_tempo (midipulse tick, midipulse when)
+{
+    if (m_playback_mode && m_tempo_map.has_tempo_changes())
+        set_beats_per_minute(m_tempo_map.bpm_at(tick), when);
+}
+
 /**
  *  Encapsulates some calls used in mainwnd.  The value set here will
  *  represent the "active" screen-set in multi-window mode.
@@ -2733,6 +2859,50 @@ perform::midi_control_off (int ctl)
     return valid_midi_control_seq(ctl) ? m_midi_cc_off[ctl] : sm_mc_dummy ;
 }
 
+/**
+ *  Rebuilds the index of the MIDI controls used by midi_control_event().
+ *  Must be called after the toggle, on, or off settings of the controls
+ *  are changed, as when the [midi-control] section of the "rc" file, or of
+ *  a MIDI file, is read.  A control is listed once for each (status, d0)
+ *  pair matched by any of its active settings.
+ *
+ * \threadsafe
+ */
+
+void
+perform::rebuild_midi_control_index ()
+{
+    std::unordered_map<unsigned, std::vector<int> > index;
+    int limit = g_midi_control_limit;
+    if (limit > c_midi_controls_extended_2)
+        limit = c_midi_controls_extended_2;
+
+    for (int ctl = 0; ctl < limit; ++ctl)
+    {
+        const midi_control * settings[3] =
+        {
+            &m_midi_cc_toggle[ctl], &m_midi_cc_on[ctl], &m_midi_cc_off[ctl]
+        };
+        for (int s = 0; s < 3; ++s)
+        {
+            const midi_control & mc = *settings[s];
+            int status = mc.status();
+            int d0 = mc.data();
+            bool ok = mc.active() &&
+                status >= 0 && status <= 0xFF && d0 >= 0 && d0 <= 0xFF;
+
+            if (ok)
+            {
+                std::vector<int> & ctls = index[(unsigned(status) << 8) + d0];
+                if (ctls.empty() || ctls.back() != ctl)
+                    ctls.push_back(ctl);
+            }
+        }
+    }
+    automutex locker(m_midi_control_mutex);
+    m_midi_control_index.swap(index);
+}
+
 /**
  *  Set the MIDI control output object
  */
@@ -2887,8 +3057,27 @@ perform::set_playing_screenset ()
  *  offloading all these calls to a new sequence function.  Hence the new
  *  sequence::play_queue() function.
  *
- *  Finally, we stop the looping at m_sequence_high rather than
- *  m_sequence_max, to save a little time.
+ *  Only the sequences in the play set are visited, so that the cost of a
+ *  frame depends on the number of live patterns, not on c_max_sequence.
+ *  After playing, a sequence that has gone idle is parked and dropped from
+ *  the set.  The set is rebuilt from all the slots (up to m_sequence_high)
+ *  only when something could have woken a parked sequence:  a call to
+ *  wake_play_set(), a change of playback mode, a backward move of the
+ *  position, or reaching the next trigger of a parked sequence.
+ *
+ *  The patterns play into render buffers rather than straight to the
+ *  busses.  If there is a render pool, the play set is split among its
+ *  threads (see play_share()); otherwise this thread plays the whole set
+ *  into one buffer.  The buffers are merged in an order that does not
+ *  depend on the split or the timing, tempo changes are applied, and the
+ *  events go to the master bus in one batch, so that the bus locks are
+ *  taken once per frame rather than once per event.  Then the sequences
+ *  that were parked are dropped from the set, in order.
+ *
+ *  In engine_cycle(), the set is played serially into m_engine_buffer,
+ *  and the events are left there for engine_emit() to place in the JACK
+ *  cycle.  A sequence that another thread holds is skipped (see
+ *  engine_lock()), and plays its events late in the next period.
  *
  * \param tick
  *      Provides the tick at which to start playing.  This value is also
@@ -2898,15 +3087,232 @@ perform::set_playing_screenset ()
 void
 perform::play (midipulse tick)
 {
+    play_set_locker locker(*this);
     set_tick(tick);
+    if (tick + 1 < m_park_tick || m_playback_mode != m_play_set_mode)
+        m_play_set_dirty = true;                    /* moved back, new mode */
+    else if (! is_null_midipulse(m_play_set_wake) && tick >= m_play_set_wake)
+        m_play_set_dirty = true;                    /* a trigger is due     */
+
+    if (m_play_set_dirty)
+        rebuild_play_set(tick);
+
+    midipulse start = m_park_tick;
+    m_park_tick = tick + 1;                         /* for parked sequences */
+
+    int count = int(m_play_set.size());
+    int kept = 0;
+    m_render_start = start;
+    m_render_resume = resume_note_ons();
+    m_play_set_parked.resize(size_t(count));        /* within the capacity  */
+    m_play_set_wakes.resize(size_t(count));
+    if (s_engine_cycle)
+        play_share(0);                              /* see engine_emit()    */
+    else
+    {
+        if (m_render_pool)
+            m_render_pool->run();
+        else
+            play_share(0);
+
+        m_render_merge.merge(m_render_buffers);
+        for (int i = 0; i < m_render_merge.count(); ++i)
+        {
+            const render_buffer::item & ri = m_render_merge.at(i);
+            if (ri.ri_status == EVENT_MIDI_META)
+                set_beats_per_minute(ri.ri_tempo, ri.ri_tick);
+        }
+        if (not_nullptr(m_master_bus))
+            m_master_bus->play(m_render_merge);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (m_play_set_parked[i])
+            set_play_set_wake(m_play_set_wakes[i]);
+        else
+            m_play_set[kept++] = m_play_set[i];
+    }
+    m_play_set.resize(size_t(kept));
+    if (not_nullptr(m_master_bus) && ! s_engine_cycle)
+        m_master_bus->flush();                      /* flush MIDI buss  */
+}
+
+/**
+ *  Renders the song offline, as fast as the patterns can be played.  The
+ *  output loop of Song mode is driven from a virtual clock, one sixteenth
+ *  note per frame, from tick 0 to the end of the last trigger, and the
+ *  master bus captures what it would send, with the ticks.  So the
+ *  triggers, the looping of the patterns within them, transposition, and
+ *  the tempo events play as they would in real time.  The loop markers
+ *  are ignored, so that the render ends.  Afterward the Note Offs of the
+ *  notes still sounding are added, as when playback stops.
+ *
+ *  Must not be called while playing.  The playback mode and the tempo are
+ *  restored afterward.
+ *
+ * \param [out] captured
+ *      Gets the events and the tempo changes, sorted by tick.  The first
+ *      item is the starting tempo.
+ *
+ * \return
+ *      Returns true if the song was rendered.  False is returned if playing,
+ *      or if the song has no triggers.
+ */
+
+bool
+perform::render_song (render_buffer & captured)
+{
+    bool result = not_nullptr(m_master_bus) && ! is_running();
+    midipulse endtick = result ? get_max_trigger() : 0 ;
+    result = endtick > 0;
+    if (result)
+    {
+        bool mode = m_playback_mode;
+        midibpm bpm = m_bpm;
+        midipulse step = m_ppqn / 4 > 0 ? m_ppqn / 4 : 1 ;
+        rebuild_tempo_map();
+        set_beats_per_minute(m_tempo_map.bpm_at(0));
+        playback_mode(true);
+        off_sequences();
+        reset_sequences();
+        set_orig_ticks(0);
+        captured.reset(0);
+        captured.add_tempo(0, m_bpm);
+        m_master_bus->capture(&captured);
+        for (midipulse tick = step; ; tick += step)
+        {
+            if (tick > endtick)
+                tick = endtick;
+
+            play(tick);
+            if (tick == endtick)
+                break;
+        }
+        reset_sequences();                          /* the last Note Offs   */
+        m_master_bus->capture(nullptr);
+        captured.sort();
+        playback_mode(mode);
+        set_beats_per_minute(bpm);
+        set_tick(0);
+    }
+    return result;
+}
+
+/**
+ *  Plays one share of the play set into the render buffer of the share.
+ *  This is the job of the render pool, called by each of its threads (and
+ *  by the output thread for share 0) from play().  Without a pool, play()
+ *  calls it for share 0, the whole set.  The entries are dealt out
+ *  round-robin, which spreads the heavy patterns fairly.  A sequence that
+ *  is gone is treated as parked, so that it is dropped from the set.  In
+ *  engine_cycle(), the whole set is played into m_engine_buffer, which
+ *  engine_render() resets, and a busy sequence stays in the set unplayed.
+ *
+ * \param share
+ *      The share number, 0 to m_render_pool->count() - 1, or 0 if there is
+ *      no pool.
+ */
+
+void
+perform::play_share (int share)
+{
+    render_buffer & rb = s_engine_cycle ?
+        m_engine_buffer : m_render_buffers[share] ;
+
+    int count = int(m_play_set.size());
+    int step = m_render_pool ? m_render_pool->count() : 1 ;
+    if (! s_engine_cycle)
+        rb.reset(m_render_start);
+
+    for (int i = share; i < count; i += step)
+    {
+        sequence * s = get_sequence(m_play_set[i]);
+        midipulse waketick = SEQ64_NULL_MIDIPULSE;
+        bool parked = true;
+        if (not_nullptr(s))
+        {
+            if (! s_engine_cycle)
+            {
+                rb.order(i);
+                s->play_queue(m_tick, m_playback_mode, m_render_resume, rb);
+                parked = s->park(m_playback_mode, waketick);
+            }
+            else if (engine_lock(s))
+            {
+                rb.order(i);
+                s->play_queue(m_tick, m_playback_mode, m_render_resume);
+                parked = s->park(m_playback_mode, waketick);
+                engine_unlock(s);
+            }
+            else
+                parked = false;                     /* busy, keep it        */
+        }
+        m_play_set_parked[i] = parked ? 1 : 0 ;
+        m_play_set_wakes[i] = waketick;
+    }
+}
+
+/**
+ *  Rebuilds the play set from all of the sequence slots.  Each parked
+ *  sequence is asked whether it has to play in the coming frame; if so, it
+ *  is unparked with m_park_tick as its last tick.  Otherwise its next
+ *  trigger, if any, is noted in m_play_set_wake.  Called by play() in the
+ *  output thread.
+ *
+ *  The dirty flag is cleared first, so that a wake_play_set() call made
+ *  during the rebuild is not lost.  In engine_cycle(), a sequence that
+ *  another thread holds is left out, and the flag is set again, so that
+ *  the next period rebuilds the set.
+ *
+ * \param tick
+ *      The end tick of the coming frame.
+ */
+
+void
+perform::rebuild_play_set (midipulse tick)
+{
+    m_play_set_dirty = false;
+    m_play_set_mode = m_playback_mode;
+    m_play_set_wake = SEQ64_NULL_MIDIPULSE;
+    m_play_set.clear();
     for (int seq = 0; seq < m_sequence_high; ++seq)
     {
         sequence * s = get_sequence(seq);
         if (not_nullptr(s))
-            s->play_queue(tick, m_playback_mode, resume_note_ons());
+        {
+            midipulse waketick;
+            if (! engine_lock(s))
+                m_play_set_dirty = true;            /* busy, try again      */
+            else
+            {
+                if (s->unpark(m_park_tick, tick, m_playback_mode, waketick))
+                    m_play_set.push_back(seq);
+                else
+                    set_play_set_wake(waketick);
+
+                engine_unlock(s);
+            }
+        }
+    }
+}
+
+/**
+ *  Lowers m_play_set_wake to the given tick, if that tick is earlier.
+ *
+ * \param waketick
+ *      The next trigger start of a parked sequence, or SEQ64_NULL_MIDIPULSE
+ *      if it has none.
+ */
+
+void
+perform::set_play_set_wake (midipulse waketick)
+{
+    if (! is_null_midipulse(waketick))
+    {
+        if (is_null_midipulse(m_play_set_wake) || waketick < m_play_set_wake)
+            m_play_set_wake = waketick;
     }
-    if (not_nullptr(m_master_bus))
-        m_master_bus->flush();                      /* flush MIDI buss  */
 }
 
 /**
@@ -2914,6 +3320,12 @@ perform::play (midipulse tick)
  *  value for the pattern.  This is really the "last tick" value, so we
  *  renamed sequence::set_orig_tick() to sequence::set_last_tick().
  *
+ *  Only the sequences in the play set need the call; the parked ones follow
+ *  m_park_tick.  Moving backward could put a trigger of a parked sequence
+ *  ahead of the position, so then the play set is rebuilt.  In
+ *  engine_cycle(), a sequence that another thread holds keeps its last
+ *  tick.
+ *
  * \param tick
  *      Provides the last-tick value to be set for each sequence that is
  *      active.
@@ -2922,10 +3334,19 @@ perform::play (midipulse tick)
 void
 perform::set_orig_ticks (midipulse tick)
 {
-    for (int s = 0; s < m_sequence_high; ++s)       /* m_sequence_max   */
+    play_set_locker locker(*this);
+    if (tick < m_park_tick)
+        m_play_set_dirty = true;
+
+    m_park_tick = tick;
+    for (size_t i = 0; i < m_play_set.size(); ++i)
     {
-        if (is_active(s))
+        int s = m_play_set[i];
+        if (is_active(s) && engine_lock(m_seqs[s]))
+        {
             m_seqs[s]->set_last_tick(tick);         /* set_orig_tick()  */
+            engine_unlock(m_seqs[s]);
+        }
     }
 }
 
@@ -3258,7 +3679,17 @@ perform::pause_playing (bool songmode)
     }
     else
     {
+        /*
+         * With lookahead, the sequences have been played past the current
+         * tick, and the queued events are now dropped.  Back them up, so
+         * that resuming plays those events again.
+         */
+
+        bool ahead = m_master_bus->stop_scheduling();
         reset_sequences(true);              /* don't reset "last-tick"      */
+        if (ahead)
+            set_orig_ticks(get_tick() + 1);
+
         m_usemidiclock = false;
         m_start_from_perfedit = false;      /* act like stop_playing()      */
     }
@@ -3430,6 +3861,9 @@ perform::inner_start (bool songmode)
  *  causes the progress bar for each sequence to move to near the end of the
  *  sequence.
  *
+ *  After the sequences turn off their notes, the master bus turns off any
+ *  notes still sounding, going by the notes it has tracked on each buss.
+ *
  * \param midiclock
  *      If true, indicates that the MIDI clock should be used.  The default
  *      value is false.
@@ -3440,7 +3874,9 @@ perform::inner_stop (bool midiclock)
 {
     start_from_perfedit(false);
     is_running(false);
+    (void) m_master_bus->stop_scheduling(); /* drop events played ahead */
     reset_sequences();
+    m_master_bus->notes_off();              /* notes left sounding      */
     m_usemidiclock = midiclock;
     if (not_nullptr(m_midi_ctrl_out))
         m_midi_ctrl_out->send_event(midi_control_out::action_stop);
@@ -3450,6 +3886,9 @@ perform::inner_stop (bool midiclock)
  *  For all active patterns/sequences, set the playing state to false.
  *
  *  Replaces "for (int s = 0; s < m_sequence_max; ++s)"
+ *
+ *  JACK transport calls this function from engine_cycle() when it starts
+ *  rolling; there a sequence that another thread holds is skipped.
  */
 
 void
@@ -3457,8 +3896,11 @@ perform::off_sequences ()
 {
     for (int s = 0; s < m_sequence_high; ++s)       /* modest speed-up */
     {
-        if (is_active(s))
+        if (is_active(s) && engine_lock(m_seqs[s]))
+        {
             m_seqs[s]->set_playing(false);
+            engine_unlock(m_seqs[s]);
+        }
     }
 }
 
@@ -3502,8 +3944,9 @@ perform::unqueue_sequences (int current_seq)
 }
 
 /**
- *  For all active patterns/sequences, turn off its playing notes.
- *  Then flush the master MIDI buss.
+ *  For all active patterns/sequences, turn off its playing notes.  Then turn
+ *  off any notes still sounding on the busses, and flush the master MIDI
+ *  buss.
  */
 
 void
@@ -3515,7 +3958,10 @@ perform::all_notes_off ()
             m_seqs[s]->off_playing_notes();
     }
     if (not_nullptr(m_master_bus))
+    {
+        m_master_bus->notes_off();              /* notes left sounding  */
         m_master_bus->flush();                  /* flush the MIDI buss  */
+    }
 }
 
 /**
@@ -3550,6 +3996,14 @@ perform::panic ()
  *  Could use a member function pointer to avoid having to code two loops.
  *  We did it.
  *
+ *  Only the play set is visited.  A parked sequence is not playing, and
+ *  has no notes on, so stopping it would only zero its last tick, which
+ *  is done here by zeroing m_park_tick.
+ *
+ *  When the loop of engine_cycle() wraps, the Note Offs go to the render
+ *  buffer of the engine, and a sequence that another thread holds is
+ *  skipped.
+ *
  * \param pause
  *      Try to prevent notes from lingering on pause if true.  By default, it
  *      is false.
@@ -3558,13 +4012,26 @@ perform::panic ()
 void
 perform::reset_sequences (bool pause)
 {
+    play_set_locker locker(*this);
     void (sequence::* f) (bool) = pause ? &sequence::pause : &sequence::stop ;
-    for (int s = 0; s < m_sequence_high; ++s)           /* m_sequence_max   */
+    for (size_t i = 0; i < m_play_set.size(); ++i)      /* parked are idle  */
     {
-        if (is_active(s))
+        int s = m_play_set[i];
+        if (is_active(s) && engine_lock(m_seqs[s]))
+        {
             (m_seqs[s]->*f)(m_playback_mode);           /* (new parameter)  */
+            engine_unlock(m_seqs[s]);
+        }
+    }
+    if (! pause)
+    {
+        if (m_park_tick > 0)
+            m_play_set_dirty = true;                    /* moved backward   */
+
+        m_park_tick = 0;                                /* as zero_markers  */
     }
-    m_master_bus->flush();                              /* flush MIDI buss  */
+    if (! s_engine_cycle)
+        m_master_bus->flush();                          /* flush MIDI buss  */
 }
 
 /**
@@ -3584,6 +4051,49 @@ perform::launch_output_thread ()
         m_out_thread_launched = true;
 }
 
+/**
+ *  Creates the MIDI clock emitter thread using clock_thread_func().
+ */
+
+void
+perform::launch_clock_thread ()
+{
+    int err = pthread_create(&m_clock_thread, NULL, clock_thread_func, this);
+    if (err != 0)
+    {
+        errprint("perform: couldn't create the MIDI clock thread");
+    }
+    else
+        m_clock_thread_launched = true;
+}
+
+/**
+ *  Creates the render pool, if the "rc" [playback-threads] setting asks for
+ *  more than one thread.  If no worker thread could be created, the pool is
+ *  dropped, and playback stays serial.
+ */
+
+void
+perform::launch_render_pool ()
+{
+    int count = rc().playback_threads();
+    if (count > 1)
+    {
+        render_pool::job work = std::bind
+        (
+            &perform::play_share, this, std::placeholders::_1
+        );
+        m_render_pool.reset(new render_pool(count, work));
+        if (m_render_pool->count() > 1)
+        {
+            m_render_buffers.resize(size_t(m_render_pool->count()));
+            infoprintf("[Playback threads: %d]\n", m_render_pool->count());
+        }
+        else
+            m_render_pool.reset();
+    }
+}
+
 /**
  *  Creates the input thread using input_thread_func().  This might be a good
  *  candidate for a small thread class derived from a small base class.
@@ -3878,6 +4388,87 @@ output_thread_func (void * myperf)
     return nullptr;
 }
 
+/**
+ *  Sets the MIDI clock emitter thread to realtime privileges, a notch above
+ *  the output thread, and then starts the clock function.
+ *
+ * \param myperf
+ *      Provides the perform object instance that is to be used.  Its
+ *      clock_func() is called.
+ *
+ * \return
+ *      Always returns nullptr.
+ */
+
+void *
+clock_thread_func (void * myperf)
+{
+    perform * p = (perform *) myperf;
+
+#ifdef PLATFORM_WINDOWS
+    timeBeginPeriod(1);                         /* WinMM.dll function   */
+    p->clock_func();
+    timeEndPeriod(1);
+#else
+    if (rc().priority())
+    {
+        struct sched_param schp;
+        memset(&schp, 0, sizeof(sched_param));
+        schp.sched_priority = 2;                /* above output thread  */
+        int rc = pthread_setschedparam(p->m_clock_thread, SCHED_FIFO, &schp);
+        if (rc != 0)
+        {
+            errprint
+            (
+                "clock_thread_func: couldn't set scheduler to FIFO, "
+                "need root priviledges."
+            );
+        }
+        else
+        {
+            infoprint("[Clock priority set to 2]");
+        }
+    }
+    p->clock_func();
+#endif
+
+    return nullptr;
+}
+
+/**
+ *  The function the master bus calls from the JACK process callback, in
+ *  engine mode, to render one period.  See perform::engine_cycle().
+ *
+ * \param arg
+ *      Provides the perform object instance that is to be used.
+ *
+ * \param frames
+ *      The number of frames in the period.
+ *
+ * \param rate
+ *      The frame rate.
+ *
+ * \param events
+ *      The array to render the events of the period into.
+ *
+ * \param capacity
+ *      The number of items in the array.
+ *
+ * \return
+ *      Returns the number of events rendered.
+ */
+
+int
+perform_engine_callback
+(
+    void * arg, long frames, long rate, engine_event * events, int capacity
+)
+{
+    perform * p = reinterpret_cast<perform *>(arg);
+    return not_nullptr(p) ?
+        p->engine_cycle(frames, rate, events, capacity) : 0 ;
+}
+
 /**
  *  Initializes JACK support, if SEQ64_JACK_SUPPORT is defined.  Who calls
  *  this routine?  The main() routine of the application [via launch()],
@@ -3923,26 +4514,153 @@ perform::deinit_jack_transport ()
 #endif
 }
 
+#ifdef PLATFORM_LINUX
+
 /**
- *  Performance output function.  This function is called by the free function
- *  output_thread_func().  Here's how it works:
+ *  Gets the time of the monotonic clock, which, unlike CLOCK_REALTIME, does
+ *  not jump or slew when the wall clock is adjusted.
  *
- *      -   It runs while m_outputing is true.
- *      -   MORE TO COME.  Yeah, a lot more to come.  It is a complex
- *          function.
+ * \return
+ *      Returns the current time in nanoseconds.
+ */
+
+static long long
+monotonic_ns ()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/**
+ *  Waits until an absolute time of the monotonic clock.  The thread sleeps
+ *  until \a spin_ns before the deadline, which makes the wakeup latency of
+ *  the scheduler independent of how long the last pass took, and then spins
+ *  on the clock for the rest.
  *
- * \change ca 2016-01-26
- *      Hurray, seq24 is coming back to life!  We see that there is a fix for
- *      clock tick drift here, which relies on using long and long long
- *      values.  See the Changelog for seq24 0.9.3.
+ * \param deadline_ns
+ *      The time to wait for, in nanoseconds.
  *
- * \warning
- *      Valgrind shows that output_func() is being called before the JACK
- *      client pointer is being initialized!!!
+ * \param spin_ns
+ *      The length of the spin-wait, in nanoseconds.  Can be 0.
  */
 
-void
-perform::output_func ()
+static void
+sleep_until_ns (long long deadline_ns, long long spin_ns)
+{
+    long long wake_ns = deadline_ns - spin_ns;
+    if (wake_ns > monotonic_ns())
+    {
+        struct timespec wake;
+        wake.tv_sec = time_t(wake_ns / 1000000000LL);
+        wake.tv_nsec = long(wake_ns % 1000000000LL);
+        int err;
+        do
+        {
+            err = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+        } while (err == EINTR);
+    }
+    while (monotonic_ns() < deadline_ns)
+    {
+        // Spin for the last few microseconds
+    }
+}
+
+/**
+ *  Waits for the next frame of the output thread, when absolute timing is
+ *  on.  The thread wakes up at the next frame, or at the next MIDI clock
+ *  tick, if that comes first.  A late frame does not make the next ones
+ *  early; the ticks to catch up on are computed from the anchor anyway.
+ *
+ * \param deadline_ns
+ *      The deadline of the last frame, in nanoseconds.
+ *
+ * \param frame_ns
+ *      The frame period, in nanoseconds.
+ *
+ * \param spin_ns
+ *      The length of the spin-wait, in nanoseconds.  Can be 0.
+ *
+ * \param clock_ns
+ *      The time at which the next MIDI clock tick is due, in nanoseconds,
+ *      or 0 if no clock is to be sent.
+ *
+ * \return
+ *      Returns the deadline that was waited for, the base of the next one.
+ */
+
+static long long
+sleep_until_frame
+(
+    long long deadline_ns, long long frame_ns, long long spin_ns,
+    long long clock_ns
+)
+{
+    long long now_ns = monotonic_ns();
+    deadline_ns += frame_ns;
+    if (deadline_ns < now_ns)
+        deadline_ns = now_ns;
+
+    if (clock_ns > 0 && clock_ns < deadline_ns)
+        deadline_ns = clock_ns;
+
+    sleep_until_ns(deadline_ns, spin_ns);
+    return deadline_ns;
+}
+
+#endif  // PLATFORM_LINUX
+
+/**
+ *  Gets the number of ticks to advance playback by, when following an
+ *  incoming MIDI clock.  Normally this is a whole clock, PPQN / 24 ticks, for
+ *  each clock that came in since the last call.  With the [midi-clock-dll]
+ *  option, the clock loop gives the ticks at full PPQN, so that playback
+ *  moves smoothly between the clocks, and, once it is locked, its estimate
+ *  of the tempo becomes the BPM of the performance.  Called by the output
+ *  thread or the JACK engine.
+ *
+ * \return
+ *      Returns the number of ticks to advance playback by.
+ */
+
+midipulse
+perform::midi_clock_ticks ()
+{
+    midipulse result = m_midiclocktick;
+    m_midiclocktick = 0;
+    if (rc().midi_clock_dll())
+    {
+        result = m_clock_dll.advance(tick_clock::now_us());
+        if (m_clock_dll.locked())
+        {
+            midibpm bpm = m_clock_dll.bpm();
+            if (fabs(bpm - m_bpm) >= SEQ64_CLOCK_DLL_BPM_STEP)
+                set_beats_per_minute(bpm);
+        }
+    }
+    return result;
+}
+
+/**
+ *  Performance output function.  This function is called by the free function
+ *  output_thread_func().  Here's how it works:
+ *
+ *      -   It runs while m_outputing is true.
+ *      -   MORE TO COME.  Yeah, a lot more to come.  It is a complex
+ *          function.
+ *
+ * \change ca 2016-01-26
+ *      Hurray, seq24 is coming back to life!  We see that there is a fix for
+ *      clock tick drift here, which relies on using long and long long
+ *      values.  See the Changelog for seq24 0.9.3.
+ *
+ * \warning
+ *      Valgrind shows that output_func() is being called before the JACK
+ *      client pointer is being initialized!!!
+ */
+
+void
+perform::output_func ()
 {
     while (m_outputing)         /* PERHAPS we should LOCK this variable */
     {
@@ -4043,6 +4761,7 @@ perform::output_func ()
         bool ok = m_playback_mode;
 #endif
 
+        rebuild_tempo_map();
         ok = ok && ! m_dont_reset_ticks;
         m_dont_reset_ticks = false;
         if (ok)
@@ -4051,10 +4770,51 @@ perform::output_func ()
             pad.js_current_tick = long(m_starting_tick);    // midipulse
             pad.js_clock_tick = m_starting_tick;
             set_orig_ticks(m_starting_tick);                // what member?
+            seek_tempo(m_starting_tick);
         }
 
         int ppqn = m_master_bus->get_ppqn();
 
+#ifdef PLATFORM_LINUX
+
+        /*
+         * With absolute timing, the tick position is the time elapsed since
+         * an anchor, times the tempo.  The anchor is the start of playback,
+         * and is moved to the last tick played whenever the tempo changes.
+         * The thread wakes up at absolute deadlines, one frame period apart,
+         * or earlier if a MIDI clock tick falls due.
+         */
+
+        bool absolute = rc().absolute_timing();
+        long long frame_ns = rc().frame_period_us() * 1000LL;
+        long long spin_ns = rc().spin_tail_us() * 1000LL;
+        long long anchor_ns = monotonic_ns();
+        long long deadline_ns = anchor_ns;
+        midibpm anchor_bpm = m_master_bus->get_beats_per_minute();
+        long anchor_ticks = 0;              /* ticks played since anchor    */
+#else
+        bool absolute = false;              /* needs the monotonic clock    */
+#endif
+
+        /*
+         * With lookahead, each frame plays the events due up to the
+         * lookahead past the current tick, and the MIDI API schedules them
+         * on its queue.  The queue restarts at tick 0 here; sched_tick
+         * follows it, and the performance advances with it.  The queue tick
+         * of an event is its tick plus sched_tick minus the current tick.
+         * JACK transport and MIDI clock input move the position on their
+         * own, so they rule out lookahead.
+         */
+
+        long lookahead_us = rc().lookahead_ms() * 1000L;
+        bool scheduling = lookahead_us > 0 && ! is_jack_running() &&
+            ! m_usemidiclock && ! m_engine;
+
+        if (scheduling)
+            scheduling = m_master_bus->start_scheduling();
+
+        midipulse sched_tick = 0;
+
 #ifdef SEQ64_STATISTICS_SUPPORT
 
 #ifdef PLATFORM_WINDOWS
@@ -4077,7 +4837,16 @@ perform::output_func ()
 
 #endif  // SEQ64_STATISTICS_SUPPORT
 
-        while (is_running())
+        /*
+         * In engine mode, the JACK process callback plays each period, and
+         * this thread only follows it (see engine_run()).
+         */
+
+        bool engine = m_engine;
+        if (engine)
+            engine_run(pad);
+
+        while (! engine && is_running())
         {
             /**
              * -# Get delta time (current - last).
@@ -4129,11 +4898,41 @@ perform::output_func ()
 
             long delta_tick = long(delta_tick_num / delta_tick_denom);
             pad.js_delta_tick_frac = long(delta_tick_num % delta_tick_denom);
-            if (m_usemidiclock)
+#ifdef PLATFORM_LINUX
+            if (absolute)
             {
-                delta_tick = m_midiclocktick;               /* int to double */
-                m_midiclocktick = 0;
+                if (bpm != anchor_bpm)
+                {
+                    anchor_ns += (long long)
+                    (
+                        anchor_ticks * 60000000000.0 / (anchor_bpm * ppqn)
+                    );
+                    anchor_ticks = 0;
+                    anchor_bpm = bpm;
+                }
+
+                long long elapsed_ns = monotonic_ns() - anchor_ns;
+                long ticks = long(bpm * ppqn * elapsed_ns / 60000000000.0);
+                delta_tick = ticks > anchor_ticks ? ticks - anchor_ticks : 0 ;
+                anchor_ticks += delta_tick;
             }
+#endif
+            if (scheduling)
+            {
+                /*
+                 * The queue applies the scheduled tempo changes at their
+                 * ticks, so its tick, not our clock, gives the position.
+                 */
+
+                midipulse qtick = m_master_bus->schedule_tick();
+                if (! is_null_midipulse(qtick))
+                    delta_tick = qtick > sched_tick ? qtick - sched_tick : 0 ;
+
+                sched_tick += delta_tick;
+            }
+            if (m_usemidiclock)
+                delta_tick = midi_clock_ticks();            /* int to double */
+
             if (m_midiclockpos >= 0)
             {
                 delta_tick = 0;
@@ -4216,6 +5015,9 @@ perform::output_func ()
             if (pad.js_init_clock)
             {
                 m_master_bus->init_clock(midipulse(pad.js_clock_tick));
+                if (m_clock_thread_launched)
+                    clock_mark(midipulse(pad.js_clock_tick), bpm, true);
+
                 pad.js_init_clock = false;
             }
             if (pad.js_dumping)
@@ -4231,6 +5033,14 @@ perform::output_func ()
                     perfloop = m_playback_mode || start_from_perfedit() ||
                         song_start_mode();
                 }
+                m_master_bus->frame_tick(midipulse(pad.js_current_tick));
+                if (scheduling)
+                {
+                    m_master_bus->schedule_offset
+                    (
+                        sched_tick - midipulse(pad.js_current_tick)
+                    );
+                }
                 if (perfloop)
                 {
                     /*
@@ -4269,6 +5079,18 @@ perform::output_func ()
                         set_orig_ticks(ltick);
                         m_current_tick = double(ltick) + leftover_tick;
                         pad.js_current_tick = double(ltick) + leftover_tick;
+                        m_master_bus->frame_tick
+                        (
+                            midipulse(pad.js_current_tick)
+                        );
+                        if (scheduling)
+                        {
+                            m_master_bus->schedule_offset
+                            (
+                                sched_tick - midipulse(pad.js_current_tick)
+                            );
+                        }
+                        seek_tempo(ltick, ltick);
                     }
                     else
                         jack_position_once = false;
@@ -4286,6 +5108,41 @@ perform::output_func ()
 #endif
                         play(midipulse(pad.js_current_tick));       // play!
                 }
+                else if (scheduling)
+                {
+                    /*
+                     * Play up to the lookahead, but not past the end of the
+                     * loop, which has to wrap first.  Then set the tick back
+                     * to the current one, for the user-interface and pause.
+                     * In song mode, the tempo map gives the lookahead across
+                     * the tempo changes ahead.
+                     */
+
+                    midipulse tick = midipulse(pad.js_current_tick);
+                    midipulse target;
+                    if (m_playback_mode && m_tempo_map.has_tempo_changes())
+                    {
+                        target = m_tempo_map.us_to_tick
+                        (
+                            m_tempo_map.tick_to_us(tick) + lookahead_us
+                        );
+                    }
+                    else
+                    {
+                        target = tick + midipulse
+                        (
+                            lookahead_us * bpm * ppqn / 60000000.0
+                        );
+                    }
+                    if (perfloop && target >= get_right_tick())
+                        target = get_right_tick() - 1;
+
+                    if (target < tick)
+                        target = tick;
+
+                    play(target);                                   // play!
+                    set_tick(tick);
+                }
                 else
                     play(midipulse(pad.js_current_tick));           // play!
 
@@ -4302,9 +5159,15 @@ perform::output_func ()
                  * need to emit the MIDI clock.
                  *
                  * m_master_bus->clock(midipulse(pad.js_clock_tick));
+                 *
+                 * With the clock emitter, the clock goes out from its own
+                 * thread, which we just tell where we are.
                  */
 
-                m_master_bus->emit_clock(midipulse(pad.js_clock_tick));
+                if (m_clock_thread_launched)
+                    clock_mark(midipulse(pad.js_clock_tick), bpm);
+                else
+                    m_master_bus->emit_clock(midipulse(pad.js_clock_tick));
 
 #ifdef SEQ64_STATISTICS_SUPPORT
                 if (rc().stats())
@@ -4346,52 +5209,84 @@ perform::output_func ()
              */
 
             last = current;
-
+            if (absolute)
+            {
+#ifdef PLATFORM_LINUX
+                long long clock_ns = 0;                 /* no clock to send */
+                int ct = clock_ticks_from_ppqn(m_ppqn);
+                if (ct > 0 && ! m_clock_thread_launched)
+                {
+                    midipulse ctick = midipulse(pad.js_clock_tick);
+                    long ahead = long(ct - ctick % ct);
+                    clock_ns = anchor_ns + (long long) ceil
+                    (
+                        (anchor_ticks + ahead) * 60000000000.0 /
+                            (anchor_bpm * ppqn)
+                    );
+                }
+                deadline_ns = sleep_until_frame
+                (
+                    deadline_ns, frame_ns, spin_ns, clock_ns
+                );
+#endif
+            }
+            else
+            {
 #ifdef PLATFORM_WINDOWS
-            current = timeGetTime();
-            delta = current - last;
-            long elapsed_us = delta * 1000;
+                current = timeGetTime();
+                delta = current - last;
+                long elapsed_us = delta * 1000;
 #else
-            clock_gettime(CLOCK_REALTIME, &current);
-            delta.tv_sec  = current.tv_sec  - last.tv_sec;
-            delta.tv_nsec = current.tv_nsec - last.tv_nsec;
-            long elapsed_us = (delta.tv_sec * 1000000) + (delta.tv_nsec / 1000);
+                clock_gettime(CLOCK_REALTIME, &current);
+                delta.tv_sec  = current.tv_sec  - last.tv_sec;
+                delta.tv_nsec = current.tv_nsec - last.tv_nsec;
+                long elapsed_us =
+                    (delta.tv_sec * 1000000) + (delta.tv_nsec / 1000);
 #endif
 
-            /**
-             * Now we want to trigger every c_thread_trigger_width_us, and it
-             * took us delta_us to play().  Also known as the "sleeping_us".
-             */
+                /**
+                 * Now we want to trigger every c_thread_trigger_width_us, and
+                 * it took us delta_us to play().  Also known as the
+                 * "sleeping_us".
+                 */
 
-            delta_us = c_thread_trigger_width_us - elapsed_us;
+                delta_us = c_thread_trigger_width_us - elapsed_us;
 
-            /**
-             * Check MIDI clock adjustment.  Note that we replaced
-             * "60000000.0f / m_ppqn / bpm" with a call to a function.  We
-             * also removed the "f" specification from the constants.
-             */
+                /**
+                 * Check MIDI clock adjustment.  Note that we replaced
+                 * "60000000.0f / m_ppqn / bpm" with a call to a function.
+                 * We also removed the "f" specification from the constants.
+                 */
 
-            double dct = double_ticks_from_ppqn(m_ppqn);
-            double next_total_tick = pad.js_total_tick + dct;
-            double next_clock_delta = next_total_tick - pad.js_total_tick - 1;
-            double next_clock_delta_us =
-                next_clock_delta * pulse_length_us(bpm, m_ppqn);
+                double dct = double_ticks_from_ppqn(m_ppqn);
+                double next_total_tick = pad.js_total_tick + dct;
+                double next_clock_delta =
+                    next_total_tick - pad.js_total_tick - 1;
+                double next_clock_delta_us =
+                    next_clock_delta * pulse_length_us(bpm, m_ppqn);
 
-            if (next_clock_delta_us < (c_thread_trigger_width_us * 2.0))
-                delta_us = long(next_clock_delta_us);
+                if
+                (
+                    ! m_clock_thread_launched &&
+                    next_clock_delta_us < (c_thread_trigger_width_us * 2.0)
+                )
+                {
+                    delta_us = long(next_clock_delta_us);
+                }
 
-            if (delta_us > 0)
-                (void) microsleep(delta_us);            /* daemonize.hpp    */
+                if (delta_us > 0)
+                    (void) microsleep(delta_us);        /* daemonize.hpp    */
 
 #ifdef SEQ64_STATISTICS_SUPPORT
-            else
-            {
-                if (rc().stats())
+                else
                 {
-                    errprint("Underrun");
+                    if (rc().stats())
+                    {
+                        errprint("Underrun");
+                    }
                 }
-            }
 #endif  // SEQ64_STATISTICS_SUPPORT
+            }
 
 #ifdef SEQ64_STATISTICS_SUPPORT
             if (rc().stats())
@@ -4494,6 +5389,10 @@ perform::output_func ()
          * if m_usemidiclock == true.
          */
 
+        (void) m_master_bus->stop_scheduling();     /* if not stopped yet   */
+        if (m_clock_thread_launched)
+            clock_stop();
+
         m_master_bus->flush();
         m_master_bus->stop();
 
@@ -4512,6 +5411,571 @@ perform::output_func ()
     pthread_exit(0);
 }
 
+/**
+ *  Runs playback in engine mode, for output_func().  The JACK process
+ *  callback renders each period (see engine_cycle()), and writes the
+ *  events to the output ports in the same cycle, each at its own frame.
+ *  This thread sets up the render, then does what the callback leaves to
+ *  it (see engine_follow()) until playback stops, or JACK transport stops
+ *  it.  Then it waits out a render in progress, so that the callback is
+ *  done with the scratchpad before the next start.
+ *
+ * \param startpad
+ *      The scratchpad set up by output_func().
+ */
+
+void
+perform::engine_run (const jack_scratchpad & startpad)
+{
+    m_engine_pad = startpad;
+    m_engine_pad.js_delta_tick_frac = 0L;   /* now in frames, not in us */
+    m_engine_buffer.reset(midipulse(startpad.js_current_tick));
+    m_engine_lag = 0;
+    m_engine_tempo = 0.0;
+    m_engine_init_clock = -1;
+    m_engine_clock = long(startpad.js_clock_tick);
+    m_engine_stopped = false;
+    m_engine_rolling = true;
+    while (is_running())
+    {
+        engine_follow();
+        if (m_engine_stopped)
+            inner_stop();
+        else
+            (void) microsleep(c_thread_trigger_width_us);
+    }
+    m_engine_rolling = false;
+    while (m_engine_busy)
+        (void) microsleep(1);
+
+    engine_follow();
+}
+
+/**
+ *  Does, on the output thread, what engine_cycle() cannot do in the process
+ *  callback, because the master bus takes a lock:  it applies a change of
+ *  tempo, starts the MIDI clock, and sends the MIDI clock up to the tick
+ *  rendered.  It also notes the current tick for the conversion of input
+ *  times (see mastermidibase::frame_tick()), and grows the triggers of song
+ *  recording, which allocates.
+ */
+
+void
+perform::engine_follow ()
+{
+    midibpm bpm = m_engine_tempo.exchange(0.0);
+    if (bpm > 0.0)
+        set_beats_per_minute(bpm);
+
+    long start = m_engine_init_clock.exchange(-1);
+    if (start >= 0)
+        m_master_bus->init_clock(midipulse(start));
+
+    midipulse tick = midipulse(m_current_tick);
+    m_master_bus->emit_clock(midipulse(m_engine_clock));
+    m_master_bus->frame_tick(tick);
+    for (int s = 0; s < m_sequence_high; ++s)
+    {
+        if (is_active(s) && m_seqs[s]->song_recording())
+            m_seqs[s]->song_recording_grow(tick);
+    }
+}
+
+/**
+ *  Tells the MIDI clock emitter where the output thread is.  At the start
+ *  of playback, and when following an incoming MIDI clock, the time base of
+ *  the emitter is anchored at the given tick and the current time.
+ *  Otherwise the time base moves only when the tempo changes, and then from
+ *  the time at which the given tick was due, so that the clock does not pick
+ *  up the jitter of the output thread.
+ *
+ * \param tick
+ *      The MIDI clock tick of the output thread.
+ *
+ * \param bpm
+ *      The current tempo.
+ *
+ * \param start
+ *      True if playback is starting, or has been moved, so that the emitter
+ *      starts over from the given tick.
+ */
+
+void
+perform::clock_mark (midipulse tick, midibpm bpm, bool start)
+{
+    automutex locker(m_clock_mutex);
+    if (start)
+    {
+        ++m_clock_run;
+        m_clock_rolling = true;
+    }
+    if (start || m_usemidiclock)
+    {
+        m_clock_anchor_us = tick_clock::now_us();
+        m_clock_anchor_tick = tick;
+        m_clock_bpm = bpm;
+    }
+    else if (bpm != m_clock_bpm)
+    {
+        m_clock_anchor_us = clock_due_us(tick);
+        m_clock_anchor_tick = tick;
+        m_clock_bpm = bpm;
+    }
+}
+
+/**
+ *  Tells the MIDI clock emitter that playback has stopped.
+ */
+
+void
+perform::clock_stop ()
+{
+    automutex locker(m_clock_mutex);
+    ++m_clock_run;
+    m_clock_rolling = false;
+}
+
+/**
+ *  Gets the time at which a MIDI clock tick is due, from the time base of
+ *  the clock emitter.  The caller holds m_clock_mutex.
+ *
+ * \param tick
+ *      The MIDI clock tick.
+ *
+ * \return
+ *      Returns the monotonic time, in microseconds.
+ */
+
+long long
+perform::clock_due_us (midipulse tick) const
+{
+    double us = (tick - m_clock_anchor_tick) * 60000000.0 /
+        (m_clock_bpm * m_ppqn);
+
+    return m_clock_anchor_us + (long long) ceil(us);
+}
+
+/**
+ *  The MIDI clock emitter, run by clock_thread_func() if the "rc"
+ *  [midi-clock-emitter] setting is on.  It sleeps until the next clock of
+ *  any output buss is due, at an absolute deadline, and sends it.  The
+ *  clock of each buss is due at the time of its tick less the clock offset
+ *  of the buss, so a buss with a positive offset gets each clock early.
+ *  The tick of each clock comes from the time base that the output thread
+ *  sets with clock_mark(), so playing the patterns does not delay the clock.
+ *  Clocks that are late are sent at once, in one go per buss.  The thread
+ *  also wakes up once per frame period, to pick up changes of tempo.
+ */
+
+void
+perform::clock_func ()
+{
+    std::vector<midipulse> next;            /* next clock tick of each buss */
+    std::vector<midipulse> due;             /* tick to clock to, or -1      */
+    long run = -1;
+    while (m_outputing)
+    {
+        long long now_us = tick_clock::now_us();
+        long long wake_us = now_us + rc().frame_period_us();
+        int ct = clock_ticks_from_ppqn(m_ppqn);
+        int buses = m_master_bus->get_num_out_buses();
+        due.clear();
+        m_clock_mutex.lock();
+        if (m_clock_run != run)
+        {
+            run = m_clock_run;
+            next.clear();
+        }
+        if (m_clock_rolling && ct > 0 && buses > 0 && m_clock_bpm > 0.0)
+        {
+            if (next.empty())
+            {
+                midipulse first = ((m_clock_anchor_tick + ct - 1) / ct) * ct;
+                next.assign(size_t(buses), first);
+            }
+            due.assign(next.size(), -1);
+            for (size_t b = 0; b < next.size(); ++b)
+            {
+                long offset_us = rc().clock_offset_us(int(b));
+                long long due_us = clock_due_us(next[b]) - offset_us;
+                while (due_us <= now_us)
+                {
+                    due[b] = next[b];
+                    next[b] += ct;
+                    due_us = clock_due_us(next[b]) - offset_us;
+                }
+                if (due_us < wake_us)
+                    wake_us = due_us;
+            }
+        }
+        m_clock_mutex.unlock();
+        for (size_t b = 0; b < due.size(); ++b)
+        {
+            if (due[b] >= 0)
+                m_master_bus->emit_clock(bussbyte(b), due[b]);
+        }
+
+#ifdef PLATFORM_LINUX
+        sleep_until_ns(wake_us * 1000LL, rc().spin_tail_us() * 1000LL);
+#else
+        long sleep_us = long(wake_us - tick_clock::now_us());
+        if (sleep_us > 0)
+            (void) microsleep(sleep_us);
+#endif
+    }
+}
+
+/**
+ *  Renders one period in engine mode.  It is called from the JACK process
+ *  callback, before the output ports are written, so it must not block or
+ *  allocate.  Nothing here takes a lock except by trying:  the play set is
+ *  owned by the render (see play_set_locker), each sequence is only
+ *  try-locked (see engine_lock()), and the events go to m_engine_buffer,
+ *  then to the given array, rather than to the master bus.
+ *
+ *  If another thread holds the play set, the period is skipped, and its
+ *  frames are rendered with the next period.  The events that fell due in
+ *  the skipped frames are then late, and go out at the start of the cycle.
+ *
+ * \param frames
+ *      The number of frames in the period.
+ *
+ * \param rate
+ *      The frame rate.
+ *
+ * \param events
+ *      The array to render the events into.
+ *
+ * \param capacity
+ *      The number of items in the array.  The events that do not fit are
+ *      dropped.
+ *
+ * \return
+ *      Returns the number of events rendered.
+ */
+
+int
+perform::engine_cycle
+(
+    long frames, long rate, engine_event * events, int capacity
+)
+{
+    int result = 0;
+    m_engine_busy = true;
+    if (m_engine_rolling && frames > 0 && rate > 0)
+    {
+        if (m_engine_holds == 0)
+        {
+            s_engine_cycle = true;
+            result = engine_render(frames, rate, events, capacity);
+            s_engine_cycle = false;
+            m_engine_lag = 0;
+        }
+        else
+            m_engine_lag += frames;             /* render it next period    */
+    }
+    m_engine_busy = false;
+    return result;
+}
+
+/**
+ *  Renders the ticks of the current period, plus any skipped periods, for
+ *  engine_cycle().  The ticks are those from the current tick up to, but
+ *  not including, the tick at the end of the frames.  They come from the
+ *  JACK transport position if it is rolling, and otherwise from the frame
+ *  count and the tempo, so that playback keeps the pace of the JACK frames
+ *  rather than that of the system clock.  Each event is placed at the
+ *  frame of its tick within the period.
+ *
+ *  When the loop wraps, the patterns are played up to the right marker,
+ *  their Note Offs are placed at the frame where the right marker falls,
+ *  and the rest of the period is played from the left marker.
+ *
+ * \param frames
+ *      The number of frames in the period.
+ *
+ * \param rate
+ *      The frame rate.
+ *
+ * \param events
+ *      The array to render the events into.
+ *
+ * \param capacity
+ *      The number of items in the array.
+ *
+ * \return
+ *      Returns the number of events rendered.
+ */
+
+int
+perform::engine_render
+(
+    long frames, long rate, engine_event * events, int capacity
+)
+{
+    jack_scratchpad & pad = m_engine_pad;
+    int count = 0;
+    long total = frames + m_engine_lag;
+    int ppqn = m_master_bus->get_ppqn();
+    midibpm bpm = m_engine_tempo;               /* a change not yet applied */
+    if (bpm <= 0.0)
+        bpm = m_master_bus->get_beats_per_minute();
+
+    long long delta_tick_denom = 60LL * rate;
+    long long delta_tick_num = (long long)(bpm * ppqn * total) +
+        pad.js_delta_tick_frac;
+
+    long delta_tick = long(delta_tick_num / delta_tick_denom);
+    pad.js_delta_tick_frac = long(delta_tick_num % delta_tick_denom);
+    if (m_usemidiclock)
+        delta_tick = midi_clock_ticks();
+
+    if (m_midiclockpos >= 0)
+    {
+        delta_tick = 0;
+        m_current_tick = double(m_midiclockpos);
+        pad.js_clock_tick = pad.js_current_tick = pad.js_total_tick =
+            m_midiclockpos;
+
+        m_midiclockpos = -1;
+    }
+
+    midipulse start = midipulse(pad.js_current_tick);
+    m_engine_buffer.reset(start);
+
+#ifdef SEQ64_JACK_SUPPORT
+    bool jackrunning = m_jack_asst.output(pad);
+#else
+    bool jackrunning = false;
+#endif
+
+    if (pad.js_jack_stopped)
+        m_engine_stopped = true;                /* see engine_run()         */
+
+    if (! jackrunning)
+    {
+        pad.js_clock_tick += delta_tick;
+        pad.js_current_tick += delta_tick;
+        pad.js_total_tick += delta_tick;
+        pad.js_dumping = true;
+        m_current_tick = double(pad.js_current_tick);
+    }
+    if (pad.js_init_clock)
+    {
+        m_engine_init_clock = long(pad.js_clock_tick);
+        pad.js_init_clock = false;
+    }
+
+    bool playing = ! is_jack_running();
+
+#ifdef SEQ64_JACK_SUPPORT
+    if (! playing)
+        playing = m_jack_asst.transport_not_starting();
+#endif
+
+    if (pad.js_dumping)
+    {
+        double fpt = double(rate) * 60.0 / (bpm * ppqn);    /* frames/tick */
+        long base = -m_engine_lag;              /* frame of the start tick  */
+        bool perfloop = m_looping;
+        if (perfloop)
+        {
+            perfloop = m_playback_mode || start_from_perfedit() ||
+                song_start_mode();
+        }
+
+        static bool jack_position_once = false;
+        midipulse rtick = get_right_tick();
+        if (perfloop && pad.js_current_tick >= rtick)
+        {
+            /*
+             * Play up to the right marker, then go on from the left marker,
+             * at the frame where the right marker falls.
+             */
+
+            if (is_jack_master() && ! jack_position_once)
+            {
+                position_jack(true, m_left_tick);
+                jack_position_once = true;
+            }
+
+            double leftover_tick = pad.js_current_tick - rtick;
+            if (playing && rtick > start)
+                play(rtick - 1);                                    // play!
+
+            engine_emit(start, base, fpt, frames, events, capacity, count);
+            base += long((rtick - start) * fpt);
+
+            midipulse ltick = get_left_tick();
+            m_engine_buffer.reset(rtick);           /* Note Offs at rtick   */
+            reset_sequences();                                      // reset!
+            engine_emit(rtick, base, fpt, frames, events, capacity, count);
+            set_orig_ticks(ltick);
+            m_current_tick = double(ltick) + leftover_tick;
+            pad.js_current_tick = double(ltick) + leftover_tick;
+            m_engine_buffer.reset(ltick);
+            start = ltick;
+        }
+        else
+            jack_position_once = false;
+
+        midipulse end = midipulse(pad.js_current_tick);
+        if (playing && end > start)
+            play(end - 1);                                          // play!
+
+        engine_emit(start, base, fpt, frames, events, capacity, count);
+        set_jack_tick(pad.js_current_tick);
+        m_engine_clock = long(pad.js_clock_tick);
+    }
+    return count;
+}
+
+/**
+ *  Moves the events in m_engine_buffer to the given array, each placed at
+ *  the frame of its tick, then empties the buffer for the ticks that
+ *  follow.  An event due before the period, such as one that a busy
+ *  sequence plays late, goes out at the start of it.  A tempo change is
+ *  left to the output thread (see set_beats_per_minute()).
+ *
+ * \param start
+ *      The tick that falls at the frame given by the base parameter.
+ *
+ * \param base
+ *      The frame of the start tick, relative to the start of the period.
+ *      It is negative if the rendered ticks began in a skipped period.
+ *
+ * \param fpt
+ *      The number of frames per tick.
+ *
+ * \param frames
+ *      The number of frames in the period.
+ *
+ * \param events
+ *      The array to add the events to.
+ *
+ * \param capacity
+ *      The number of items in the array.
+ *
+ * \param [in,out] count
+ *      The number of events in the array, which is advanced.
+ */
+
+void
+perform::engine_emit
+(
+    midipulse start, long base, double fpt, long frames,
+    engine_event * events, int capacity, int & count
+)
+{
+    m_engine_buffer.sort();
+    for (int i = 0; i < m_engine_buffer.count(); ++i)
+    {
+        const render_buffer::item & ri = m_engine_buffer.at(i);
+        if (ri.ri_status == EVENT_MIDI_META)
+            set_beats_per_minute(ri.ri_tempo, ri.ri_tick);
+        else if (count < capacity)
+        {
+            long frame = base + long((ri.ri_tick - start) * fpt);
+            if (frame >= frames)
+                frame = frames - 1;
+            else if (frame < 0)
+                frame = 0;                      /* late, play at once       */
+
+            engine_event & ee = events[count++];
+            ee.ee_frame = frame;
+            ee.ee_bus = ri.ri_bus;
+            ee.ee_size = event::is_two_byte_msg(ri.ri_status) ? 3 : 2;
+            ee.ee_data[0] = ri.ri_status + (ri.ri_channel & 0x0F);
+            ee.ee_data[1] = ri.ri_d0;
+            ee.ee_data[2] = ri.ri_d1;
+        }
+    }
+    m_engine_buffer.reset(start);
+}
+
+/**
+ *  In engine_cycle(), tries to lock the given sequence for the render, so
+ *  that what it plays goes to m_engine_buffer.  Elsewhere it does nothing,
+ *  since the functions of the sequence lock for themselves.
+ *
+ * \param s
+ *      The sequence to lock.
+ *
+ * \return
+ *      Returns false if another thread holds the sequence, which must then
+ *      be skipped.
+ */
+
+bool
+perform::engine_lock (sequence * s)
+{
+    return ! s_engine_cycle || s->try_lock_play(&m_engine_buffer);
+}
+
+/**
+ *  Undoes a successful engine_lock().
+ *
+ * \param s
+ *      The sequence to unlock.
+ */
+
+void
+perform::engine_unlock (sequence * s)
+{
+    if (s_engine_cycle)
+        s->unlock_play();
+}
+
+/**
+ *  Indicates if the calling thread is rendering a period in the JACK
+ *  process callback.  Used by sequence::play() to leave song recording to
+ *  the output thread (see engine_follow()).
+ *
+ * \return
+ *      Returns true if called from within engine_cycle().
+ */
+
+bool
+perform::in_engine_cycle ()
+{
+    return s_engine_cycle;
+}
+
+/**
+ *  Locks the play set for a thread other than the JACK engine.  The count
+ *  of holders is raised before m_engine_busy is checked, and the engine
+ *  raises m_engine_busy before it checks the count, so that one of them
+ *  always sees the other:  either the engine skips its period, or this
+ *  function waits for the render to end.  The engine never waits.  See
+ *  play_set_locker.
+ */
+
+void
+perform::hold_play_set ()
+{
+    if (! s_engine_cycle)
+    {
+        m_play_set_mutex.lock();
+        ++m_engine_holds;
+        while (m_engine_busy)
+            (void) microsleep(1);
+    }
+}
+
+/**
+ *  Undoes hold_play_set().
+ */
+
+void
+perform::release_play_set ()
+{
+    if (! s_engine_cycle)
+    {
+        --m_engine_holds;
+        m_play_set_mutex.unlock();
+    }
+}
+
 /**
  *  Set up the performance, and set the process to realtime privileges.
  *
@@ -5301,7 +6765,31 @@ perform::midi_control_event (const event & ev, bool recording)
     }
     else
     {
-        for (int ctl = 0; ctl < g_midi_control_limit; ++ctl, ++offset)
+        /*
+         * Only the controls indexed under the status and first data byte of
+         * the event can match it.  They are copied out, in order, so that
+         * the index is not locked while they are handled.
+         */
+
+        int ctls[c_midi_controls_extended_2];
+        int count = 0;
+        midibyte d0 = 0, d1 = 0;
+        ev.get_data(d0, d1);
+        m_midi_control_mutex.lock();
+        std::unordered_map<unsigned, std::vector<int> >::const_iterator ci =
+            m_midi_control_index.find((unsigned(ev.get_status()) << 8) + d0);
+
+        if (ci != m_midi_control_index.end())
+        {
+            const std::vector<int> & v = ci->second;
+            for (size_t i = 0; i < v.size(); ++i)
+            {
+                if (v[i] < g_midi_control_limit)
+                    ctls[count++] = v[i];
+            }
+        }
+        m_midi_control_mutex.unlock();
+        for (int i = 0; i < count; ++i)
         {
             /*
              * \change ca 2018-10-28 GitHub issue #170.
@@ -5314,7 +6802,8 @@ perform::midi_control_event (const event & ev, bool recording)
              *      break;      // differs from legacy behavior, which keeps going
              */
 
-            bool ok = handle_midi_control_event(ev, ctl, offset);
+            int ctl = ctls[i];
+            bool ok = handle_midi_control_event(ev, ctl, offset + ctl);
             if (! result)
                 result = ok;
         }
@@ -5736,128 +7225,174 @@ perform::poll_cycle ()
     bool result = true;
     if (m_master_bus->poll_for_midi() > 0)
     {
-        do
+        int count = m_master_bus->get_midi_events
+        (
+            &m_input_events[0], int(m_input_events.size())
+        );
+        for (int i = 0; i < count; ++i)
         {
-            event ev;
-            if (m_master_bus->get_midi_event(&ev))
+            event & ev = m_input_events[i];
+            if (ev.get_status() < EVENT_MIDI_SYSEX)
             {
-                if (ev.get_status() < EVENT_MIDI_SYSEX)
+                if (m_master_bus->is_dumping())         /* "playing"    */
                 {
-                    if (m_master_bus->is_dumping())         /* "playing"    */
+                    if (midi_control_event(ev, true))   /* quick check  */
                     {
-                        if (midi_control_event(ev, true))   /* quick check  */
-                        {
 #ifdef PLATFORM_DEBUG_TMI
-                            std::string estr = to_string(ev);
-                            printf("MIDI control event %s\n", estr.c_str());
+                        std::string estr = to_string(ev);
+                        printf("MIDI control event %s\n", estr.c_str());
 #endif
-                        }
-                        else
-                        {
-                            ev.set_timestamp(get_tick());
-#ifdef PLATFORM_DEBUG_TMI
-                            ev.print_note();
-#endif
-                            if (rc().show_midi())
-                                ev.print();
-
-                            if (m_filter_by_channel)
-                                m_master_bus->dump_midi_input(ev);
-                            else
-                                m_master_bus->get_sequence()->stream_event(ev);
-                        }
                     }
                     else
                     {
+                        /*
+                         * Record the event at the tick at which it
+                         * came in, as told by the master bus from the
+                         * stamp the MIDI API put on it, rather than at
+                         * the tick at which this thread got to it.
+                         */
+
+                        midipulse now = get_tick();
+                        midipulse tick = m_master_bus->input_tick
+                        (
+                            ev.get_timestamp()
+                        );
+                        if (is_null_midipulse(tick) || tick > now)
+                            tick = now;
+                        else if (tick < 0)
+                            tick = 0;
+
+                        ev.set_timestamp(tick);
+#ifdef PLATFORM_DEBUG_TMI
+                        ev.print_note();
+#endif
                         if (rc().show_midi())
                             ev.print();
 
-                        (void) midi_control_event(ev);
+                        if (m_filter_by_channel)
+                            m_master_bus->dump_midi_input(ev);
+                        else
+                            m_master_bus->get_sequence()->stream_event(ev);
                     }
                 }
-                else if (ev.get_status() == EVENT_MIDI_START)   /* restart  */
+                else
                 {
-                    song_start_mode(false);                     /* Kepler34 */
-                    m_midiclockrunning = m_usemidiclock = true;
-                    m_midiclocktick = m_midiclockpos = 0;
-                    stop_playing();
-                    start_playing(false);                       /* Live     */
-                    if (rc().verbose_option())
-                    {
-                        infoprint("MIDI Start");
-                    }
+                    if (rc().show_midi())
+                        ev.print();
+
+                    (void) midi_control_event(ev);
                 }
-                else if (ev.get_status() == EVENT_MIDI_CONTINUE)
+            }
+            else if (ev.get_status() == EVENT_MIDI_START)   /* restart  */
+            {
+                song_start_mode(false);                     /* Kepler34 */
+                m_midiclockrunning = m_usemidiclock = true;
+                m_midiclocktick = m_midiclockpos = 0;
+                m_clock_dll.start(m_midiclockincrement, m_bpm);
+                stop_playing();
+                start_playing(false);                       /* Live     */
+                if (rc().verbose_option())
                 {
-                    song_start_mode(false);                     /* Kepler34 */
-                    m_midiclockpos = get_tick();
-                    m_dont_reset_ticks = true;
-                    m_midiclockrunning = m_usemidiclock = true;
+                    infoprint("MIDI Start");
+                }
+            }
+            else if (ev.get_status() == EVENT_MIDI_CONTINUE)
+            {
+                song_start_mode(false);                     /* Kepler34 */
+                m_midiclockpos = get_tick();
+                m_dont_reset_ticks = true;
+                m_midiclockrunning = m_usemidiclock = true;
+                m_clock_dll.start(m_midiclockincrement, m_bpm);
 
-                    /*
-                     * Not sure why, but doing this twice works.
-                     */
+                /*
+                 * Not sure why, but doing this twice works.
+                 */
 
-                    pause_playing(false); start_playing(false);
-                    pause_playing(false); start_playing(false);
-                    if (rc().verbose_option())
-                    {
-                        infoprint("MIDI Continue");
-                    }
-                }
-                else if (ev.get_status() == EVENT_MIDI_STOP)    /* pause    */
+                pause_playing(false); start_playing(false);
+                pause_playing(false); start_playing(false);
+                if (rc().verbose_option())
                 {
-                    all_notes_off();
-                    m_usemidiclock = true;
-                    m_midiclockrunning = false;
-                    m_midiclockpos = get_tick();
-                    stop_playing();                             /* flush?   */
-                    if (rc().verbose_option())
-                    {
-                        infoprint("MIDI Stop");
-                    }
+                    infoprint("MIDI Continue");
                 }
-                else if (ev.get_status() == EVENT_MIDI_CLOCK)
+            }
+            else if (ev.get_status() == EVENT_MIDI_STOP)    /* pause    */
+            {
+                all_notes_off();
+                m_usemidiclock = true;
+                m_midiclockrunning = false;
+                m_midiclockpos = get_tick();
+                m_clock_dll.stop();
+                stop_playing();                             /* flush?   */
+                if (rc().verbose_option())
                 {
-                    /*
-                     * Issue #179.  Higher PPQN need a longer increment than
-                     * SEQ64_MIDI_CLOCK_INCREMENT (8) to get 24 clocks per
-                     * quarter note.
-                     */
-
-                    if (m_midiclockrunning)
-                        m_midiclocktick += m_midiclockincrement;
+                    infoprint("MIDI Stop");
                 }
-                else if (ev.get_status() == EVENT_MIDI_SONG_POS)
+            }
+            else if (ev.get_status() == EVENT_MIDI_CLOCK)
+            {
+                /*
+                 * Issue #179.  Higher PPQN need a longer increment than
+                 * SEQ64_MIDI_CLOCK_INCREMENT (8) to get 24 clocks per
+                 * quarter note.
+                 */
+
+                if (m_midiclockrunning)
                 {
-                    midibyte d0, d1;                /* see note in banner   */
-                    ev.get_data(d0, d1);
-                    m_midiclockpos = combine_bytes(d0, d1);
+                    m_midiclocktick += m_midiclockincrement;
+                    if (rc().midi_clock_dll())
+                    {
+                        long long us = m_master_bus->input_time
+                        (
+                            ev.get_timestamp()
+                        );
+                        bool locked = m_clock_dll.locked();
+                        m_clock_dll.clock(us);
+                        if (rc().stats() && m_clock_dll.locked() != locked)
+                        {
+                            printf
+                            (
+                                "MIDI clock %s: bpm[%.2f] drift[%.0f]us "
+                                "max[%.0f]us locks[%d] unlocks[%d]\n",
+                                locked ? "unlocked" : "locked",
+                                m_clock_dll.bpm(),
+                                m_clock_dll.drift_us(),
+                                m_clock_dll.max_drift_us(),
+                                m_clock_dll.locks(),
+                                m_clock_dll.unlocks()
+                            );
+                        }
+                    }
                 }
-                else if (ev.get_status() == EVENT_MIDI_SYSEX)
-                {
-                    if (rc().show_midi())
-                        ev.print();
+            }
+            else if (ev.get_status() == EVENT_MIDI_SONG_POS)
+            {
+                midibyte d0, d1;                /* see note in banner   */
+                ev.get_data(d0, d1);
+                m_midiclockpos = combine_bytes(d0, d1);
+            }
+            else if (ev.get_status() == EVENT_MIDI_SYSEX)
+            {
+                if (rc().show_midi())
+                    ev.print();
 
-                    if (rc().pass_sysex())
-                        m_master_bus->sysex(&ev);
-                }
+                if (rc().pass_sysex())
+                    m_master_bus->sysex(&ev);
+            }
 #ifdef USE_ACTIVE_SENSE_AND_RESET
-                else if (ev.is_sense_reset())
-                {
-                    /*
-                     * Currently filtered in midi_jack, but what about ALSA?
-                     */
+            else if (ev.is_sense_reset())
+            {
+                /*
+                 * Currently filtered in midi_jack, but what about ALSA?
+                 */
 
-                    return false;
-                }
+                return false;
+            }
 #endif
-                else
-                {
-                    /* ignore the event */
-                }
+            else
+            {
+                /* ignore the event */
             }
-        } while (m_master_bus->is_more_input());
+        }
     }
     return result;
 }
@@ -127,6 +127,17 @@ rc_settings::rc_settings ()
     m_application_name          (seq_app_name()),
     m_app_client_name           (seq_client_name()),
     m_tempo_track_number        (0),
+    m_playback_threads          (SEQ64_PLAYBACK_THREADS_DEFAULT),
+    m_absolute_timing           (false),
+    m_frame_period_us           (SEQ64_FRAME_PERIOD_US_DEFAULT),
+    m_spin_tail_us              (SEQ64_SPIN_TAIL_US_DEFAULT),
+    m_lookahead_ms              (SEQ64_LOOKAHEAD_MS_DEFAULT),
+    m_jack_engine               (false),
+    m_midi_clock_dll            (false),
+    m_clock_emitter             (false),
+    m_clock_offsets             (),
+    m_sysex_rate                (SEQ64_SYSEX_RATE_DEFAULT),
+    m_jack_ring_size            (SEQ64_JACK_RING_SIZE_DEFAULT),
     m_recent_files              ()
 {
     // Empty body
@@ -179,6 +190,17 @@ rc_settings::rc_settings (const rc_settings & rhs)
     m_application_name          (rhs.m_application_name),
     m_app_client_name           (rhs.m_app_client_name),
     m_tempo_track_number        (rhs.m_tempo_track_number),
+    m_playback_threads          (rhs.m_playback_threads),
+    m_absolute_timing           (rhs.m_absolute_timing),
+    m_frame_period_us           (rhs.m_frame_period_us),
+    m_spin_tail_us              (rhs.m_spin_tail_us),
+    m_lookahead_ms              (rhs.m_lookahead_ms),
+    m_jack_engine               (rhs.m_jack_engine),
+    m_midi_clock_dll            (rhs.m_midi_clock_dll),
+    m_clock_emitter             (rhs.m_clock_emitter),
+    m_clock_offsets             (rhs.m_clock_offsets),
+    m_sysex_rate                (rhs.m_sysex_rate),
+    m_jack_ring_size            (rhs.m_jack_ring_size),
     m_recent_files              (rhs.m_recent_files)
 {
     // Empty body
@@ -241,6 +263,17 @@ rc_settings::operator = (const rc_settings & rhs)
 
         m_app_client_name           = rhs.m_app_client_name;
         m_tempo_track_number        = rhs.m_tempo_track_number;
+        m_playback_threads          = rhs.m_playback_threads;
+        m_absolute_timing           = rhs.m_absolute_timing;
+        m_frame_period_us           = rhs.m_frame_period_us;
+        m_spin_tail_us              = rhs.m_spin_tail_us;
+        m_lookahead_ms              = rhs.m_lookahead_ms;
+        m_jack_engine               = rhs.m_jack_engine;
+        m_midi_clock_dll            = rhs.m_midi_clock_dll;
+        m_clock_emitter             = rhs.m_clock_emitter;
+        m_clock_offsets             = rhs.m_clock_offsets;
+        m_sysex_rate                = rhs.m_sysex_rate;
+        m_jack_ring_size            = rhs.m_jack_ring_size;
         m_recent_files              = rhs.m_recent_files;
     }
     return *this;
@@ -303,6 +336,17 @@ rc_settings::set_defaults ()
     m_application_name          = seq_app_name();       // make it up-to-date
     m_app_client_name           = seq_client_name();    // ditto
     m_tempo_track_number        = 0;
+    m_playback_threads          = SEQ64_PLAYBACK_THREADS_DEFAULT;
+    m_absolute_timing           = false;
+    m_frame_period_us           = SEQ64_FRAME_PERIOD_US_DEFAULT;
+    m_spin_tail_us              = SEQ64_SPIN_TAIL_US_DEFAULT;
+    m_lookahead_ms              = SEQ64_LOOKAHEAD_MS_DEFAULT;
+    m_jack_engine               = false;
+    m_midi_clock_dll            = false;
+    m_clock_emitter             = false;
+    m_clock_offsets.clear();
+    m_sysex_rate                = SEQ64_SYSEX_RATE_DEFAULT;
+    m_jack_ring_size            = SEQ64_JACK_RING_SIZE_DEFAULT;
     m_recent_files.clear();
     set_config_files(SEQ64_CONFIG_NAME);
 }
@@ -559,6 +603,154 @@ rc_settings::tempo_track_number (int track)
     m_tempo_track_number = track;
 }
 
+/**
+ *  \setter m_playback_threads
+ *
+ * \param count
+ *      The number of rendering threads, including the output thread.  It is
+ *      clamped to the range SEQ64_PLAYBACK_THREADS_MIN to
+ *      SEQ64_PLAYBACK_THREADS_MAX.
+ */
+
+void
+rc_settings::playback_threads (int count)
+{
+    if (count < SEQ64_PLAYBACK_THREADS_MIN)
+        count = SEQ64_PLAYBACK_THREADS_MIN;
+    else if (count > SEQ64_PLAYBACK_THREADS_MAX)
+        count = SEQ64_PLAYBACK_THREADS_MAX;
+
+    m_playback_threads = count;
+}
+
+/**
+ *  \setter m_frame_period_us
+ *
+ * \param us
+ *      The period of the output thread, in microseconds, when it runs on
+ *      absolute deadlines.  It is clamped to the range
+ *      SEQ64_FRAME_PERIOD_US_MIN to SEQ64_FRAME_PERIOD_US_MAX.
+ */
+
+void
+rc_settings::frame_period_us (int us)
+{
+    if (us < SEQ64_FRAME_PERIOD_US_MIN)
+        us = SEQ64_FRAME_PERIOD_US_MIN;
+    else if (us > SEQ64_FRAME_PERIOD_US_MAX)
+        us = SEQ64_FRAME_PERIOD_US_MAX;
+
+    m_frame_period_us = us;
+}
+
+/**
+ *  \setter m_spin_tail_us
+ *
+ * \param us
+ *      The part of each wait, in microseconds, that is spent spinning on the
+ *      clock instead of sleeping.  It is clamped to the range
+ *      SEQ64_SPIN_TAIL_US_MIN to SEQ64_SPIN_TAIL_US_MAX.
+ */
+
+void
+rc_settings::spin_tail_us (int us)
+{
+    if (us < SEQ64_SPIN_TAIL_US_MIN)
+        us = SEQ64_SPIN_TAIL_US_MIN;
+    else if (us > SEQ64_SPIN_TAIL_US_MAX)
+        us = SEQ64_SPIN_TAIL_US_MAX;
+
+    m_spin_tail_us = us;
+}
+
+/**
+ *  \setter m_lookahead_ms
+ *
+ * \param ms
+ *      How far ahead of the current position the patterns are played, in
+ *      milliseconds.  It is clamped to the range SEQ64_LOOKAHEAD_MS_MIN to
+ *      SEQ64_LOOKAHEAD_MS_MAX.
+ */
+
+void
+rc_settings::lookahead_ms (int ms)
+{
+    if (ms < SEQ64_LOOKAHEAD_MS_MIN)
+        ms = SEQ64_LOOKAHEAD_MS_MIN;
+    else if (ms > SEQ64_LOOKAHEAD_MS_MAX)
+        ms = SEQ64_LOOKAHEAD_MS_MAX;
+
+    m_lookahead_ms = ms;
+}
+
+/**
+ *  \setter m_clock_offsets
+ *
+ * \param bus
+ *      The output buss, which must be less than SEQ64_DEFAULT_BUSS_MAX.
+ *
+ * \param us
+ *      The MIDI clock offset of the buss, in microseconds.  It is clamped
+ *      to the range SEQ64_CLOCK_OFFSET_US_MIN to SEQ64_CLOCK_OFFSET_US_MAX.
+ */
+
+void
+rc_settings::clock_offset_us (int bus, long us)
+{
+    if (bus >= 0 && bus < SEQ64_DEFAULT_BUSS_MAX)
+    {
+        if (us < SEQ64_CLOCK_OFFSET_US_MIN)
+            us = SEQ64_CLOCK_OFFSET_US_MIN;
+        else if (us > SEQ64_CLOCK_OFFSET_US_MAX)
+            us = SEQ64_CLOCK_OFFSET_US_MAX;
+
+        if (bus >= int(m_clock_offsets.size()))
+            m_clock_offsets.resize(size_t(bus + 1), 0);
+
+        m_clock_offsets[bus] = us;
+    }
+}
+
+/**
+ *  \setter m_sysex_rate
+ *
+ * \param rate
+ *      The rate at which SysEx is sent to an output buss, in bytes per
+ *      second.  It is clamped to the range SEQ64_SYSEX_RATE_MIN to
+ *      SEQ64_SYSEX_RATE_MAX.
+ */
+
+void
+rc_settings::sysex_rate (int rate)
+{
+    if (rate < SEQ64_SYSEX_RATE_MIN)
+        rate = SEQ64_SYSEX_RATE_MIN;
+    else if (rate > SEQ64_SYSEX_RATE_MAX)
+        rate = SEQ64_SYSEX_RATE_MAX;
+
+    m_sysex_rate = rate;
+}
+
+/**
+ *  \setter m_jack_ring_size
+ *
+ * \param bytes
+ *      The size of the ring-buffer of each JACK port.  It is clamped to the
+ *      range SEQ64_JACK_RING_SIZE_MIN to SEQ64_JACK_RING_SIZE_MAX.  JACK
+ *      rounds it up to a power of 2.
+ */
+
+void
+rc_settings::jack_ring_size (int bytes)
+{
+    if (bytes < SEQ64_JACK_RING_SIZE_MIN)
+        bytes = SEQ64_JACK_RING_SIZE_MIN;
+    else if (bytes > SEQ64_JACK_RING_SIZE_MAX)
+        bytes = SEQ64_JACK_RING_SIZE_MAX;
+
+    m_jack_ring_size = bytes;
+}
+
 /**
  * \getter m_recent_files
  *
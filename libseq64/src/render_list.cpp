@@ -0,0 +1,150 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          render_list.cpp
+ *
+ *  This module defines the flat, playback-only copy of the events of a
+ *  sequence.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ */
+
+#include <algorithm>                    /* std::lower_bound()               */
+
+#include "event_list.hpp"               /* seq64::event_list, event         */
+#include "render_list.hpp"              /* seq64::render_list               */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ * \defaultctor
+ */
+
+render_list::render_list ()
+ :
+    m_timestamps    (),
+    m_messages      (),
+    m_tempos        (),
+    m_note_ons      (),
+    m_note_offs     ()
+{
+    // Empty body
+}
+
+/**
+ *  Empties all of the arrays.  The storage is kept, so that rebuilding a
+ *  list of about the same size does not allocate.
+ */
+
+void
+render_list::clear ()
+{
+    m_timestamps.clear();
+    m_messages.clear();
+    m_tempos.clear();
+    m_note_ons.clear();
+    m_note_offs.clear();
+}
+
+/**
+ *  Rebuilds the arrays from the given event list, which must be sorted, as
+ *  it always is in a sequence.  Tempo events are kept (play() applies them
+ *  to the performance); other SysEx and Meta events are skipped.
+ *
+ * \param evl
+ *      The event list of the sequence.
+ */
+
+void
+render_list::build (const event_list & evl)
+{
+    clear();
+    m_timestamps.reserve(size_t(evl.count()));
+    m_messages.reserve(size_t(evl.count()));
+    for (event_list::const_iterator i = evl.begin(); i != evl.end(); ++i)
+    {
+        const event & er = DREF(i);
+        midilong message;
+        if (er.is_tempo())
+        {
+            message = midilong(EVENT_MIDI_META) |
+                (midilong(m_tempos.size()) << 8);
+
+            m_tempos.push_back(er.tempo());
+        }
+        else if (er.is_ex_data())
+            continue;
+        else
+        {
+            midibyte d0, d1;
+            er.get_data(d0, d1);
+            message = midilong(er.get_status()) |
+                (midilong(d0) << 8) | (midilong(d1) << 16);
+
+            if (er.is_note_on() && not_nullptr(er.get_linked()))
+            {
+                m_note_ons.push_back(count());
+                m_note_offs.push_back(er.get_linked()->get_timestamp());
+            }
+        }
+        m_timestamps.push_back(er.get_timestamp());
+        m_messages.push_back(message);
+    }
+}
+
+/**
+ *  Finds the first entry whose timestamp is at or after the given tick.
+ *  Since the timestamps are in one sorted array, this is a binary search.
+ *
+ * \param tick
+ *      The pulse value to look for.
+ *
+ * \return
+ *      Returns the index of the first entry not earlier than \a tick, or
+ *      count() if there is none.
+ */
+
+int
+render_list::lower_bound (midipulse tick) const
+{
+    std::vector<midipulse>::const_iterator t = std::lower_bound
+    (
+        m_timestamps.begin(), m_timestamps.end(), tick
+    );
+    return int(t - m_timestamps.begin());
+}
+
+}           // namespace seq64
+
+/*
+ * render_list.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
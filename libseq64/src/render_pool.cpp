@@ -0,0 +1,421 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          render_pool.cpp
+ *
+ *  This module defines the classes for rendering the patterns of a frame on
+ *  more than one thread.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ */
+
+#include <algorithm>                    /* std::sort()                      */
+#include <string.h>                     /* memset()                         */
+#include <unistd.h>                     /* sysconf()                        */
+
+#include "platform_macros.h"            /* PLATFORM_LINUX, etc.             */
+#include "event.hpp"                    /* seq64::event                     */
+#include "render_pool.hpp"              /* seq64::render_pool, etc.         */
+#include "settings.hpp"                 /* seq64::rc()                      */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ *  Orders rendered items by tick, then by the rank of their pattern, then by
+ *  the order of emission.  No two items compare equal, so std::sort() gives
+ *  the same result no matter how the items were split among the buffers.
+ */
+
+static bool
+item_less (const render_buffer::item & lhs, const render_buffer::item & rhs)
+{
+    if (lhs.ri_tick != rhs.ri_tick)
+        return lhs.ri_tick < rhs.ri_tick;
+    else if (lhs.ri_order != rhs.ri_order)
+        return lhs.ri_order < rhs.ri_order;
+    else
+        return lhs.ri_serial < rhs.ri_serial;
+}
+
+/**
+ * \defaultctor
+ */
+
+render_buffer::render_buffer ()
+ :
+    m_items     (),
+    m_tick      (0),
+    m_last_tick (0),
+    m_order     (0),
+    m_limit     (0)
+{
+    // Empty body
+}
+
+/**
+ *  Sets aside the storage for the given number of items, and limits the
+ *  buffer to that many, so that add() never allocates.  Used for the
+ *  buffer that the JACK process callback renders into (see
+ *  perform::engine_cycle()), where an item over the limit is dropped.
+ *
+ * \param limit
+ *      The most items the buffer can hold.  0 removes the limit.
+ */
+
+void
+render_buffer::reserve (int limit)
+{
+    m_limit = limit;
+    if (limit > 0)
+        m_items.reserve(size_t(limit));
+}
+
+/**
+ *  Empties the buffer for a new frame.  The storage is kept.
+ *
+ * \param tick
+ *      The start of the frame, used for events that have no tick of their
+ *      own.
+ */
+
+void
+render_buffer::reset (midipulse tick)
+{
+    m_items.clear();
+    m_tick = m_last_tick = tick;
+    m_order = 0;
+}
+
+/**
+ *  Adds a channel event.  Only the status and data bytes are kept;
+ *  sequence::play() never sends SysEx.
+ *
+ * \param tick
+ *      The absolute tick of the event, or SEQ64_NULL_MIDIPULSE to use the
+ *      latest tick of the pattern in this frame.
+ *
+ * \param bus
+ *      The output buss of the pattern.
+ *
+ * \param channel
+ *      The channel of the pattern.
+ *
+ * \param ev
+ *      The event to add.
+ */
+
+void
+render_buffer::add
+(
+    midipulse tick, bussbyte bus, midibyte channel, const event & ev
+)
+{
+    item ri;
+    midibyte d0, d1;
+    if (full())
+        return;
+
+    ev.get_data(d0, d1);
+    if (! is_null_midipulse(tick) && tick > m_last_tick)
+        m_last_tick = tick;
+
+    ri.ri_tick = is_null_midipulse(tick) ? m_last_tick : tick ;
+    ri.ri_order = m_order;
+    ri.ri_serial = count();
+    ri.ri_bus = bus;
+    ri.ri_channel = channel;
+    ri.ri_status = ev.get_status();
+    ri.ri_d0 = d0;
+    ri.ri_d1 = d1;
+    ri.ri_tempo = 0.0;
+    m_items.push_back(ri);
+}
+
+/**
+ *  Adds an item taken from another buffer, keeping its tick but giving it
+ *  the rank and order of emission of this buffer.
+ *
+ * \param ri
+ *      The item to add.
+ */
+
+void
+render_buffer::add (const item & ri)
+{
+    if (full())
+        return;
+
+    if (ri.ri_tick > m_last_tick)
+        m_last_tick = ri.ri_tick;
+
+    m_items.push_back(ri);
+    m_items.back().ri_order = m_order;
+    m_items.back().ri_serial = count() - 1;
+}
+
+/**
+ *  Adds a tempo change, which perform applies when it sends the merged
+ *  buffer.
+ *
+ * \param tick
+ *      The absolute tick of the tempo event.
+ *
+ * \param bpm
+ *      The new tempo.
+ */
+
+void
+render_buffer::add_tempo (midipulse tick, midibpm bpm)
+{
+    item ri;
+    if (full())
+        return;
+
+    if (! is_null_midipulse(tick) && tick > m_last_tick)
+        m_last_tick = tick;
+
+    ri.ri_tick = is_null_midipulse(tick) ? m_last_tick : tick ;
+    ri.ri_order = m_order;
+    ri.ri_serial = count();
+    ri.ri_bus = 0;
+    ri.ri_channel = 0;
+    ri.ri_status = EVENT_MIDI_META;
+    ri.ri_d0 = ri.ri_d1 = 0;
+    ri.ri_tempo = bpm;
+    m_items.push_back(ri);
+}
+
+/**
+ *  Replaces the contents of this buffer with the items of the given
+ *  buffers, sorted into the deterministic order of item_less().
+ *
+ * \param buffers
+ *      The per-thread buffers of the frame.
+ */
+
+void
+render_buffer::merge (const std::vector<render_buffer> & buffers)
+{
+    m_items.clear();
+    for (size_t b = 0; b < buffers.size(); ++b)
+    {
+        const std::vector<item> & items = buffers[b].m_items;
+        m_items.insert(m_items.end(), items.begin(), items.end());
+    }
+    std::sort(m_items.begin(), m_items.end(), item_less);
+}
+
+/**
+ *  Sorts the items into the order of item_less().  Used for a buffer that
+ *  collects the items of many frames, such as the capture of an offline
+ *  render, where the items added at the end of the frame can precede those
+ *  of the frame.
+ */
+
+void
+render_buffer::sort ()
+{
+    std::sort(m_items.begin(), m_items.end(), item_less);
+}
+
+/**
+ *  Creates the worker threads, and waits for them to be ready.  If a thread
+ *  cannot be created, the pool simply has fewer of them.
+ *
+ * \param count
+ *      The number of shares, including the calling thread.  Hence, count - 1
+ *      threads are created.
+ *
+ * \param work
+ *      The job to run for each share of each frame.
+ */
+
+render_pool::render_pool (int count, const job & work)
+ :
+    m_job           (work),
+    m_threads       (),
+    m_start         (),
+    m_done          (),
+    m_generation    (0),
+    m_started       (0),
+    m_pending       (0),
+    m_stop          (false)
+{
+    for (int t = 1; t < count; ++t)
+    {
+        pthread_t thread;
+        int err = pthread_create(&thread, NULL, worker_func, this);
+        if (err != 0)
+        {
+            errprint("render_pool: could not create a worker thread");
+            break;
+        }
+        m_threads.push_back(thread);
+    }
+    m_done.lock();
+    while (m_started < int(m_threads.size()))
+        m_done.wait();
+
+    m_done.unlock();
+}
+
+/**
+ *  Stops and joins the worker threads.
+ */
+
+render_pool::~render_pool ()
+{
+    m_start.lock();
+    m_stop = true;
+    m_start.broadcast();
+    m_start.unlock();
+    for (size_t t = 0; t < m_threads.size(); ++t)
+        pthread_join(m_threads[t], NULL);
+}
+
+/**
+ *  Runs the job for one frame.  The workers are woken to do their shares,
+ *  the calling thread does share 0, and then waits for the workers.
+ *
+ * \threadunsafe
+ *      Only one thread, the output thread, calls this function.
+ */
+
+void
+render_pool::run ()
+{
+    m_done.lock();
+    m_pending = int(m_threads.size());
+    m_done.unlock();
+
+    m_start.lock();
+    ++m_generation;
+    m_start.broadcast();
+    m_start.unlock();
+
+    m_job(0);
+
+    m_done.lock();
+    while (m_pending > 0)
+        m_done.wait();
+
+    m_done.unlock();
+}
+
+/**
+ *  The thread function of each worker.
+ *
+ * \param mypool
+ *      The render_pool that owns the thread.
+ *
+ * \return
+ *      Always returns nullptr.
+ */
+
+void *
+render_pool::worker_func (void * mypool)
+{
+    render_pool * p = static_cast<render_pool *>(mypool);
+    p->work();
+    return nullptr;
+}
+
+/**
+ *  The loop of each worker.  It takes the next share number, pins itself to
+ *  a CPU, and takes on the output thread's priority, if that is raised (see
+ *  output_thread_func()).  Then it runs its share of each frame until told
+ *  to stop.
+ */
+
+void
+render_pool::work ()
+{
+    m_done.lock();
+    int share = ++m_started;
+    m_done.signal();
+    m_done.unlock();
+
+#ifdef PLATFORM_LINUX
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 1)
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(int(share % cpus), &cpuset);
+        if (pthread_setaffinity_np(pthread_self(), sizeof cpuset, &cpuset) != 0)
+        {
+            errprint("render_pool: could not pin a worker thread");
+        }
+    }
+#endif
+
+#ifndef PLATFORM_WINDOWS
+    if (rc().priority())
+    {
+        struct sched_param schp;
+        memset(&schp, 0, sizeof(sched_param));
+        schp.sched_priority = 1;                /* same as output thread    */
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &schp) != 0)
+        {
+            errprint("render_pool: couldn't set scheduler to FIFO");
+        }
+    }
+#endif
+
+    unsigned long generation = 0;
+    for (;;)
+    {
+        m_start.lock();
+        while (m_generation == generation && ! m_stop)
+            m_start.wait();
+
+        bool stop = m_stop;
+        generation = m_generation;
+        m_start.unlock();
+        if (stop)
+            break;
+
+        m_job(share);
+
+        m_done.lock();
+        if (--m_pending == 0)
+            m_done.signal();
+
+        m_done.unlock();
+    }
+}
+
+}           // namespace seq64
+
+/*
+ * render_pool.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -53,9 +53,11 @@
 #include "calculations.hpp"
 #include "mastermidibus.hpp"
 #include "perform.hpp"
+#include "render_pool.hpp"              /* seq64::render_buffer             */
 #include "scales.h"
 #include "sequence.hpp"
 #include "settings.hpp"                 /* seq64::rc()                      */
+#include "tempo_map.hpp"                /* seq64::tempo_map                 */
 
 /**
  *  Enables and marks a user's patch for issue #95.
@@ -80,10 +82,11 @@ namespace seq64
 
 /**
  *  A static clipboard for holding pattern/sequence events.  Being static
- *  allows for copy/paste between patterns.
+ *  allows for copy/paste between patterns.  It is packed, so that copying
+ *  into it and out of it is cheap.
  */
 
-event_list sequence::m_events_clipboard;
+event_pack sequence::m_events_clipboard;
 
 /**
  *  Provides the default name/title for the sequence.
@@ -148,6 +151,17 @@ sequence::sequence (int ppqn)
     m_last_tick                 (0),
     m_queued_tick               (0),            /* used by perform::play()  */
     m_trigger_offset            (0),            /* for record-keeping       */
+    m_render_snapshot           (),
+    m_render_generation         (0),
+    m_render_dirty              (true),
+    m_play_render               (),
+    m_edit_depth                (0),
+    m_play_cursor               (0),
+    m_play_cursor_base          (0),
+    m_play_cursor_tick          (0),
+    m_play_cursor_valid         (false),
+    m_parked                    (false),
+    m_render_buffer             (nullptr),
     m_maxbeats                  (c_maxbeats),
     m_ppqn                      (choose_ppqn(ppqn)),
     m_seq_number                (-1),               /* may be set later     */
@@ -167,6 +181,7 @@ sequence::sequence (int ppqn)
     m_musical_scale             (int(c_scale_off)),
     m_background_sequence       (SEQ64_SEQUENCE_LIMIT),
     m_mutex                     (),
+    m_play_mutex                (),
     m_note_off_margin           (2)
 {
     m_triggers.set_ppqn(int(m_ppqn));
@@ -197,6 +212,7 @@ sequence::~sequence ()
 void
 sequence::modify ()
 {
+    m_render_dirty = true;
     if (not_nullptr(m_parent))
         m_parent->modify();
 }
@@ -219,24 +235,27 @@ sequence::partial_assign (const sequence & rhs)
 {
     if (this != &rhs)
     {
-        automutex locker(m_mutex);
-        m_parent        = rhs.m_parent;             /* a pointer, careful!  */
-        m_events        = rhs.m_events;
-        m_triggers      = rhs.m_triggers;
-        m_midi_channel  = rhs.m_midi_channel;
+        edit_locker locker(*this);
+        m_events        = rhs.m_events;             /* the long part        */
         m_transposable  = rhs.m_transposable;
-        m_bus           = rhs.m_bus;
-        m_master_bus    = rhs.m_master_bus;          /* a pointer, be aware! */
-        m_playing       = false;
         m_name          = rhs.m_name;
         m_ppqn          = rhs.m_ppqn;
-        m_length        = rhs.m_length;
         m_time_beats_per_measure = rhs.m_time_beats_per_measure;
         m_time_beat_width = rhs.m_time_beat_width;
-        for (int i = 0; i < c_midi_notes; ++i)      /* no notes are playing */
-            m_playing_notes[i] = 0;
-
-        zero_markers();                             /* reset to tick 0      */
+        {
+            automutex playlocker(m_play_mutex);     /* publish play state   */
+            m_parent        = rhs.m_parent;         /* a pointer, careful!  */
+            m_triggers      = rhs.m_triggers;
+            m_midi_channel  = rhs.m_midi_channel;
+            m_bus           = rhs.m_bus;
+            m_master_bus    = rhs.m_master_bus;     /* a pointer, be aware! */
+            m_playing       = false;
+            m_length        = rhs.m_length;
+            for (int i = 0; i < c_midi_notes; ++i)  /* no notes are playing */
+                m_playing_notes[i] = 0;
+
+            zero_markers();                         /* reset to tick 0      */
+        }
         verify_and_link();
     }
 }
@@ -252,7 +271,7 @@ sequence::partial_assign (const sequence & rhs)
 void
 sequence::set_hold_undo (bool hold)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     if (hold)
     {
         /*
@@ -269,7 +288,7 @@ sequence::set_hold_undo (bool hold)
          *  m_events_undo_hold.add(DREF(i));
          */
 
-        m_events_undo_hold = m_events;
+        m_events_undo_hold.pack(m_events);
     }
     else
        m_events_undo_hold.clear();
@@ -306,7 +325,7 @@ sequence::event_count () const
 void
 sequence::push_undo (bool hold)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     if (hold)
         m_events_undo.push(m_events_undo_hold);     // stazed
     else
@@ -331,11 +350,11 @@ sequence::push_undo (bool hold)
 void
 sequence::pop_undo ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     if (! m_events_undo.empty())                // stazed: m_list_undo
     {
         m_events_redo.push(m_events);           // move to triggers module?
-        m_events = m_events_undo.top();
+        m_events_undo.top().unpack(m_events);
         m_events_undo.pop();
         verify_and_link();
         unselect();
@@ -356,11 +375,11 @@ sequence::pop_undo ()
 void
 sequence::pop_redo ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     if (! m_events_redo.empty())                // move to triggers module?
     {
         m_events_undo.push(m_events);
-        m_events = m_events_redo.top();
+        m_events_redo.top().unpack(m_events);
         m_events_redo.pop();
         verify_and_link();
         unselect();
@@ -378,7 +397,7 @@ sequence::pop_redo ()
 void
 sequence::push_trigger_undo ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.push_undo(); // todo:  see how stazed's sequence function works
 }
 
@@ -391,8 +410,9 @@ sequence::push_trigger_undo ()
 void
 sequence::pop_trigger_undo ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.pop_undo();
+    wake();
 }
 
 /**
@@ -404,8 +424,9 @@ sequence::pop_trigger_undo ()
 void
 sequence::pop_trigger_redo ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.pop_redo();
+    wake();
 }
 
 /**
@@ -423,7 +444,7 @@ sequence::pop_trigger_redo ()
 void
 sequence::set_master_midi_bus (mastermidibus * mmb)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     m_master_bus = mmb;
 }
 
@@ -439,7 +460,7 @@ sequence::set_master_midi_bus (mastermidibus * mmb)
 void
 sequence::set_beats_per_bar (int beatspermeasure)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     if (beatspermeasure <= int(USHRT_MAX))
     {
         m_time_beats_per_measure = (unsigned short)(beatspermeasure);
@@ -459,7 +480,7 @@ sequence::set_beats_per_bar (int beatspermeasure)
 void
 sequence::set_beat_width (int beatwidth)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     if (beatwidth <= int(USHRT_MAX))
     {
         m_time_beat_width = (unsigned short)(beatwidth);
@@ -592,7 +613,7 @@ int
 sequence::select_even_or_odd_notes (int note_len, bool even)
 {
     int result = 0;
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     unselect();
     if (note_len > 0)
     {
@@ -678,7 +699,7 @@ sequence::select_note_events
 )
 {
     int result = 0;
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = DREF(i);
@@ -1017,7 +1038,7 @@ int
 sequence::select_linked (midipulse tick_s, midipulse tick_f, midibyte status)
 {
     int result = 0;
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = DREF(i);
@@ -1057,7 +1078,7 @@ sequence::select_linked (midipulse tick_s, midipulse tick_f, midibyte status)
 void
 sequence::set_rec_vol (int recvol)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool valid = recvol >= 0;
     if (valid)
         valid = recvol <= SEQ64_MAX_NOTE_ON_VELOCITY;
@@ -1106,22 +1127,18 @@ sequence::toggle_playing (midipulse tick, bool resumenoteons)
 void
 sequence::toggle_queued ()
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     m_queued = ! m_queued;
-    m_queued_tick = m_last_tick - mod_last_tick() + m_length;
+    m_queued_tick = last_tick() - mod_last_tick() + m_length;
     m_off_from_snap = true;
     set_dirty_mp();
-
-    midi_control_out * mco = m_parent->get_midi_control_out();
-    if (not_nullptr(mco))
-    {
-        if (m_queued)
-            mco->send_seq_event(number(), midi_control_out::seq_action_queue);
-        else if (get_playing())
-            mco->send_seq_event(number(), midi_control_out::seq_action_arm);
-        else
-            mco->send_seq_event(number(), midi_control_out::seq_action_mute);
-    }
+    wake();
+    if (m_queued)
+        send_seq_event(midi_control_out::seq_action_queue);
+    else if (get_playing())
+        send_seq_event(midi_control_out::seq_action_arm);
+    else
+        send_seq_event(midi_control_out::seq_action_mute);
 }
 
 /**
@@ -1144,6 +1161,24 @@ sequence::toggle_queued ()
  *  function.  Its return value and side-effects tell if there's a change in
  *  playing based on triggers, and provides the ticks that bracket it.
  *
+ *  The events are walked from a persistent playback cursor (see
+ *  reset_play_cursor()), so that the cost of a frame depends on the number of
+ *  events due in the frame, not on the size of the pattern.  The cursor is
+ *  repositioned if the frame does not follow the previous one, or if the
+ *  event list has been edited.
+ *
+ *  The events and triggers are read from what the editors last published
+ *  (see publish()), so that an edit in progress does not hold up the output
+ *  thread.  Only m_play_mutex is used, and only tried:  if another thread
+ *  holds it, this frame is skipped, and, since m_last_tick is not advanced,
+ *  it is played by the next frame.
+ *
+ *  Song recording is the one case where the output thread changes the
+ *  triggers.  It grows the recorded trigger only if no editor holds
+ *  m_mutex, and publishes the change itself; otherwise a later frame grows
+ *  it.  The JACK engine, which must not allocate, leaves this to the
+ *  output thread (see song_recording_grow()).
+ *
  * \param tick
  *      Provides the current end-tick value.  The tick comes in as a global
  *      tick.
@@ -1169,7 +1204,9 @@ sequence::play
     bool resumenoteons
 )
 {
-    automutex locker(m_mutex);
+    if (! m_play_mutex.try_lock())
+        return;                             /* caught up by the next frame  */
+
     bool trigger_turning_off = false;       /* turn off after in-frame play */
     midipulse start_tick = m_last_tick;     /* modified in triggers::play() */
     midipulse end_tick = tick;
@@ -1186,7 +1223,15 @@ sequence::play
 
         if (song_recording())
         {
-            grow_trigger(song_record_tick(), end_tick, SEQ64_SONG_RECORD_INC);
+            if (! perform::in_engine_cycle() && m_mutex.try_lock())
+            {
+                m_triggers.grow
+                (
+                    song_record_tick(), end_tick, SEQ64_SONG_RECORD_INC
+                );
+                m_triggers.publish();
+                m_mutex.unlock();
+            }
             set_dirty_mp();                 /* force redraw                 */
         }
         if (playback_mode)                  /* song mode: on/off triggers   */
@@ -1197,54 +1242,302 @@ sequence::play
             );
         }
     }
-    if (m_playing)                          /* play notes in frame          */
+    const render_list & rl = render_events();
+    if (m_playing && m_length > 0 && ! rl.empty())
     {
         midipulse offset = m_length - m_trigger_offset;
         midipulse start_tick_offset = start_tick + offset;
         midipulse end_tick_offset = end_tick + offset;
-        midipulse times_played = m_last_tick / m_length;
-        midipulse offset_base = times_played * m_length;
         int transpose = get_transposable() ? m_parent->get_transpose() : 0 ;
-        event_list::iterator e = m_events.begin();
-        while (e != m_events.end())
+        if (! m_play_cursor_valid || m_play_cursor_tick != start_tick_offset)
+            reset_play_cursor(start_tick_offset);
+
+        int & e = m_play_cursor;
+        for (;;)
         {
-            event & er = DREF(e);
-            midipulse stamp = er.get_timestamp() + offset_base;
-            if (stamp >= start_tick_offset && stamp <= end_tick_offset)
-            {
-                if (transpose != 0 && er.is_note()) /* includes Aftertouch  */
-                {
-                    event transposed_event = er;    /* assign ALL members   */
-                    transposed_event.transpose_note(transpose);
-                    put_event_on_bus(transposed_event);
-                }
-                else
-                {
-                    if (er.is_tempo())
-                    {
-                        if (not_nullptr(m_parent))
-                            m_parent->set_beats_per_minute(er.tempo());
-                    }
-                    else if (! er.is_ex_data())
-                        put_event_on_bus(er);       /* frame still going    */
-                }
-            }
-            else if (stamp > end_tick_offset)
+            midipulse stamp = rl.timestamp(e) + m_play_cursor_base;
+            if (stamp > end_tick_offset)
                 break;                              /* frame is done        */
 
-            ++e;                                    /* go to next event     */
-            if (e == m_events.end())                /* did we hit the end ? */
+            if (rl.is_tempo(e))
+            {
+                if (not_nullptr(m_render_buffer))
+                    m_render_buffer->add_tempo(stamp - offset, rl.tempo(e));
+                else if (not_nullptr(m_parent))
+                    m_parent->set_beats_per_minute(rl.tempo(e), stamp - offset);
+            }
+            else
+            {
+                event ev;                           /* no SysEx, no alloc   */
+                ev.set_timestamp(rl.timestamp(e));
+                ev.set_status(rl.status(e));
+                ev.set_data(rl.d0(e), rl.d1(e));
+                if (transpose != 0 && ev.is_note()) /* includes Aftertouch  */
+                    ev.transpose_note(transpose);
+
+                put_event_on_bus(ev, stamp - offset);   /* frame going  */
+            }
+            if (++e == rl.count())                  /* did we hit the end ? */
             {
-                e = m_events.begin();               /* yes, start over      */
-                offset_base += m_length;            /* for another go at it */
+                e = 0;                              /* yes, start over      */
+                m_play_cursor_base += m_length;     /* for another go at it */
             }
         }
+        if (end_tick_offset < start_tick_offset)    /* went backward        */
+            m_play_cursor_valid = false;
+        else
+            m_play_cursor_tick = end_tick_offset + 1;   /* next frame start */
     }
-    if (trigger_turning_off)                        /* triggers: "turn off" */
-        set_playing(false);
+    else
+        m_play_cursor_valid = false;
 
     m_last_tick = end_tick + 1;                     /* for next frame       */
+    if (trigger_turning_off)                        /* triggers: "turn off" */
+        set_playing(false);                         /* Note Offs after it   */
+
     m_was_playing = m_playing;
+    m_play_mutex.unlock();
+}
+
+/**
+ *  Positions the playback cursor at the first event due at or after the
+ *  given (offset) tick.  The legacy play() loop started each frame at
+ *  m_events.begin() with an offset base of the last tick rounded down to a
+ *  multiple of m_length, skipping events until it reached the start of the
+ *  frame.  This function finds that same event directly, so that play() can
+ *  then walk only the events that are due in the frame, and keep walking
+ *  from there in the frames that follow.
+ *
+ * \threadunsafe
+ *      Called by play() with m_play_mutex held.
+ *
+ * \param tick
+ *      The start of the frame, already offset by the length and trigger
+ *      offset, as calculated in play().
+ */
+
+void
+sequence::reset_play_cursor (midipulse tick)
+{
+    midipulse base = (m_last_tick / m_length) * m_length;
+    if (tick < base)
+        tick = base;
+
+    m_play_cursor_base = (tick / m_length) * m_length;
+    m_play_cursor = m_play_render->lower_bound(tick - m_play_cursor_base);
+    if (m_play_cursor == m_play_render->count())
+    {
+        m_play_cursor = 0;
+        m_play_cursor_base += m_length;
+    }
+    m_play_cursor_valid = true;
+}
+
+/**
+ *  Provides the flat list of playable events last published by an editor
+ *  (see publish()).  If a new one has been published since the last call,
+ *  it replaces the one being played, and the playback cursor is
+ *  invalidated.  Neither locks m_mutex nor allocates.
+ *
+ * \threadunsafe
+ *      Called by play() and resume_note_ons() with m_play_mutex held.
+ *
+ * \return
+ *      Returns a reference to the render list.
+ */
+
+const render_list &
+sequence::render_events ()
+{
+    std::shared_ptr<const render_list> rl = m_render_snapshot.load();
+    if (rl != m_play_render)
+    {
+        m_play_render = rl;                 /* publish() frees the old one  */
+        invalidate_play_cursor();
+    }
+    return *m_play_render;
+}
+
+/**
+ *  Publishes the playback data for the output thread, at the end of an edit
+ *  (see edit_locker).  A new render list is built if the event list has
+ *  changed since the last one, and the trigger index is published if the
+ *  triggers have changed.  Nothing is built if nothing has changed.
+ *
+ * \threadunsafe
+ *      Called with m_mutex held.
+ */
+
+void
+sequence::publish ()
+{
+    bool dirty = m_render_dirty.exchange(false);
+    if (dirty || m_render_generation != m_events.generation())
+    {
+        std::shared_ptr<render_list> rl = std::make_shared<render_list>();
+        rl->build(m_events);
+        m_render_generation = m_events.generation();
+        m_render_snapshot.publish(rl);
+    }
+    m_triggers.publish();
+}
+
+/**
+ *  Indicates if this sequence would produce no output, and change no state,
+ *  if played over the given range of ticks.  That is the case if it is not
+ *  playing, queued, one-shot, or recording, and, in Song mode, if it is
+ *  muted or has no trigger in the range.  A sequence blocked by a Live
+ *  change in Song mode is never idle, since the block is lifted only at a
+ *  trigger transition, which triggers::play() has to see.
+ *
+ * \threadunsafe
+ *      Called by park() and unpark() with m_play_mutex held.
+ *
+ * \param starttick
+ *      The first tick of the range.
+ *
+ * \param endtick
+ *      The last tick of the range.
+ *
+ * \param songmode
+ *      True if playback is in Song mode.
+ *
+ * \param waketick
+ *      Returns the start of the first trigger after the range, if idle in
+ *      Song mode, and SEQ64_NULL_MIDIPULSE otherwise.
+ *
+ * \return
+ *      Returns true if the sequence is idle.
+ */
+
+bool
+sequence::idle
+(
+    midipulse starttick, midipulse endtick,
+    bool songmode, midipulse & waketick
+) const
+{
+    waketick = SEQ64_NULL_MIDIPULSE;
+    bool result = ! m_playing && ! m_queued && ! m_one_shot &&
+        ! m_recording && ! m_song_recording;
+
+    if (result && songmode && ! m_song_mute)
+    {
+        /*
+         * After a jump backward, triggers::play() takes its state from the
+         * trigger at the end tick, so the range must include that tick.
+         */
+
+        if (starttick > endtick)
+            starttick = endtick;
+
+        if (m_song_playback_block)
+            result = false;
+        else
+            result = ! m_triggers.covers(starttick, endtick, waketick);
+    }
+    return result;
+}
+
+/**
+ *  Called by perform::play() after playing a frame.  If the sequence is now
+ *  idle for the start of the next frame, it is parked, and perform drops it
+ *  from its play set.
+ *
+ * \threadsafe
+ *
+ * \param songmode
+ *      True if playback is in Song mode.
+ *
+ * \param waketick
+ *      Returns the tick at which the sequence needs to be unparked, or
+ *      SEQ64_NULL_MIDIPULSE if only a change of state can do that.
+ *
+ * \return
+ *      Returns true if the sequence is parked.
+ */
+
+bool
+sequence::park (bool songmode, midipulse & waketick)
+{
+    automutex locker(m_play_mutex);
+    m_parked = idle(m_last_tick, m_last_tick, songmode, waketick);
+    return m_parked;
+}
+
+/**
+ *  Called by perform::rebuild_play_set() before playing a frame.  If the
+ *  sequence is parked, but not idle over the frame, it is unparked, and its
+ *  last tick is caught up to the tick shared by the parked sequences.
+ *
+ * \threadsafe
+ *
+ * \param lasttick
+ *      The last tick of the parked sequences, perform::park_tick().
+ *
+ * \param tick
+ *      The end tick of the coming frame.
+ *
+ * \param songmode
+ *      True if playback is in Song mode.
+ *
+ * \param waketick
+ *      Returns the tick at which the sequence needs to be unparked, if it
+ *      stays parked.
+ *
+ * \return
+ *      Returns true if the sequence is (now) not parked, and must be played.
+ */
+
+bool
+sequence::unpark
+(
+    midipulse lasttick, midipulse tick,
+    bool songmode, midipulse & waketick
+)
+{
+    automutex locker(m_play_mutex);
+    waketick = SEQ64_NULL_MIDIPULSE;
+    if (m_parked && ! idle(lasttick, tick, songmode, waketick))
+    {
+        m_parked = false;
+        m_last_tick = lasttick;
+        invalidate_play_cursor();
+    }
+    return ! m_parked;
+}
+
+/**
+ *  If this sequence is parked, asks the performance to reconsider it before
+ *  the next frame.  Called after any change that can end idleness:
+ *  arming, queuing, recording, unmuting, and adding or moving triggers.
+ *
+ * \threadsafe
+ */
+
+void
+sequence::wake ()
+{
+    automutex locker(m_play_mutex);
+    if (m_parked && not_nullptr(m_parent))
+        m_parent->wake_play_set();
+}
+
+/**
+ *  Provides the last tick played.  A parked sequence is not played, so its
+ *  last tick is the one kept by the performance for all parked sequences.
+ *
+ * \return
+ *      Returns m_last_tick, or the park tick of the performance.
+ */
+
+midipulse
+sequence::last_tick () const
+{
+    if (m_parked && not_nullptr(m_parent))
+        return m_parent->park_tick();
+    else
+        return m_last_tick;
 }
 
 /**
@@ -1257,13 +1550,14 @@ sequence::play
 void
 sequence::verify_and_link ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
 
 #ifdef PLATFORM_DEBUG_TMI
     m_events.print_notes("before");
 #endif
 
     m_events.verify_and_link(m_length);
+    m_render_dirty = true;                      /* note links can change    */
 
 #ifdef PLATFORM_DEBUG_TMI
     m_events.print_notes("after");
@@ -1279,8 +1573,9 @@ sequence::verify_and_link ()
 void
 sequence::link_new ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events.link_new();
+    m_render_dirty = true;
 }
 
 /**
@@ -1300,10 +1595,14 @@ void
 sequence::remove (event_list::iterator i)
 {
     event & er = DREF(i);
-    if (er.is_note_off() && m_playing_notes[er.get_note()] > 0)
+    if (er.is_note_off())
     {
-        m_master_bus->play(m_bus, &er, m_midi_channel);
-        --m_playing_notes[er.get_note()];                   // ugh
+        automutex locker(m_play_mutex);
+        if (m_playing_notes[er.get_note()] > 0)
+        {
+            m_master_bus->play(m_bus, &er, m_midi_channel);
+            --m_playing_notes[er.get_note()];               // ugh
+        }
     }
     m_events.remove(i);                                     // erase(i)
 }
@@ -1353,7 +1652,7 @@ sequence::remove (event & e)
 bool
 sequence::remove_marked ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
 
 #ifdef LAYK_PULL_REQUEST_95
 
@@ -1394,7 +1693,7 @@ sequence::remove_marked ()
 bool
 sequence::mark_selected ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = m_events.mark_selected();
     reset_draw_marker();
     return result;
@@ -1412,7 +1711,7 @@ sequence::mark_selected ()
 void
 sequence::remove_selected ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     if (m_events.mark_selected())
     {
         m_events_undo.push(m_events);           /* push_undo() without lock */
@@ -1430,7 +1729,7 @@ sequence::remove_selected ()
 void
 sequence::unpaint_all ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events.unpaint_all();
 }
 
@@ -1460,7 +1759,7 @@ sequence::get_selected_box
     midipulse & tick_s, int & note_h, midipulse & tick_f, int & note_l
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     tick_s = m_maxbeats * m_ppqn;
     tick_f = 0;
     note_h = 0;
@@ -1512,7 +1811,7 @@ sequence::get_onsets_selected_box
     midipulse & tick_s, int & note_h, midipulse & tick_f, int & note_l
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     tick_s = m_maxbeats * m_ppqn;
     tick_f = 0;
     note_h = 0;
@@ -1570,7 +1869,7 @@ sequence::get_clipboard_box
     midipulse & tick_s, int & note_h, midipulse & tick_f, int & note_l
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     tick_s = m_maxbeats * m_ppqn;
     tick_f = 0;
     note_h = 0;
@@ -1581,17 +1880,17 @@ sequence::get_clipboard_box
     }
     else
     {
-        event_list::iterator i;
-        for (i = m_events_clipboard.begin(); i != m_events_clipboard.end(); ++i)
+        for (int i = 0; i < m_events_clipboard.count(); ++i)
         {
-            midipulse time = DREF(i).get_timestamp();
+            const event_pack::item & pe = m_events_clipboard.at(i);
+            midipulse time = pe.pe_tick;
             if (time < tick_s)
                 tick_s = time;
 
             if (time > tick_f)
                 tick_f = time;
 
-            int note = DREF(i).get_note();
+            int note = pe.pe_d0;
             if (note < note_l)
                 note_l = note;
 
@@ -1681,7 +1980,7 @@ sequence::select_note_events
 )
 {
     int result = 0;
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -1887,7 +2186,7 @@ sequence::select_events
 )
 {
     int result = 0;
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -1949,7 +2248,7 @@ sequence::select_events
 void
 sequence::select_all ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events.select_all();
 }
 
@@ -1962,7 +2261,7 @@ sequence::select_all ()
 void
 sequence::unselect ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events.unselect_all();
 }
 
@@ -2015,7 +2314,7 @@ sequence::move_selected_notes (midipulse delta_tick, int delta_note)
 {
     if (mark_selected())                            /* locked recursively   */
     {
-        automutex locker(m_mutex);
+        edit_locker locker(*this);
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
@@ -2168,7 +2467,7 @@ sequence::stretch_selected (midipulse delta_tick)
 {
     if (mark_selected())
     {
-        automutex locker(m_mutex);
+        edit_locker locker(*this);
         unsigned first_ev = 0x7fffffff;             /* timestamp lower limit */
         unsigned last_ev = 0x00000000;              /* timestamp upper limit */
         m_events_undo.push(m_events);               /* push_undo(), no lock  */
@@ -2259,7 +2558,7 @@ sequence::grow_selected (midipulse delta)
 {
     if (mark_selected())                            /* locked recursively   */
     {
-        automutex locker(m_mutex);                  /* lock it again, dude  */
+        edit_locker locker(*this);                  /* lock it again, dude  */
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
@@ -2314,7 +2613,7 @@ sequence::randomize_selected
     midibyte data[2];
     midibyte datitem;
     int datidx = 0;
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events_undo.push(m_events);               /* push_undo(), no lock  */
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -2350,6 +2649,7 @@ sequence::randomize_selected
             e.set_data(data[0], data[1]);
         }
     }
+    m_render_dirty = true;                      /* data edited in place     */
 }
 
 void
@@ -2358,7 +2658,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
     midibyte data[2];
     midibyte datitem;
     int datidx = 0;
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & e = DREF(i);
@@ -2386,6 +2686,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
             e.set_data(data[0], data[1]);
         }
     }
+    m_render_dirty = true;                      /* data edited in place     */
 }
 
 #endif   // USE_STAZED_RANDOMIZE_SUPPORT
@@ -2414,7 +2715,7 @@ sequence::adjust_data_handle (midibyte status, int adata)
 void
 sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -2429,6 +2730,7 @@ sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
             }
         }
     }
+    m_render_dirty = true;                      /* data edited in place     */
 }
 
 /**
@@ -2457,7 +2759,7 @@ sequence::increment_selected (midibyte astat, midibyte /*acontrol*/)
 void
 sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
         event & er = DREF(i);
@@ -2472,6 +2774,7 @@ sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
             }
         }
     }
+    m_render_dirty = true;                      /* data edited in place     */
 }
 
 /**
@@ -2503,7 +2806,7 @@ sequence::decrement_selected (midibyte astat, midibyte /*acontrol*/)
 void
 sequence::copy_selected ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     event_list clipbd;
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -2522,7 +2825,7 @@ sequence::copy_selected ()
                     DREF(i).set_timestamp(t - first_tick);
             }
         }
-        m_events_clipboard = clipbd;
+        m_events_clipboard.pack(clipbd);
     }
 
     /*
@@ -2624,8 +2927,9 @@ sequence::paste_selected (midipulse tick, int note)
 {
     if (! m_events_clipboard.empty())
     {
-        automutex locker(m_mutex);
-        event_list clipbd = m_events_clipboard;     /* copy the clipboard   */
+        edit_locker locker(*this);
+        event_list clipbd;
+        m_events_clipboard.unpack(clipbd);          /* copy the clipboard   */
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = clipbd.begin(); i != clipbd.end(); ++i)
         {
@@ -2744,7 +3048,7 @@ sequence::change_event_data_range
     int data_s, int data_f, bool useundo
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = false;
     bool have_selection = m_events.any_selected_events(status, cc);
     if (useundo)
@@ -2833,6 +3137,7 @@ sequence::change_event_data_range
             result = true;
         }
     }
+    m_render_dirty = true;                      /* data edited in place     */
     return result;
 }
 
@@ -2874,7 +3179,7 @@ sequence::change_event_data_relative
     int newval, bool useundo
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = false;
     bool have_selection = m_events.any_selected_events(status, cc);
     if (useundo)
@@ -2957,6 +3262,7 @@ sequence::change_event_data_relative
             er.set_data(d0, d1);
         }
     }
+    m_render_dirty = true;                      /* data edited in place     */
     return result;
 }
 
@@ -3006,7 +3312,7 @@ sequence::change_event_data_lfo
     wave_type_t wave, midibyte status, midibyte cc, bool useundo
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     double dlength = double(m_length);
     double dbw = double(m_time_beat_width);
     bool have_selection = m_events.any_selected_events(status, cc);
@@ -3062,6 +3368,7 @@ sequence::change_event_data_lfo
             e.set_data(d0, d1);
         }
     }
+    m_render_dirty = true;                      /* data edited in place     */
 }
 
 /**
@@ -3131,7 +3438,7 @@ sequence::add_note
     bool result = false;
     if (tick >= 0 && note >= 0 && note < c_num_keys)
     {
-        automutex locker(m_mutex);
+        edit_locker locker(*this);
         bool hardwire = velocity == SEQ64_PRESERVE_VELOCITY;
         bool ignore = false;
         if (paint)                        /* see the banner above */
@@ -3282,7 +3589,7 @@ sequence::add_chord (int chord, midipulse tick, midipulse len, int note)
 bool
 sequence::add_event (const event & er)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
 
     /*
      * Here, Seq32 marks painted events and removes them.  Should we adopt
@@ -3356,7 +3663,7 @@ sequence::add_event
     midibyte d0, midibyte d1, bool paint
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = false;
     if (tick >= 0)
     {
@@ -3457,7 +3764,7 @@ sequence::check_loop_reset ()
 bool
 sequence::stream_event (event & ev)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = channels_match(ev);           /* set if channel matches   */
     if (result)
     {
@@ -3509,10 +3816,15 @@ sequence::stream_event (event & ev)
                     if (! keepvelocity)
                         velocity = m_rec_vol;
 
+                    midipulse tick;
+                    {
+                        automutex playlocker(m_play_mutex);
+                        tick = mod_last_tick();
+                    }
                     m_events_undo.push(m_events);       /* push_undo()      */
                     add_note                            /* more locking     */
                     (
-                        mod_last_tick(), get_snap_tick() - m_note_off_margin,
+                        tick, get_snap_tick() - m_note_off_margin,
                         ev.get_note(), false, velocity
                     );
                     set_dirty();
@@ -3522,7 +3834,10 @@ sequence::stream_event (event & ev)
                     --m_notes_on;
 
                 if (m_notes_on <= 0)
+                {
+                    automutex playlocker(m_play_mutex);
                     m_last_tick += get_snap_tick();
+                }
             }
         }
         if (m_thru)
@@ -3590,7 +3905,7 @@ sequence::set_dirty ()
 bool
 sequence::is_dirty_names ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = m_dirty_names;
     m_dirty_names = false;
     return result;
@@ -3610,7 +3925,7 @@ sequence::is_dirty_names ()
 bool
 sequence::is_dirty_main ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = m_dirty_main;
     m_dirty_main = false;
     return result;
@@ -3629,7 +3944,7 @@ sequence::is_dirty_main ()
 bool
 sequence::is_dirty_perf ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = m_dirty_perf;
     m_dirty_perf = false;
     return result;
@@ -3648,7 +3963,7 @@ sequence::is_dirty_perf ()
 bool
 sequence::is_dirty_edit ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = m_dirty_edit;
     m_dirty_edit = false;
     return result;
@@ -3669,7 +3984,7 @@ sequence::is_dirty_edit ()
 void
 sequence::play_note_on (int note)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     event e;
     e.set_status(EVENT_NOTE_ON);
     e.set_data(note, midibyte(m_note_on_velocity)); // SEQ64_MIDI_COUNT_MAX-1
@@ -3691,7 +4006,7 @@ sequence::play_note_on (int note)
 void
 sequence::play_note_off (int note)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     event e;
     e.set_status(EVENT_NOTE_OFF);
     e.set_data(note, midibyte(m_note_off_velocity));
@@ -3708,7 +4023,7 @@ sequence::play_note_off (int note)
 void
 sequence::clear_triggers ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.clear();
 }
 
@@ -3737,8 +4052,9 @@ sequence::add_trigger
     midipulse tick, midipulse len, midipulse offset, bool fixoffset
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.add(tick, len, offset, fixoffset);
+    wake();
 }
 
 /**
@@ -3770,7 +4086,7 @@ sequence::intersect_triggers
     midipulse position, midipulse & start, midipulse & ender
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     return m_triggers.intersect(position, start, ender);
 }
 
@@ -3781,7 +4097,7 @@ sequence::intersect_triggers
 bool
 sequence::intersect_triggers (midipulse position)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     return m_triggers.intersect(position);
 }
 
@@ -3823,7 +4139,7 @@ sequence::intersect_notes
     midipulse & start, midipulse & ender, int & note
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     event_list::iterator on = m_events.begin();
     event_list::iterator off = m_events.begin();
     while (on != m_events.end())
@@ -3904,7 +4220,7 @@ sequence::intersect_events
     midibyte status, midipulse & start
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     midipulse poslength = posend - posstart;
     for (event_list::iterator on = m_events.begin(); on != m_events.end(); ++on)
     {
@@ -3940,7 +4256,7 @@ sequence::intersect_events
 void
 sequence::grow_trigger (midipulse tickfrom, midipulse tickto, midipulse len)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
 
     /*
      * This check doesn't hurt, but doesn't prevent creating the new trigger.
@@ -3949,6 +4265,7 @@ sequence::grow_trigger (midipulse tickfrom, midipulse tickto, midipulse len)
      */
 
     m_triggers.grow(tickfrom, tickto, len);
+    wake();
 }
 
 /**
@@ -3964,7 +4281,7 @@ sequence::grow_trigger (midipulse tickfrom, midipulse tickto, midipulse len)
 void
 sequence::delete_trigger (midipulse tick)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.remove(tick);
 }
 
@@ -3981,7 +4298,7 @@ sequence::delete_trigger (midipulse tick)
 void
 sequence::set_trigger_offset (midipulse trigger_offset)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     if (m_length > 0)
     {
         m_trigger_offset = trigger_offset % m_length;
@@ -4007,7 +4324,7 @@ sequence::set_trigger_offset (midipulse trigger_offset)
 void
 sequence::split_trigger (midipulse splittick)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.split(splittick);
 }
 
@@ -4021,7 +4338,7 @@ sequence::split_trigger (midipulse splittick)
 void
 sequence::half_split_trigger (midipulse splittick)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.half_split(splittick);
 }
 
@@ -4035,7 +4352,7 @@ sequence::half_split_trigger (midipulse splittick)
 void
 sequence::exact_split_trigger (midipulse splittick)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.exact_split(splittick);
 }
 
@@ -4054,7 +4371,7 @@ sequence::exact_split_trigger (midipulse splittick)
 void
 sequence::adjust_trigger_offsets_to_length (midipulse newlength)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.adjust_offsets_to_length(newlength);
 }
 
@@ -4074,8 +4391,9 @@ sequence::adjust_trigger_offsets_to_length (midipulse newlength)
 void
 sequence::copy_triggers (midipulse starttick, midipulse distance)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.copy(starttick, distance);
+    wake();
 }
 
 /**
@@ -4101,8 +4419,9 @@ sequence::copy_triggers (midipulse starttick, midipulse distance)
 void
 sequence::move_triggers (midipulse starttick, midipulse distance, bool direction)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.move(starttick, distance, direction);
+    wake();
 }
 
 /**
@@ -4118,7 +4437,7 @@ sequence::move_triggers (midipulse starttick, midipulse distance, bool direction
 midipulse
 sequence::selected_trigger_start ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     return m_triggers.get_selected_start();
 }
 
@@ -4135,7 +4454,7 @@ sequence::selected_trigger_start ()
 midipulse
 sequence::selected_trigger_end ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     return m_triggers.get_selected_end();
 }
 
@@ -4176,8 +4495,10 @@ sequence::move_triggers
     midipulse tick, bool adjustoffset, triggers::grow_edit_t which
 )
 {
-    automutex locker(m_mutex);
-    return m_triggers.move_selected(tick, adjustoffset, which);
+    edit_locker locker(*this);
+    bool result = m_triggers.move_selected(tick, adjustoffset, which);
+    wake();
+    return result;
 }
 
 /**
@@ -4187,8 +4508,9 @@ sequence::move_triggers
 void
 sequence::offset_triggers (midipulse tick, triggers::grow_edit_t editmode)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.offset_selected(tick, editmode);
+    wake();
 }
 
 /**
@@ -4256,7 +4578,7 @@ sequence::get_triggers () const
 bool
 sequence::select_trigger (midipulse tick)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     return m_triggers.select(tick);
 }
 
@@ -4270,7 +4592,7 @@ sequence::select_trigger (midipulse tick)
 bool
 sequence::unselect_trigger (midipulse tick)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     return m_triggers.unselect(tick);
 }
 
@@ -4284,7 +4606,7 @@ sequence::unselect_trigger (midipulse tick)
 bool
 sequence::unselect_triggers ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     return m_triggers.unselect();
 }
 
@@ -4295,7 +4617,7 @@ sequence::unselect_triggers ()
 void
 sequence::delete_selected_triggers ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.remove_selected();
 }
 
@@ -4306,7 +4628,7 @@ sequence::delete_selected_triggers ()
 void
 sequence::cut_selected_trigger ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     copy_selected_trigger();                    /* locks itself (recursive) */
     m_triggers.remove_selected();
 }
@@ -4319,7 +4641,7 @@ sequence::cut_selected_trigger ()
 void
 sequence::copy_selected_trigger ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     set_trigger_paste_tick(SEQ64_NO_PASTE_TRIGGER);
     m_triggers.copy_selected();
 }
@@ -4340,8 +4662,9 @@ sequence::copy_selected_trigger ()
 void
 sequence::paste_trigger (midipulse paste_tick)
 {
-    automutex locker(m_mutex);          /* @new ca 2016-08-03   */
+    edit_locker locker(*this);
     m_triggers.paste(paste_tick);
+    wake();
 }
 
 /**
@@ -4382,6 +4705,23 @@ sequence::pause (bool song_mode)
         set_playing(state);
 }
 
+/**
+ *  Rebuilds a tempo map from the tempo and time-signature events of this
+ *  sequence, normally the tempo track.
+ *
+ * \threadsafe
+ *
+ * \param tm
+ *      The map to rebuild.
+ */
+
+void
+sequence::fill_tempo_map (tempo_map & tm) const
+{
+    automutex locker(m_mutex);
+    tm.build(m_events);
+}
+
 /**
  *  This refreshes the draw marker to the first event. It resets the draw marker
  *  so that calls to get_next_note_event() will start from the first event.
@@ -4396,7 +4736,7 @@ sequence::pause (bool song_mode)
 void
 sequence::reset_draw_marker ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_iterator_draw = m_events.begin();
 }
 
@@ -4413,7 +4753,7 @@ sequence::reset_draw_marker ()
 void
 sequence::inc_draw_marker ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     ++m_iterator_draw;
 }
 
@@ -4426,10 +4766,30 @@ sequence::inc_draw_marker ()
 void
 sequence::reset_draw_trigger_marker ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_triggers.reset_draw_trigger_marker();
 }
 
+/**
+ *  Sets the draw-trigger iterator to the first trigger visible in the given
+ *  range of ticks.  See triggers::reset_draw_trigger_marker().
+ *
+ * \threadsafe
+ *
+ * \param starttick
+ *      The first tick visible in the window.
+ *
+ * \param endtick
+ *      The last tick visible in the window.
+ */
+
+void
+sequence::reset_draw_trigger_marker (midipulse starttick, midipulse endtick)
+{
+    edit_locker locker(*this);
+    m_triggers.reset_draw_trigger_marker(starttick, endtick);
+}
+
 /**
  *  A new function provided so that we can find the minimum and maximum notes
  *  with only one (not two) traversal of the event list.
@@ -4458,7 +4818,7 @@ sequence::reset_draw_trigger_marker ()
 bool
 sequence::get_minmax_note_events (int & lowest, int & highest)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     bool result = false;
     int low = SEQ64_MAX_DATA_VALUE;
     int high = -1;
@@ -4787,7 +5147,7 @@ sequence::get_next_trigger
 void
 sequence::remove_all ()
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events.clear();
     m_events.unmodify();
 }
@@ -4803,8 +5163,9 @@ sequence::remove_all ()
 void
 sequence::set_last_tick (midipulse tick)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     m_last_tick = tick;
+    invalidate_play_cursor();           /* a reposition, reset the cursor   */
 }
 
 /**
@@ -4819,10 +5180,11 @@ sequence::set_last_tick (midipulse tick)
 midipulse
 sequence::get_last_tick () const
 {
+    midipulse lt = last_tick();
     if (m_length > 0)
-        return (m_last_tick + m_length - m_trigger_offset) % m_length;
+        return (lt + m_length - m_trigger_offset) % m_length;
     else
-        return m_last_tick - m_trigger_offset;
+        return lt - m_trigger_offset;
 }
 
 /**
@@ -4845,14 +5207,18 @@ sequence::get_last_tick () const
 void
 sequence::set_midi_bus (char mb, bool user_change)
 {
-    automutex locker(m_mutex);
-    off_playing_notes();                /* off notes except initial         */
-    if (mb != m_bus)
+    edit_locker locker(*this);
+    bool changed;
     {
-        m_bus = mb;
-        if (user_change)
-            modify();                   /* no easy way to undo this, though */
+        automutex playlocker(m_play_mutex);
+        off_playing_notes();            /* off notes except initial         */
+        changed = mb != m_bus;
+        if (changed)
+            m_bus = mb;
     }
+    if (changed && user_change)
+        modify();                       /* no easy way to undo this, though */
+
     set_dirty();                        /* this is for display updating     */
 }
 
@@ -4911,32 +5277,41 @@ sequence::set_midi_bus (char mb, bool user_change)
 void
 sequence::set_length (midipulse len, bool adjust_triggers, bool verify)
 {
-    automutex locker(m_mutex);
-    bool was_playing = get_playing();
-    set_playing(false);                 /* turn everything off              */
+    edit_locker locker(*this);
     if (len > 0)
     {
         if (len < midipulse(m_ppqn / 4))
             len = midipulse(m_ppqn / 4);
-
-        m_length = len;
     }
     else
         len = m_length;
 
+    /*
+     * The events are relinked against the new length under m_mutex only.
+     * The output thread keeps playing the old render list at the old length
+     * meanwhile, and picks up both once the new length is published.
+     */
+
+    if (verify)
+    {
+        m_events.verify_and_link(len);
+        m_render_dirty = true;          /* note links can change            */
+        reset_draw_marker();
+    }
+
     /*
      * We should set the measures count here.
      */
 
+    automutex playlocker(m_play_mutex);
+    bool was_playing = get_playing();
+    set_playing(false);                 /* turn everything off              */
+    m_length = len;
+    invalidate_play_cursor();           /* cursor offsets depend on length  */
     m_triggers.set_length(len);         /* must precede adjust call         */
     if (adjust_triggers)
         m_triggers.adjust_offsets_to_length(len);
 
-    if (verify)
-    {
-        verify_and_link();
-        reset_draw_marker();
-    }
     if (was_playing)                    /* start up and refresh             */
         set_playing(true);
 }
@@ -5010,7 +5385,7 @@ sequence::extend (midipulse len)
 void
 sequence::set_playing (bool p)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     bool send_play = p != get_playing();
     if (p != get_playing())
     {
@@ -5029,15 +5404,43 @@ sequence::set_playing (bool p)
     }
     m_queued = false;
     m_one_shot = false;
+    if (p)
+        wake();
+
     if (send_play)
     {
-        midi_control_out * mco = m_parent->get_midi_control_out();
-        if (not_nullptr(mco))
+        send_seq_event
+        (
+            p ? midi_control_out::seq_action_arm :
+                midi_control_out::seq_action_mute
+        );
+    }
+}
+
+/**
+ *  Sends the MIDI control output event, if any, for a change in the state
+ *  of this sequence.  While the sequence is played into a render buffer,
+ *  the event goes there with the rest, so that the JACK engine does not
+ *  take the lock of the master bus.
+ *
+ * \param what
+ *      The new state of the sequence.
+ */
+
+void
+sequence::send_seq_event (midi_control_out::seq_action what)
+{
+    midi_control_out * mco = m_parent->get_midi_control_out();
+    if (not_nullptr(mco))
+    {
+        event ev;
+        if (is_nullptr(m_render_buffer))
+            mco->send_seq_event(number(), what);
+        else if (mco->seq_event(number(), what, ev))
         {
-            mco->send_seq_event
+            m_render_buffer->add
             (
-                number(), p ? midi_control_out::seq_action_arm :
-                    midi_control_out::seq_action_mute
+                SEQ64_NULL_MIDIPULSE, mco->buss(), ev.get_channel(), ev
             );
         }
     }
@@ -5055,12 +5458,15 @@ sequence::set_playing (bool p)
 void
 sequence::set_recording (bool r)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
+    automutex playlocker(m_play_mutex);
     if (r != m_recording)
     {
         m_notes_on = 0;         // is there a more robust way to do this?
         m_recording = r;
-        if (! r)
+        if (r)
+            wake();
+        else
             m_quantized_rec = r;
     }
 }
@@ -5078,13 +5484,17 @@ sequence::set_recording (bool r)
 void
 sequence::set_quantized_recording (bool qr)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
+    automutex playlocker(m_play_mutex);
     if (qr != m_quantized_rec)
     {
         m_notes_on = 0;         // is there a more robust way to do this?
         m_quantized_rec = qr;
         if (qr)
+        {
             m_recording = qr;   // also need recording
+            wake();
+        }
     }
 }
 
@@ -5125,7 +5535,7 @@ sequence::set_input_recording (bool record_active, bool toggle)
 void
 sequence::set_snap_tick (int st)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     if (st > 0)
         m_snap_tick = st;
     else if (m_snap_tick == 0)
@@ -5141,7 +5551,7 @@ sequence::set_snap_tick (int st)
 void
 sequence::overwrite_recording (bool ovwr)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_overwrite_recording = ovwr;
 }
 
@@ -5154,8 +5564,11 @@ sequence::overwrite_recording (bool ovwr)
 void
 sequence::loop_reset (bool reset)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
+    automutex playlocker(m_play_mutex);
     m_loop_reset = reset;
+    if (reset)
+        invalidate_play_cursor();
 }
 
 /**
@@ -5167,7 +5580,7 @@ sequence::loop_reset (bool reset)
 void
 sequence::set_thru (bool r)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_thru = r;
 }
 
@@ -5281,14 +5694,18 @@ sequence::title () const
 void
 sequence::set_midi_channel (midibyte ch, bool user_change)
 {
-    automutex locker(m_mutex);
-    off_playing_notes();
-    if (ch != m_midi_channel)
+    edit_locker locker(*this);
+    bool changed;
     {
-        m_midi_channel = ch;
-        if (user_change)
-            modify();                   /* no easy way to undo this, though */
+        automutex playlocker(m_play_mutex);
+        off_playing_notes();
+        changed = ch != m_midi_channel;
+        if (changed)
+            m_midi_channel = ch;
     }
+    if (changed && user_change)
+        modify();                       /* no easy way to undo this, though */
+
     set_dirty();                        /* this is for display updating     */
 }
 
@@ -5320,18 +5737,25 @@ sequence::print_triggers () const
 /**
  *  Takes an event that this sequence is holding, and places it on the MIDI
  *  buss.  This function does not bother checking if m_master_bus is a null
- *  pointer.
+ *  pointer.  If a render_pool thread is playing the sequence, the event goes
+ *  into its buffer instead.
  *
  * \param ev
  *      The event to put on the buss.
  *
+ * \param tick
+ *      The absolute tick of the event, used to order the events in a render
+ *      buffer, and to schedule the event if the output is scheduled ahead
+ *      (see mastermidibase::play_at()).  Defaults to SEQ64_NULL_MIDIPULSE,
+ *      meaning the start of the frame, or now.
+ *
  * \threadsafe
  */
 
 void
-sequence::put_event_on_bus (event & ev)
+sequence::put_event_on_bus (event & ev, midipulse tick)
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     midibyte note = ev.get_note();
     bool skip = false;
     if (ev.is_note_on())
@@ -5354,16 +5778,29 @@ sequence::put_event_on_bus (event & ev)
          *      usage.
          */
 
-        m_master_bus->play(m_bus, &ev, m_midi_channel);
+        if (not_nullptr(m_render_buffer))
+            m_render_buffer->add(tick, m_bus, m_midi_channel, ev);
+        else
+            m_master_bus->play_at(m_bus, &ev, m_midi_channel, tick);
 
         // m_master_bus->flush();
     }
-    m_master_bus->flush();
+
+    /*
+     * Events of a frame are flushed once, by perform::play(), at the end of
+     * the frame.  Only an event that is played now, such as a MIDI thru
+     * event, is flushed at once.
+     */
+
+    if (is_nullptr(m_render_buffer) && is_null_midipulse(tick))
+        m_master_bus->flush();
 }
 
 /**
  *  Sends a note-off event for all active notes.  This function does not
- *  bother checking if m_master_bus is a null pointer.
+ *  bother checking if m_master_bus is a null pointer.  If the output is
+ *  scheduled ahead, the Note Offs are scheduled at m_last_tick, just after
+ *  the last frame played, so that they follow the Note Ons already queued.
  *
  * \threadsafe
  */
@@ -5371,7 +5808,7 @@ sequence::put_event_on_bus (event & ev)
 void
 sequence::off_playing_notes ()
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     event e;
     for (int x = 0; x < c_midi_notes; ++x)
     {
@@ -5379,12 +5816,22 @@ sequence::off_playing_notes ()
         {
             e.set_status(EVENT_NOTE_OFF);
             e.set_data(x, midibyte(0));               /* or is 127 better?  */
-            m_master_bus->play(m_bus, &e, m_midi_channel);
+            if (not_nullptr(m_render_buffer))
+            {
+                m_render_buffer->add
+                (
+                    SEQ64_NULL_MIDIPULSE, m_bus, m_midi_channel, e
+                );
+            }
+            else
+                m_master_bus->play_at(m_bus, &e, m_midi_channel, m_last_tick);
+
             if (m_playing_notes[x] > 0)
                 m_playing_notes[x]--;
         }
     }
-    m_master_bus->flush();
+    if (is_nullptr(m_render_buffer))
+        m_master_bus->flush();
 }
 
 /**
@@ -5417,7 +5864,7 @@ sequence::select_events
     midibyte status, midibyte cc, bool inverse
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     midibyte d0, d1;
     for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
     {
@@ -5474,7 +5921,7 @@ sequence::transpose_notes (int steps, int scale)
 {
     if (mark_selected())                            /* mark original notes  */
     {
-        automutex locker(m_mutex);
+        edit_locker locker(*this);
         event_list transposed_events;
         const int * transpose_table;
         m_events_undo.push(m_events);               /* push_undo(), no lock  */
@@ -5521,7 +5968,7 @@ sequence::transpose_notes (int steps, int scale)
 void
 sequence::push_transpose (int steps, int scale)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events_undo.push(m_events);
     transpose_notes(steps, scale);
 }
@@ -5537,7 +5984,7 @@ sequence::shift_notes (midipulse ticks)
 {
     if (mark_selected())
     {
-        automutex locker(m_mutex);
+        edit_locker locker(*this);
         event_list shifted_events;
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
@@ -5583,7 +6030,7 @@ sequence::apply_song_transpose ()
     int transpose = get_transposable() ? m_parent->get_transpose() : 0 ;
     if (transpose != 0)
     {
-        automutex locker(m_mutex);
+        edit_locker locker(*this);
         m_events_undo.push(m_events);               /* push_undo(), no lock */
         for (event_list::iterator i = m_events.begin(); i != m_events.end(); ++i)
         {
@@ -5591,6 +6038,7 @@ sequence::apply_song_transpose ()
             if (er.is_note())                       /* also aftertouch      */
                 er.transpose_note(transpose);
         }
+        m_render_dirty = true;                  /* data edited in place     */
         set_dirty();
     }
 }
@@ -5647,7 +6095,7 @@ sequence::quantize_events
     midipulse snap_tick, int divide, bool linked
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     if (divide == 0)
         return;
 
@@ -5776,7 +6224,7 @@ sequence::push_quantize
     midipulse snap_tick, int divide, bool linked
 )
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events_undo.push(m_events);
     quantize_events(status, cc, snap_tick, divide, linked);
 }
@@ -5786,7 +6234,7 @@ sequence::push_quantize
 void
 sequence::multiply_pattern (double multiplier)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events_undo.push(m_events);               /* push_undo(), no lock */
     midipulse orig_length = get_length();
     midipulse new_length = midipulse(orig_length * multiplier);
@@ -5864,7 +6312,7 @@ sequence::show_events () const
 void
 sequence::copy_events (const event_list & newevents)
 {
-    automutex locker(m_mutex);
+    edit_locker locker(*this);
     m_events.clear();
     m_events = newevents;
     if (m_events.empty())
@@ -5929,6 +6377,7 @@ sequence::set_parent (perform * p)
 void
 sequence::play_queue (midipulse tick, bool playbackmode, bool resumenoteons)
 {
+    automutex locker(m_play_mutex);
     if (check_queued_tick(tick))
     {
         play(get_queued_tick() - 1, playbackmode, resumenoteons);
@@ -5943,6 +6392,72 @@ sequence::play_queue (midipulse tick, bool playbackmode, bool resumenoteons)
     play(tick, playbackmode, resumenoteons);
 }
 
+/**
+ *  A version of play_queue() for a render_pool thread.  The events (and any
+ *  tempo changes) are added to the given buffer, not sent to the master
+ *  bus.  The playback mutex is held throughout, so that no other thread,
+ *  stopping this sequence, say, can send its Note Offs into the buffer.
+ *
+ * \param tick
+ *      Provides the current active pulse position.
+ *
+ * \param playbackmode
+ *      If true, we are in Song mode.  Otherwise, Live mode.
+ *
+ * \param resumenoteons
+ *      Indicates if we are to resume Note Ons.
+ *
+ * \param buffer
+ *      The buffer of the calling thread.
+ */
+
+void
+sequence::play_queue
+(
+    midipulse tick, bool playbackmode, bool resumenoteons,
+    render_buffer & buffer
+)
+{
+    automutex locker(m_play_mutex);
+    m_render_buffer = &buffer;
+    play_queue(tick, playbackmode, resumenoteons);
+    m_render_buffer = nullptr;
+}
+
+/**
+ *  Tries to lock the playback mutex for the JACK engine, without waiting,
+ *  and sends what the sequence plays to the given buffer until
+ *  unlock_play().  The mutex is recursive, so the functions called in the
+ *  meantime take it at once.  See perform::engine_lock().
+ *
+ * \param rb
+ *      The render buffer of the engine.
+ *
+ * \return
+ *      Returns false if another thread holds the mutex.
+ */
+
+bool
+sequence::try_lock_play (render_buffer * rb)
+{
+    bool result = m_play_mutex.try_lock();
+    if (result)
+        m_render_buffer = rb;
+
+    return result;
+}
+
+/**
+ *  Undoes a successful try_lock_play().
+ */
+
+void
+sequence::unlock_play ()
+{
+    m_render_buffer = nullptr;
+    m_play_mutex.unlock();
+}
+
 /**
  *  Actually, useful mainly for the user-interface, this function calculates
  *  the size of the left and right handles of a note.  The s_handlesize value
@@ -5983,11 +6498,12 @@ sequence::handle_size (midipulse start, midipulse finish)
 void
 sequence::toggle_one_shot ()
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     set_dirty_mp();
     m_one_shot = ! m_one_shot;
-    m_one_shot_tick = m_last_tick - mod_last_tick() + m_length;
+    m_one_shot_tick = last_tick() - mod_last_tick() + m_length;
     m_off_from_snap = true;
+    wake();
 }
 
 /**
@@ -5998,7 +6514,7 @@ sequence::toggle_one_shot ()
 void
 sequence::off_one_shot ()
 {
-    automutex locker(m_mutex);
+    automutex locker(m_play_mutex);
     set_dirty_mp();
     m_one_shot = false;
     m_off_from_snap = true;
@@ -6020,9 +6536,12 @@ sequence::off_one_shot ()
 void
 sequence::song_recording_start (midipulse tick)
 {
+    edit_locker locker(*this);
+    automutex playlocker(m_play_mutex);
     add_trigger(tick, SEQ64_SONG_RECORD_INC);
     m_song_record_tick = tick;
     m_song_recording = true;
+    wake();
 
     /*
      * Do we need to add this setting?
@@ -6047,12 +6566,32 @@ sequence::song_recording_start (midipulse tick)
 void
 sequence::song_recording_stop (midipulse tick)
 {
+    edit_locker locker(*this);
+    automutex playlocker(m_play_mutex);
     midipulse len = m_length - (tick % m_length);
     m_song_playback_block = m_song_recording = false;
     m_triggers.grow(m_song_record_tick, tick, len);
     m_off_from_snap = true;
 }
 
+/**
+ *  Grows the trigger of Song recording up to the given tick.  In engine
+ *  mode, sequence::play() runs in the JACK process callback, which must not
+ *  allocate, so the output thread calls this function instead (see
+ *  perform::engine_follow()).
+ *
+ * \param tick
+ *      Provides the current tick.
+ */
+
+void
+sequence::song_recording_grow (midipulse tick)
+{
+    edit_locker locker(*this);
+    if (m_song_recording)
+        m_triggers.grow(m_song_record_tick, tick, SEQ64_SONG_RECORD_INC);
+}
+
 /**
  *  If the Note-On event is after the Note-Off event, the pattern wraps around,
  *  so that we play it now to resume.
@@ -6064,22 +6603,21 @@ sequence::song_recording_stop (midipulse tick)
 void
 sequence::resume_note_ons (midipulse tick)
 {
-    for         /* would like a const_iterator, but put_event_on_bus()...   */
-    (
-        event_list::iterator ei = m_events.begin(); ei != m_events.end(); ++ei
-    )
+    automutex locker(m_play_mutex);
+    const render_list & rl = render_events();
+    midipulse remainder = tick % m_length;
+    for (int n = 0; n < rl.note_on_count(); ++n)
     {
-        if (ei->is_note_on())
+        int i = rl.note_on(n);
+        midipulse on = rl.timestamp(i);                 /* see banner notes */
+        midipulse off = rl.note_off_time(n);
+        if (on < remainder && off > remainder)
         {
-            event * link = ei->get_linked();
-            if (not_nullptr(link))
-            {
-                midipulse on = ei->get_timestamp();      /* see banner notes */
-                midipulse off = link->get_timestamp();
-                midipulse remainder = tick % m_length;
-                if (on < remainder && off > remainder)
-                    put_event_on_bus(*ei);
-            }
+            event ev;
+            ev.set_timestamp(on);
+            ev.set_status(rl.status(i));
+            ev.set_data(rl.d0(i), rl.d1(i));
+            put_event_on_bus(ev, tick);
         }
     }
 }
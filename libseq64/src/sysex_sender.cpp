@@ -0,0 +1,282 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          sysex_sender.cpp
+ *
+ *  This module defines a background sender of SysEx messages.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ */
+
+#include "daemonize.hpp"                /* seq64::microsleep()              */
+#include "midibase.hpp"                 /* seq64::midibase                  */
+#include "settings.hpp"                 /* seq64::rc()                      */
+#include "sysex_sender.hpp"             /* seq64::sysex_sender              */
+#include "tick_clock.hpp"               /* seq64::tick_clock::now_us()      */
+
+/**
+ *  The longest the sender thread sleeps at one time, in microseconds, so
+ *  that a message queued for an idle buss, or a stop(), is not held up by
+ *  the pacing of a slow buss.
+ */
+
+#define SEQ64_SYSEX_SLEEP_US_MAX        10000
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ * \defaultctor
+ *      The thread is not started until there is something to send.
+ */
+
+sysex_sender::sysex_sender ()
+ :
+    m_outboxes  (),
+    m_cond      (),
+    m_thread    (),
+    m_launched  (false),
+    m_stop      (false)
+{
+    // Empty body
+}
+
+/**
+ *  Stops the sender thread.
+ */
+
+sysex_sender::~sysex_sender ()
+{
+    stop();
+}
+
+/**
+ *  Queues a SysEx message for an output buss, starting the sender thread if
+ *  need be.  The message is copied, so the caller can reuse the event.
+ *
+ * \threadsafe
+ *
+ * \param bus
+ *      The output buss.  It must outlive the queued messages; see stop().
+ *
+ * \param ev
+ *      The SysEx event to send.  An event without SysEx data is ignored.
+ */
+
+void
+sysex_sender::send (midibase * bus, const event & ev)
+{
+    if (is_nullptr(bus) || ev.get_sysex_size() == 0)
+        return;
+
+    automutex locker(m_cond);
+    if (m_stop)
+        return;
+
+    std::vector<outbox>::iterator ob;
+    for (ob = m_outboxes.begin(); ob != m_outboxes.end(); ++ob)
+    {
+        if (ob->ob_bus == bus)
+            break;
+    }
+    if (ob == m_outboxes.end())
+    {
+        outbox box;
+        box.ob_bus = bus;
+        box.ob_offset = 0;
+        box.ob_due_us = 0;
+        m_outboxes.push_back(box);
+        ob = m_outboxes.end() - 1;
+    }
+    ob->ob_messages.push_back(ev.get_sysex());
+    if (! m_launched)
+    {
+        int err = pthread_create(&m_thread, NULL, sender_func, this);
+        if (err == 0)
+        {
+            m_launched = true;
+        }
+        else
+        {
+            errprint("sysex_sender: could not create the sender thread");
+        }
+    }
+    m_cond.signal();
+}
+
+/**
+ *  Drops the messages not yet sent, and stops and joins the sender thread.
+ *  Must be called before the busses are destroyed.  Once stopped, the
+ *  sender ignores send().
+ */
+
+void
+sysex_sender::stop ()
+{
+    m_cond.lock();
+    m_stop = true;
+    m_outboxes.clear();
+    m_cond.signal();
+    m_cond.unlock();
+    if (m_launched)
+    {
+        pthread_join(m_thread, NULL);
+        m_launched = false;
+    }
+}
+
+/**
+ *  The thread function of the sender.
+ *
+ * \param mysender
+ *      The sysex_sender that owns the thread.
+ *
+ * \return
+ *      Always returns nullptr.
+ */
+
+void *
+sysex_sender::sender_func (void * mysender)
+{
+    sysex_sender * s = static_cast<sysex_sender *>(mysender);
+    s->work();
+    return nullptr;
+}
+
+/**
+ *  Takes the next piece that is due to go out, if any.  The caller holds
+ *  the lock.  A piece is as big as the buss takes at a time (see
+ *  midibase::sysex_chunk()), or is the whole message.  Each buss is
+ *  paced on its own: after a piece of n bytes, the buss gets no more until
+ *  n bytes' worth of time has gone by at the "rc" SysEx rate.
+ *
+ * \param now_us
+ *      The current monotonic time, in microseconds.
+ *
+ * \param piece
+ *      Gets the bytes of the piece, if one is due.
+ *
+ * \param [out] due_us
+ *      Gets the time at which the next piece is due, if no piece is due
+ *      now, or 0 if there is nothing left to send.
+ *
+ * \return
+ *      Returns the buss on which to send the piece, or a null pointer if no
+ *      piece is due now.
+ */
+
+midibase *
+sysex_sender::next_piece (long long now_us, event & piece, long long & due_us)
+{
+    due_us = 0;
+    std::vector<outbox>::iterator ob;
+    for (ob = m_outboxes.begin(); ob != m_outboxes.end(); ++ob)
+    {
+        if (ob->ob_messages.empty())
+            continue;
+
+        if (ob->ob_due_us <= now_us)
+        {
+            const event::SysexContainer & msg = ob->ob_messages.front();
+            int chunk = ob->ob_bus->sysex_chunk();
+            int count = int(msg.size()) - ob->ob_offset;
+            if (chunk > 0 && count > chunk)
+                count = chunk;
+
+            piece.restart_sysex();
+            piece.append_sysex(&msg[ob->ob_offset], count);
+            ob->ob_offset += count;
+            if (ob->ob_offset >= int(msg.size()))
+            {
+                ob->ob_messages.pop_front();
+                ob->ob_offset = 0;
+            }
+            if (ob->ob_due_us < now_us)
+                ob->ob_due_us = now_us;
+
+            ob->ob_due_us += count * 1000000LL / rc().sysex_rate();
+            return ob->ob_bus;
+        }
+        if (due_us == 0 || ob->ob_due_us < due_us)
+            due_us = ob->ob_due_us;
+    }
+    return nullptr;
+}
+
+/**
+ *  The loop of the sender thread.  It sends each piece that is due, with the
+ *  lock released, so that send() is never held up by a buss.  Otherwise it
+ *  sleeps until the next piece is due, or waits for send() if there is
+ *  nothing to send.
+ */
+
+void
+sysex_sender::work ()
+{
+    event piece;
+    piece.set_status(EVENT_MIDI_SYSEX);
+    for (;;)
+    {
+        long long due_us = 0;
+        long long now_us = tick_clock::now_us();
+        m_cond.lock();
+        midibase * bus = m_stop ? nullptr : next_piece(now_us, piece, due_us);
+        if (is_nullptr(bus) && due_us == 0 && ! m_stop)
+        {
+            m_cond.wait();                      /* nothing queued           */
+            m_cond.unlock();
+            continue;
+        }
+        bool stopping = m_stop;
+        m_cond.unlock();
+        if (stopping)
+            break;
+
+        if (not_nullptr(bus))
+        {
+            bus->sysex(&piece);
+        }
+        else
+        {
+            long long us = due_us - now_us;
+            if (us > SEQ64_SYSEX_SLEEP_US_MAX)
+                us = SEQ64_SYSEX_SLEEP_US_MAX;
+
+            (void) microsleep(int(us));
+        }
+    }
+}
+
+}           // namespace seq64
+
+/*
+ * sysex_sender.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -0,0 +1,457 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tempo_map.cpp
+ *
+ *  This module defines a map of the tempo and time-signature changes of a
+ *  song, for converting between ticks and time.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ */
+
+#include <algorithm>                    /* std::stable_sort()               */
+#include <cstdio>                       /* std::snprintf()                  */
+
+#include "app_limits.h"                 /* SEQ64_DEFAULT_BPM, etc.          */
+#include "calculations.hpp"             /* beat_pow2(), etc.                */
+#include "event_list.hpp"               /* seq64::event_list                */
+#include "tempo_map.hpp"                /* seq64::tempo_map                 */
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ * \defaultctor
+ *      The map starts out with the default PPQN, tempo, and 4/4 time, and no
+ *      changes.
+ */
+
+tempo_map::tempo_map ()
+ :
+    m_mutex                 (),
+    m_changes               (),
+    m_segments              (),
+    m_ppqn                  (SEQ64_DEFAULT_PPQN),
+    m_bpm                   (SEQ64_DEFAULT_BPM),
+    m_beats_per_bar         (SEQ64_DEFAULT_BEATS_PER_MEASURE),
+    m_beat_width            (SEQ64_DEFAULT_BEAT_WIDTH),
+    m_has_tempo             (false),
+    m_has_time_signature    (false)
+{
+    compute();
+}
+
+/**
+ *  Sets the values in force before the first change, and rebuilds the
+ *  segments.
+ *
+ * \threadsafe
+ *
+ * \param ppqn
+ *      The PPQN of the song.
+ *
+ * \param bpm
+ *      The tempo in force before the first tempo change.
+ *
+ * \param beatsperbar
+ *      The numerator in force before the first time-signature change.
+ *
+ * \param beatwidth
+ *      The denominator in force before the first time-signature change.
+ */
+
+void
+tempo_map::defaults (int ppqn, midibpm bpm, int beatsperbar, int beatwidth)
+{
+    automutex locker(m_mutex);
+    if (ppqn > 0)
+        m_ppqn = ppqn;
+
+    if (bpm > 0.0)
+        m_bpm = bpm;
+
+    if (beatsperbar > 0 && beatwidth > 0)
+    {
+        m_beats_per_bar = beatsperbar;
+        m_beat_width = beatwidth;
+    }
+    compute();
+}
+
+/**
+ *  Rebuilds the map from the tempo and time-signature events of the given
+ *  events, normally those of the tempo track.  The caller holds the lock of
+ *  the sequence that owns the events.
+ *
+ * \threadsafe
+ *
+ * \param events
+ *      The events to scan.  Events that are neither tempo nor time
+ *      signature are skipped.
+ */
+
+void
+tempo_map::build (const event_list & events)
+{
+    automutex locker(m_mutex);
+    m_changes.clear();
+    m_has_tempo = m_has_time_signature = false;
+    for (event_list::const_iterator i = events.begin(); i != events.end(); ++i)
+    {
+        const event & e = event_list::dref(i);
+        change c;
+        c.tc_tick = e.get_timestamp();
+        c.tc_bpm = 0.0;
+        c.tc_beats_per_bar = c.tc_beat_width = 0;
+        if (e.is_tempo())
+        {
+            c.tc_bpm = e.tempo();
+            if (c.tc_bpm > 0.0)
+            {
+                m_changes.push_back(c);
+                m_has_tempo = true;
+            }
+        }
+        else if (e.is_time_signature() && e.get_sysex_size() >= 2)
+        {
+            c.tc_beats_per_bar = int(e.get_sysex()[0]);
+            c.tc_beat_width = beat_pow2(int(e.get_sysex()[1]));
+            if (c.tc_beats_per_bar > 0 && c.tc_beat_width > 0)
+            {
+                m_changes.push_back(c);
+                m_has_time_signature = true;
+            }
+        }
+    }
+    std::stable_sort(m_changes.begin(), m_changes.end());
+    compute();
+}
+
+/**
+ *  Drops the changes, for a song that has no tempo track, so that only the
+ *  defaults are left.
+ *
+ * \threadsafe
+ */
+
+void
+tempo_map::clear ()
+{
+    automutex locker(m_mutex);
+    m_changes.clear();
+    m_has_tempo = m_has_time_signature = false;
+    compute();
+}
+
+/**
+ *  Follows a change of the tempo made by the user, if the tempo track has
+ *  no tempo change to follow instead.
+ *
+ * \threadsafe
+ *
+ * \param bpm
+ *      The new tempo.
+ */
+
+void
+tempo_map::default_bpm (midibpm bpm)
+{
+    automutex locker(m_mutex);
+    if (! m_has_tempo && bpm > 0.0 && bpm != m_bpm)
+    {
+        m_bpm = bpm;
+        compute();
+    }
+}
+
+/**
+ *  Follows a change of the time signature made by the user, if the tempo
+ *  track has no time-signature change to follow instead.
+ *
+ * \threadsafe
+ *
+ * \param beatsperbar
+ *      The new numerator.
+ *
+ * \param beatwidth
+ *      The new denominator.
+ */
+
+void
+tempo_map::default_time_signature (int beatsperbar, int beatwidth)
+{
+    automutex locker(m_mutex);
+    if (! m_has_time_signature && beatsperbar > 0 && beatwidth > 0)
+    {
+        m_beats_per_bar = beatsperbar;
+        m_beat_width = beatwidth;
+        compute();
+    }
+}
+
+/**
+ *  Builds the segments from the defaults and the changes, with the running
+ *  sums of the time and of the bars at the start of each segment.  A time
+ *  signature that changes in the middle of a bar starts a new bar.  The
+ *  caller holds the lock.
+ */
+
+void
+tempo_map::compute ()
+{
+    segment s;
+    s.ts_tick = 0;
+    s.ts_us = 0.0;
+    s.ts_bpm = m_bpm;
+    s.ts_us_per_tick = 60000000.0 / (m_bpm * m_ppqn);
+    s.ts_beats_per_bar = m_beats_per_bar;
+    s.ts_beat_width = m_beat_width;
+    s.ts_bar_tick = 0;
+    s.ts_bar = 0;
+    m_segments.clear();
+    m_segments.push_back(s);
+    for (size_t i = 0; i < m_changes.size(); ++i)
+    {
+        const change & c = m_changes[i];
+        segment & last = m_segments.back();
+        midipulse tick = c.tc_tick > 0 ? c.tc_tick : 0;
+        if (tick > last.ts_tick)
+        {
+            s = last;
+            s.ts_tick = tick;
+            s.ts_us = last.ts_us + (tick - last.ts_tick) * last.ts_us_per_tick;
+            m_segments.push_back(s);
+        }
+
+        segment & seg = m_segments.back();
+        if (c.tc_bpm > 0.0)
+        {
+            seg.ts_bpm = c.tc_bpm;
+            seg.ts_us_per_tick = 60000000.0 / (c.tc_bpm * m_ppqn);
+        }
+        else
+        {
+            midipulse barticks = 4 * m_ppqn * seg.ts_beats_per_bar /
+                seg.ts_beat_width;
+
+            midipulse span = tick - seg.ts_bar_tick;
+            if (barticks > 0 && span > 0)
+                seg.ts_bar += int((span + barticks - 1) / barticks);
+
+            seg.ts_bar_tick = tick;
+            seg.ts_beats_per_bar = c.tc_beats_per_bar;
+            seg.ts_beat_width = c.tc_beat_width;
+        }
+    }
+}
+
+/**
+ *  Finds the segment that holds the given tick.  The caller holds the lock.
+ *
+ * \param tick
+ *      The tick to look up.  A negative tick falls into the first segment.
+ *
+ * \return
+ *      Returns the index of the last segment that starts at or before the
+ *      tick.
+ */
+
+int
+tempo_map::find_tick (midipulse tick) const
+{
+    int lo = 0;
+    int hi = int(m_segments.size()) - 1;
+    while (lo < hi)
+    {
+        int mid = (lo + hi + 1) / 2;
+        if (m_segments[mid].ts_tick <= tick)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+/**
+ * \threadsafe
+ *
+ * \param tick
+ *      The tick to convert.
+ *
+ * \return
+ *      Returns the time of the tick from the start of the song, in
+ *      microseconds.
+ */
+
+double
+tempo_map::tick_to_us (midipulse tick) const
+{
+    automutex locker(m_mutex);
+    const segment & s = m_segments[find_tick(tick)];
+    return s.ts_us + (tick - s.ts_tick) * s.ts_us_per_tick;
+}
+
+/**
+ * \threadsafe
+ *
+ * \param us
+ *      The time from the start of the song, in microseconds.
+ *
+ * \return
+ *      Returns the tick at that time, rounded down.
+ */
+
+midipulse
+tempo_map::us_to_tick (double us) const
+{
+    automutex locker(m_mutex);
+    int lo = 0;
+    int hi = int(m_segments.size()) - 1;
+    while (lo < hi)
+    {
+        int mid = (lo + hi + 1) / 2;
+        if (m_segments[mid].ts_us <= us)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    const segment & s = m_segments[lo];
+    return s.ts_tick + midipulse((us - s.ts_us) / s.ts_us_per_tick);
+}
+
+/**
+ * \threadsafe
+ *
+ * \param tick
+ *      The tick to look up.
+ *
+ * \return
+ *      Returns the tempo in force at the tick.
+ */
+
+midibpm
+tempo_map::bpm_at (midipulse tick) const
+{
+    automutex locker(m_mutex);
+    return m_segments[find_tick(tick)].ts_bpm;
+}
+
+/**
+ *  Converts a tick to measures, beats, and divisions, following the time
+ *  signatures in force, as pulses_to_midi_measures() does for one time
+ *  signature.
+ *
+ * \threadsafe
+ *
+ * \param tick
+ *      The tick to convert.  A negative tick is treated as 0.
+ *
+ * \param [out] measures
+ *      Gets the measures and beats, re 1, and the leftover ticks.
+ *
+ * \return
+ *      Returns true if the time signature in force is usable.
+ */
+
+bool
+tempo_map::tick_to_measures (midipulse tick, midi_measures & measures) const
+{
+    automutex locker(m_mutex);
+    if (tick < 0)
+        tick = 0;
+
+    const segment & s = m_segments[find_tick(tick)];
+    midipulse beatticks = 4 * m_ppqn / s.ts_beat_width;
+    midipulse barticks = beatticks * s.ts_beats_per_bar;
+    bool result = beatticks > 0 && barticks > 0;
+    if (result)
+    {
+        midipulse span = tick - s.ts_bar_tick;
+        midipulse rest = span % barticks;
+        measures.measures(s.ts_bar + int(span / barticks) + 1);
+        measures.beats(int(rest / beatticks) + 1);
+        measures.divisions(int(rest % beatticks));
+    }
+    return result;
+}
+
+/**
+ * \threadsafe
+ *
+ * \param tick
+ *      The tick to convert.
+ *
+ * \return
+ *      Returns the tick as "measures:beats:divisions", in the format of
+ *      pulses_to_measurestring().
+ */
+
+std::string
+tempo_map::measure_string (midipulse tick) const
+{
+    midi_measures measures;
+    char tmp[32];
+    (void) tick_to_measures(tick, measures);
+    snprintf
+    (
+        tmp, sizeof tmp, "%03d:%d:%03d",
+        measures.measures(), measures.beats(), measures.divisions()
+    );
+    return std::string(tmp);
+}
+
+/**
+ * \threadsafe
+ *
+ * \param tick
+ *      The tick to convert.
+ *
+ * \param showus
+ *      If true (the default), shows the microseconds as well.
+ *
+ * \return
+ *      Returns the time of the tick as "hours:minutes:seconds", in the format
+ *      of pulses_to_timestring().
+ */
+
+std::string
+tempo_map::time_string (midipulse tick, bool showus) const
+{
+    double us = tick_to_us(tick > 0 ? tick : 0);
+    return microseconds_to_timestring((unsigned long)(us), showus);
+}
+
+}           // namespace seq64
+
+/*
+ * tempo_map.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -0,0 +1,151 @@
+/*
+ *  This file is part of seq24/sequencer64.
+ *
+ *  seq24 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  seq24 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with seq24; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file          tick_clock.cpp
+ *
+ *  This module defines a map from the time of the monotonic clock to the
+ *  tick of the performance.
+ *
+ * \library       sequencer64 application
+ * \author        Chris Ahlstrom
+ * \date          2026-10-17
+ * \updates       2026-10-17
+ * \license       GNU GPLv2 or above
+ *
+ */
+
+#include <cmath>                        /* std::floor()                     */
+
+#include "platform_macros.h"            /* PLATFORM_LINUX, etc.             */
+#include "tick_clock.hpp"               /* seq64::tick_clock                */
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>                    /* QueryPerformanceCounter()        */
+#else
+#include <time.h>                       /* clock_gettime()                  */
+#endif
+
+/*
+ *  Do not document a namespace; it breaks Doxygen.
+ */
+
+namespace seq64
+{
+
+/**
+ * \defaultctor
+ */
+
+tick_clock::tick_clock ()
+ :
+    m_marks     (),
+    m_next      (0),
+    m_count     (0)
+{
+    // Empty body
+}
+
+/**
+ *  Gets the time of the monotonic clock, which, unlike the wall clock, does
+ *  not jump when the wall clock is adjusted.
+ *
+ * \return
+ *      Returns the current time in microseconds.
+ */
+
+long long
+tick_clock::now_us ()
+{
+#ifdef PLATFORM_WINDOWS
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (long long)(count.QuadPart * 1000000.0 / frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000LL + now.tv_nsec / 1000;
+#endif
+}
+
+/**
+ *  Notes the tick of the performance at the given time, and the tempo from
+ *  then on.  The oldest mark is dropped if the ring is full.
+ *
+ * \param tick
+ *      The current tick.
+ *
+ * \param bpm
+ *      The current tempo.
+ *
+ * \param ppqn
+ *      The current PPQN.
+ *
+ * \param us
+ *      The time of the mark, normally now_us().
+ */
+
+void
+tick_clock::set_mark (midipulse tick, midibpm bpm, int ppqn, long long us)
+{
+    mark & m = m_marks[m_next];
+    m.tm_us = us;
+    m.tm_tick = tick;
+    m.tm_ticks_per_us = bpm * ppqn / 60000000.0;
+    m_next = (m_next + 1) % SEQ64_TICK_CLOCK_MARKS;
+    if (m_count < SEQ64_TICK_CLOCK_MARKS)
+        ++m_count;
+}
+
+/**
+ *  Gets the tick of the performance at the given time.  The latest mark at
+ *  or before that time is used.  A time earlier than all of the marks is
+ *  mapped back from the oldest one.
+ *
+ * \param us
+ *      The monotonic time, in microseconds.
+ *
+ * \return
+ *      Returns the tick, or SEQ64_NULL_MIDIPULSE if there is no mark yet.
+ */
+
+midipulse
+tick_clock::tick_at (long long us) const
+{
+    if (m_count == 0)
+        return SEQ64_NULL_MIDIPULSE;
+
+    int last = SEQ64_TICK_CLOCK_MARKS - 1;
+    int index = (m_next + last) % SEQ64_TICK_CLOCK_MARKS;
+    for (int i = 1; i < m_count && m_marks[index].tm_us > us; ++i)
+        index = (index + last) % SEQ64_TICK_CLOCK_MARKS;
+
+    const mark & m = m_marks[index];
+    double ticks = (us - m.tm_us) * m.tm_ticks_per_us;
+    return m.tm_tick + midipulse(std::floor(ticks));
+}
+
+}           // namespace seq64
+
+/*
+ * tick_clock.cpp
+ *
+ * vim: sw=4 ts=4 wm=4 et ft=cpp
+ */
+
@@ -59,6 +59,7 @@
  */
 
 #include <stdlib.h>
+#include <algorithm>                    /* std::lower_bound(), etc.     */
 
 #include "sequence.hpp"                 /* the "parent" of the triggers */
 #include "settings.hpp"                 /* seq64::rc() settings access  */
@@ -87,8 +88,15 @@ triggers::triggers (sequence & parent)
     m_clipboard                 (),
     m_undo_stack                (),
     m_redo_stack                (),
-    m_iterator_play_trigger     (),
+    m_index                     (),
+    m_index_dirty               (true),
+    m_index_ordered             (false),
+    m_play_index                (),
+    m_play_dirty                (true),
+    m_play_current              (),
+    m_play_cursor               (0),
     m_iterator_draw_trigger     (),
+    m_draw_limit                (SEQ64_NULL_MIDIPULSE),
     m_trigger_copied            (false),
     m_paste_tick                (SEQ64_NO_PASTE_TRIGGER),   // stazed
     m_ppqn                      (0),
@@ -135,7 +143,7 @@ triggers::operator = (const triggers & rhs)
         m_clipboard = rhs.m_clipboard;
         m_undo_stack = rhs.m_undo_stack;
         m_redo_stack = rhs.m_redo_stack;
-        m_iterator_play_trigger = rhs.m_iterator_play_trigger;
+        list_changed();
         m_iterator_draw_trigger = rhs.m_iterator_draw_trigger;
         m_trigger_copied = rhs.m_trigger_copied;
         m_ppqn = rhs.m_ppqn;
@@ -177,6 +185,7 @@ triggers::pop_undo ()
         m_redo_stack.push(m_triggers);
         m_triggers = m_undo_stack.top();
         m_undo_stack.pop();
+        list_changed();
     }
 }
 
@@ -194,9 +203,121 @@ triggers::pop_redo ()
         m_undo_stack.push(m_triggers);
         m_triggers = m_redo_stack.top();
         m_redo_stack.pop();
+        list_changed();
     }
 }
 
+/**
+ *  Publishes a copy of the trigger index for the output thread, if the
+ *  trigger list has changed since the last publication.  Called by the
+ *  sequence, with its edit lock held, when an edit is done (see
+ *  sequence::publish()).
+ */
+
+void
+triggers::publish ()
+{
+    if (m_play_dirty)
+    {
+        m_play_dirty = false;
+        (void) index();
+
+        std::shared_ptr<play_index> pi = std::make_shared<play_index>();
+        pi->pi_spans = m_index;
+        pi->pi_ordered = m_index_ordered;
+        m_play_index.publish(pi);
+    }
+}
+
+/**
+ *  Rebuilds the trigger index, if the trigger list has changed since the
+ *  last rebuild.  The storage of the index is kept.
+ *
+ * \return
+ *      Returns true if the triggers are in order (see m_index_ordered), so
+ *      that the index can be searched.
+ */
+
+bool
+triggers::index () const
+{
+    if (m_index_dirty)
+    {
+        /*
+         * The index only reads the list, but it holds iterators that the
+         * non-const drawing functions use.
+         */
+
+        List & tl = const_cast<List &>(m_triggers);
+        m_index_dirty = false;
+        m_index_ordered = true;
+        m_index.clear();
+        for (List::iterator i = tl.begin(); i != tl.end(); ++i)
+        {
+            span ts;
+            ts.ts_start = i->tick_start();
+            ts.ts_end = i->tick_end();
+            ts.ts_offset = i->offset();
+            ts.ts_trigger = i;
+            if (ts.ts_end < ts.ts_start)
+                m_index_ordered = false;
+            else if (! m_index.empty())
+            {
+                const span & prev = m_index.back();
+                if (ts.ts_start < prev.ts_start || ts.ts_end < prev.ts_end)
+                    m_index_ordered = false;
+            }
+            m_index.push_back(ts);
+        }
+    }
+    return m_index_ordered;
+}
+
+/**
+ *  Finds the first trigger, in an ordered index, that has not ended by the
+ *  given tick.
+ *
+ * \param spans
+ *      The index to search, m_index or a published one.
+ *
+ * \param tick
+ *      The tick to look for.
+ *
+ * \param after
+ *      If true, find the first trigger ending after \a tick.  Otherwise, find
+ *      the first trigger ending at or after \a tick.
+ *
+ * \return
+ *      Returns the index of the trigger, or the size of the index if there
+ *      is none.
+ */
+
+int
+triggers::find_end
+(
+    const std::vector<span> & spans, midipulse tick, bool after
+)
+{
+    std::vector<span>::const_iterator t;
+    if (after)
+    {
+        t = std::upper_bound
+        (
+            spans.begin(), spans.end(), tick,
+            [] (midipulse p, const span & ts) { return p < ts.ts_end; }
+        );
+    }
+    else
+    {
+        t = std::lower_bound
+        (
+            spans.begin(), spans.end(), tick,
+            [] (const span & ts, midipulse p) { return ts.ts_end < p; }
+        );
+    }
+    return int(t - spans.begin());
+}
+
 /**
  *  If playback-mode (song mode) is in force, that is, if using in-triggers
  *  and on/off triggers, this function handles that kind of playback.
@@ -223,6 +344,15 @@ triggers::pop_redo ()
  *  If the trigger state has changed, then the start/end ticks are passed back
  *  to the sequence, and the trigger offset is adjusted.
  *
+ *  When the trigger list is in order, as it normally is, the triggers are
+ *  not walked.  The same result is found in the trigger index, starting from
+ *  where the previous frame left off, or by binary search if the frame is
+ *  not near it.
+ *
+ *  This function runs on the output thread, and reads only the index last
+ *  published by publish(), never the trigger list, so that it needs no lock
+ *  against the editors.  A newly published index restarts the search.
+ *
  * \param start_tick
  *      Provides the starting tick value, and returns the modified value as a
  *      side-effect.
@@ -252,28 +382,85 @@ triggers::play
     midipulse trigger_offset = 0;
     midipulse trigger_tick = 0;
     bool trigger_state = false;
-    for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    std::shared_ptr<const play_index> pi = m_play_index.load();
+    const std::vector<span> & spans = pi->pi_spans;
+    int n = int(spans.size());
+    if (pi != m_play_current)
     {
-        if (i->at_trigger_transition(start_tick, end_tick))
-            m_parent.song_playback_block(false);
+        m_play_current = pi;                /* the old one is freed later   */
+        m_play_cursor = n + 1;              /* forces a search              */
+    }
+    if (pi->pi_ordered)
+    {
+        /*
+         * All triggers before k have ended by the end of the frame, and the
+         * last of them sets the state, unless trigger k has started.  Only
+         * the triggers that have not ended before the frame can be at a
+         * transition.
+         */
+
+        int k = m_play_cursor;
+        if (k > n || (k > 0 && spans[k - 1].ts_end > end_tick))
+            k = find_end(spans, end_tick, true);    /* went backward    */
+        else
+        {
+            int steps = 0;
+            while (k < n && spans[k].ts_end <= end_tick)
+            {
+                if (++steps > 2)
+                {
+                    k = find_end(spans, end_tick, true);    /* jumped   */
+                    break;
+                }
+                ++k;
+            }
+        }
+        m_play_cursor = k;
 
-        midipulse trigstart = i->tick_start();
-        midipulse trigend = i->tick_end();
-        midipulse trigoffset = i->offset();
-        if (trigstart <= end_tick)
+        midipulse lowtick = start_tick < end_tick ? start_tick : end_tick ;
+        int last = k < n ? k : n - 1 ;
+        for (int i = find_end(spans, lowtick, false); i <= last; ++i)
+        {
+            if (at_transition(spans[i], start_tick, end_tick))
+                m_parent.song_playback_block(false);
+        }
+        if (k < n && spans[k].ts_start <= end_tick)
         {
             trigger_state = true;
-            trigger_tick = trigstart;
-            trigger_offset = trigoffset;
+            trigger_tick = spans[k].ts_start;
+            trigger_offset = spans[k].ts_offset;
         }
-        if (trigend <= end_tick)
+        else if (k > 0)
         {
-            trigger_state = false;
-            trigger_tick = trigend;
-            trigger_offset = trigoffset;
+            trigger_tick = spans[k - 1].ts_end;
+            trigger_offset = spans[k - 1].ts_offset;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            if (at_transition(spans[i], start_tick, end_tick))
+                m_parent.song_playback_block(false);
+
+            midipulse trigstart = spans[i].ts_start;
+            midipulse trigend = spans[i].ts_end;
+            midipulse trigoffset = spans[i].ts_offset;
+            if (trigstart <= end_tick)
+            {
+                trigger_state = true;
+                trigger_tick = trigstart;
+                trigger_offset = trigoffset;
+            }
+            if (trigend <= end_tick)
+            {
+                trigger_state = false;
+                trigger_tick = trigend;
+                trigger_offset = trigoffset;
+            }
+            if (trigstart > end_tick || trigend > end_tick)
+                break;
         }
-        if (trigstart > end_tick || trigend > end_tick)
-            break;
     }
 
     /*
@@ -311,7 +498,7 @@ triggers::play
         }
     }
 
-    bool offplay = m_triggers.size() == 0 && m_parent.get_playing();
+    bool offplay = n == 0 && m_parent.get_playing();
     if (offplay)
         offplay = ! m_parent.song_playback_block();
 
@@ -431,6 +618,7 @@ triggers::add
     }
     m_triggers.push_front(t);
     m_triggers.sort();                          /* hmmm, another sort       */
+    list_changed();
 }
 
 /**
@@ -459,6 +647,19 @@ triggers::add
 bool
 triggers::intersect (midipulse position, midipulse & start, midipulse & ender)
 {
+    if (index())
+    {
+        int i = find_end(m_index, position, false);
+        bool result = i < int(m_index.size()) &&
+            m_index[i].ts_start <= position;
+
+        if (result)
+        {
+            start = m_index[i].ts_start;
+            ender = m_index[i].ts_end;
+        }
+        return result;
+    }
     for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
     {
         if (i->tick_start() <= position && position <= i->tick_end())
@@ -472,12 +673,23 @@ triggers::intersect (midipulse position, midipulse & start, midipulse & ender)
 }
 
 /**
+ *  Determines if any trigger contains the given tick.
  *
+ * \param position
+ *      The position to examine.
+ *
+ * \return
+ *      Returns true if a trigger contains the position.
  */
 
 bool
 triggers::intersect (midipulse position)
 {
+    if (index())
+    {
+        int i = find_end(m_index, position, false);
+        return i < int(m_index.size()) && m_index[i].ts_start <= position;
+    }
     for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
     {
         if (i->tick_start() <= position && position <= i->tick_end())
@@ -486,6 +698,74 @@ triggers::intersect (midipulse position)
     return false;
 }
 
+/**
+ *  Determines if any trigger overlaps the given range of ticks, and, if not,
+ *  which trigger starts next.  Used in deciding if a sequence can be parked
+ *  (see sequence::park()).  If the triggers are out of order, the whole list
+ *  is scanned.  Like play(), this runs on the output thread, and so reads
+ *  only the published index.
+ *
+ * \param starttick
+ *      The first tick of the range.
+ *
+ * \param endtick
+ *      The last tick of the range.
+ *
+ * \param nexttick
+ *      Returns the earliest start of a trigger past \a endtick if no trigger
+ *      overlaps the range, or SEQ64_NULL_MIDIPULSE if there is none.
+ *
+ * \return
+ *      Returns true if a trigger overlaps the range.
+ */
+
+bool
+triggers::covers
+(
+    midipulse starttick, midipulse endtick, midipulse & nexttick
+) const
+{
+    nexttick = SEQ64_NULL_MIDIPULSE;
+    std::shared_ptr<const play_index> pi = m_play_index.load();
+    const std::vector<span> & spans = pi->pi_spans;
+    if (pi->pi_ordered)
+    {
+        int n = int(spans.size());
+        int i = find_end(spans, starttick, false);
+        bool result = i < n && spans[i].ts_start <= endtick;
+        if (! result)
+        {
+            std::vector<span>::const_iterator t = std::upper_bound
+            (
+                spans.begin(), spans.end(), endtick,
+                [] (midipulse p, const span & ts) { return p < ts.ts_start; }
+            );
+            if (t != spans.end())
+                nexttick = t->ts_start;
+        }
+        return result;
+    }
+    for
+    (
+        std::vector<span>::const_iterator i = spans.begin();
+        i != spans.end(); ++i
+    )
+    {
+        midipulse trigstart = i->ts_start;
+        if (trigstart > endtick)
+        {
+            if (is_null_midipulse(nexttick) || trigstart < nexttick)
+                nexttick = trigstart;
+        }
+        else if (i->ts_end >= starttick)
+        {
+            nexttick = SEQ64_NULL_MIDIPULSE;
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  *  Grows a trigger.  This function looks for the first trigger where
  *  the tickfrom parameter is between the trigger's tick-start and tick-end
@@ -545,6 +825,7 @@ triggers::remove (midipulse tick)
         {
             unselect(*i);                       /* adjust selection count    */
             m_triggers.erase(i);
+            list_changed();
             break;
         }
     }
@@ -571,6 +852,7 @@ triggers::split (trigger & trig, midipulse splittick)
     midipulse new_tick_end = trig.tick_end();
     midipulse new_tick_start = splittick;
     trig.tick_end(splittick - 1);
+    list_changed();
 
     midipulse len = new_tick_end - new_tick_start;
     if (len > 1)
@@ -660,6 +942,7 @@ triggers::adjust_offsets_to_length (midipulse newlength)
 {
     if (newlength > 0)
     {
+        list_changed();
         for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
         {
             i->offset(adjust_offset(i->offset()));
@@ -778,6 +1061,7 @@ triggers::copy (midipulse starttick, midipulse distance)
         }
     }
     m_triggers.sort();
+    list_changed();
 }
 
 /**
@@ -800,6 +1084,7 @@ void
 triggers::move (midipulse starttick, midipulse distance, bool direction)
 {
     midipulse endtick = starttick + distance;
+    list_changed();
     for (List::iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
     {
         if (i->tick_start() < starttick && starttick < i->tick_end())
@@ -1007,6 +1292,7 @@ triggers::move_selected (midipulse tick, bool fixoffset, grow_edit_t which)
                 s->increment_offset(deltatick);
                 s->offset(adjust_offset(s->offset()));
             }
+            list_changed();
             break;
         }
         else
@@ -1035,6 +1321,8 @@ triggers::offset_selected (midipulse tick, grow_edit_t editmode)
 
             if (editmode == GROW_MOVE)
                 i->increment_offset(tick);
+
+            list_changed();
         }
         ++i;
     }
@@ -1073,12 +1361,24 @@ bool
 triggers::get_state (midipulse tick) const
 {
     bool result = false;
-    for (List::const_iterator i = m_triggers.begin(); i != m_triggers.end(); ++i)
+    if (index())
     {
-        if (i->tick_start() <= tick && tick <= i->tick_end())
+        int i = find_end(m_index, tick, false);
+        result = i < int(m_index.size()) && m_index[i].ts_start <= tick;
+    }
+    else
+    {
+        for
+        (
+            List::const_iterator i = m_triggers.begin();
+            i != m_triggers.end(); ++i
+        )
         {
-            result = true;
-            break;
+            if (i->tick_start() <= tick && tick <= i->tick_end())
+            {
+                result = true;
+                break;
+            }
         }
     }
     return result;
@@ -1167,6 +1467,7 @@ triggers::remove_selected ()
         {
             unselect(*i);               /* this adjusts the selection count */
             m_triggers.erase(i);
+            list_changed();
             break;
         }
     }
@@ -1233,6 +1534,37 @@ triggers::paste (midipulse paste_tick)
     }
 }
 
+/**
+ *  Sets the draw-trigger iterator to the first trigger that is not over by
+ *  the given start tick, and makes next() stop after the last trigger that
+ *  starts by the given end tick.  A window of the song editor can thus skip
+ *  the triggers it cannot show.  If the triggers are out of order, all of
+ *  them are drawn.
+ *
+ * \param starttick
+ *      The first tick visible in the window.
+ *
+ * \param endtick
+ *      The last tick visible in the window.
+ */
+
+void
+triggers::reset_draw_trigger_marker (midipulse starttick, midipulse endtick)
+{
+    if (index())
+    {
+        int i = find_end(m_index, starttick, false);
+        if (i < int(m_index.size()))
+            m_iterator_draw_trigger = m_index[i].ts_trigger;
+        else
+            m_iterator_draw_trigger = m_triggers.end();
+
+        m_draw_limit = endtick;
+    }
+    else
+        reset_draw_trigger_marker();
+}
+
 /**
  *  Get the next trigger in the trigger list, and set the parameters based
  *  on that trigger.
@@ -1274,6 +1606,11 @@ triggers::next
 {
     while (m_iterator_draw_trigger != m_triggers.end())
     {
+        if (! is_null_midipulse(m_draw_limit))
+        {
+            if (m_iterator_draw_trigger->tick_start() > m_draw_limit)
+                break;
+        }
         tick_on  = m_iterator_draw_trigger->tick_start();
         selected = m_iterator_draw_trigger->selected();
         offset = m_iterator_draw_trigger->offset();
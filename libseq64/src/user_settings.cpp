@@ -229,6 +229,8 @@ user_settings::user_settings ()
     m_user_option_daemonize     (false),
     m_user_use_logfile          (false),
     m_user_option_logfile       (),
+    m_user_option_render        (),
+    m_user_option_render_format (1),
     m_work_around_play_image    (false),
     m_work_around_transpose_image (false),
 
@@ -345,6 +347,8 @@ user_settings::user_settings (const user_settings & rhs)
     m_user_option_daemonize     (rhs.m_user_option_daemonize),
     m_user_use_logfile          (rhs.m_user_use_logfile),
     m_user_option_logfile       (rhs.m_user_option_logfile),
+    m_user_option_render        (rhs.m_user_option_render),
+    m_user_option_render_format (rhs.m_user_option_render_format),
     m_work_around_play_image    (rhs.m_work_around_play_image),
     m_work_around_transpose_image (rhs.m_work_around_transpose_image),
 
@@ -461,6 +465,8 @@ user_settings::operator = (const user_settings & rhs)
         m_user_option_daemonize = rhs.m_user_option_daemonize;
         m_user_use_logfile = rhs.m_user_use_logfile;
         m_user_option_logfile = rhs.m_user_option_logfile;
+        m_user_option_render = rhs.m_user_option_render;
+        m_user_option_render_format = rhs.m_user_option_render_format;
         m_work_around_play_image = rhs.m_work_around_play_image;
         m_work_around_transpose_image = rhs.m_work_around_transpose_image;
 
@@ -550,6 +556,8 @@ user_settings::set_defaults ()
     m_user_option_daemonize = false;
     m_user_use_logfile = false;
     m_user_option_logfile.clear();
+    m_user_option_render.clear();
+    m_user_option_render_format = 1;
     m_work_around_play_image = false;
     m_work_around_transpose_image = false;
     m_user_ui_key_height = 10;
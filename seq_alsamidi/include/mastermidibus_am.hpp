@@ -45,6 +45,13 @@
 #include <alsa/asoundlib.h>
 #include <alsa/seq_midi_event.h>
 
+/**
+ *  The size of the buffer into which the ALSA MIDI parser decodes an input
+ *  event.
+ */
+
+#define SEQ64_ALSA_PARSER_SIZE          0x1000
+
 /*
  *  Do not document a namespace; it breaks Doxygen.
  */
@@ -71,7 +78,8 @@ private:
     snd_seq_t * m_alsa_seq;
 
     /**
-     *  The number of descriptors for polling.
+     *  The number of descriptors for polling, including the one for
+     *  m_wake_fd, if open, which is the last one.
      */
 
     int m_num_poll_descriptors;
@@ -82,6 +90,28 @@ private:
 
     struct pollfd * m_poll_descriptors;
 
+    /**
+     *  An eventfd that is polled along with the ALSA descriptors, so that
+     *  api_wake_input() can end the poll at once when input is to stop.  It
+     *  is -1 if it could not be opened, in which case the poll simply times
+     *  out.
+     */
+
+    int m_wake_fd;
+
+    /**
+     *  The ALSA MIDI parser, made once and used for every input event, with
+     *  running status turned off so that every event gets its status byte.
+     */
+
+    snd_midi_event_t * m_midi_parser;
+
+    /**
+     *  The buffer into which m_midi_parser decodes an input event.
+     */
+
+    midibyte m_midi_buffer[SEQ64_ALSA_PARSER_SIZE];
+
 public:
 
     mastermidibus
@@ -94,16 +124,25 @@ public:
 private:
 
     virtual bool api_get_midi_event (event * in);
+    virtual int api_get_midi_events (event * evs, int count);
     virtual int api_poll_for_midi ();
+    virtual void api_wake_input ();
     virtual void api_init (int ppqn, midibpm bpm);
     virtual void api_set_ppqn (int ppqn);
     virtual void api_set_beats_per_minute (midibpm bpm);
+    virtual void api_schedule_beats_per_minute (midibpm bpm, midipulse tick);
+    virtual bool api_start_scheduling ();
+    virtual void api_cancel_scheduled ();
+    virtual midipulse api_schedule_tick ();
+    virtual long api_input_age (midipulse stamp);
     virtual void api_flush ();
     virtual void api_start ();
     virtual void api_stop ();
     virtual void api_continue_from (midipulse tick);
     virtual void api_port_start (int client, int port);
 
+    void get_poll_descriptors ();
+
     /*
      * Not implemented:
      *
@@ -59,7 +59,9 @@
 #include "easy_macros.h"
 
 #ifdef SEQ64_HAVE_LIBASOUND
+#include <sys/eventfd.h>                 /* eventfd(), eventfd_read()    */
 #include <sys/poll.h>
+#include <unistd.h>                     /* close()                      */
 #ifdef SEQ64_LASH_SUPPORT
 #include "lash.hpp"
 #endif
@@ -100,6 +102,31 @@
 namespace seq64
 {
 
+/**
+ *  Converts the real-time stamp of an ALSA input event to the timestamp of
+ *  a Sequencer64 event, in microseconds of the queue real time.  The value
+ *  wraps around where a long does; see api_input_age().
+ *
+ * \param ev
+ *      The ALSA event.
+ *
+ * \return
+ *      Returns the stamp, or SEQ64_NULL_MIDIPULSE if the event was not
+ *      stamped with the real time.
+ */
+
+static midipulse
+alsa_input_stamp (const snd_seq_event_t * ev)
+{
+    if (! snd_seq_ev_is_real(ev))
+        return SEQ64_NULL_MIDIPULSE;
+
+    unsigned long us = (unsigned long)(ev->time.time.tv_sec) * 1000000UL +
+        ev->time.time.tv_nsec / 1000;
+
+    return midipulse(us);
+}
+
 /**
  *  The mastermidibus default constructor fills the array with our busses.
  *
@@ -119,7 +146,10 @@ mastermidibus::mastermidibus (int ppqn, midibpm bpm)
     mastermidibase          (ppqn, bpm),
     m_alsa_seq              (nullptr),
     m_num_poll_descriptors  (0),
-    m_poll_descriptors      (nullptr)
+    m_poll_descriptors      (nullptr),
+    m_wake_fd               (-1),
+    m_midi_parser           (nullptr),
+    m_midi_buffer           ()
 {
     /*
      * Open the sequencer client.  This line of code results in a loss of
@@ -150,6 +180,25 @@ mastermidibus::mastermidibus (int ppqn, midibpm bpm)
     snd_seq_set_client_name(m_alsa_seq, SEQ64_PACKAGE); /* "sequencer64"    */
     m_queue = snd_seq_alloc_queue(m_alsa_seq);          /* protected member */
 
+    /*
+     * Make the one MIDI parser used for all input, and the eventfd that
+     * wakes up the input thread.
+     */
+
+    if (snd_midi_event_new(sizeof(m_midi_buffer), &m_midi_parser) < 0)
+    {
+        m_midi_parser = nullptr;
+        errprint("snd_midi_event_new() error");
+    }
+    else
+        snd_midi_event_no_status(m_midi_parser, 1);     /* no running status */
+
+    m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wake_fd < 0)
+    {
+        errprint("eventfd() error, input stop waits for the poll timeout");
+    }
+
 #ifdef SEQ64_LASH_SUPPORT
 
     /*
@@ -193,6 +242,16 @@ mastermidibus::~mastermidibus ()
         delete [] m_poll_descriptors;
         m_poll_descriptors = nullptr;
     }
+    if (not_nullptr(m_midi_parser))
+    {
+        snd_midi_event_free(m_midi_parser);
+        m_midi_parser = nullptr;
+    }
+    if (m_wake_fd >= 0)
+    {
+        (void) close(m_wake_fd);
+        m_wake_fd = -1;
+    }
 }
 
 /**
@@ -347,18 +406,11 @@ mastermidibus::api_init (int ppqn, midibpm bpm)
     set_sequence_input(false, nullptr);
 
     /*
-     * Get the number of MIDI input poll file descriptors.  Allocate the
-     * poll-descriptors array.  Then get the input poll-descriptors into the
-     * array.  Then set the input and output buffer sizes.   Then create an
-     * announcment buss.
+     * Get the input poll-descriptors.  Then set the input and output buffer
+     * sizes.   Then create an announcment buss.
      */
 
-    m_num_poll_descriptors = snd_seq_poll_descriptors_count(m_alsa_seq, POLLIN);
-    m_poll_descriptors = new pollfd[m_num_poll_descriptors];
-    snd_seq_poll_descriptors
-    (
-        m_alsa_seq, m_poll_descriptors, m_num_poll_descriptors, POLLIN
-    );
+    get_poll_descriptors();
     snd_seq_set_output_buffer_size(m_alsa_seq, c_midibus_output_size);
     snd_seq_set_input_buffer_size(m_alsa_seq, c_midibus_input_size);
     m_bus_announce = new midibus
@@ -479,6 +531,134 @@ mastermidibus::api_set_beats_per_minute (midibpm b)
     snd_seq_set_queue_tempo(m_alsa_seq, m_queue, tempo);
 }
 
+/**
+ *  Schedules a change of the tempo of the ALSA queue at the given tick, so
+ *  that the events queued ahead of it keep the old tempo.
+ *
+ * \threadsafe
+ *
+ * \param b
+ *      The beats/minute value to set.
+ *
+ * \param tick
+ *      The tick of the queue at which the tempo changes.
+ */
+
+void
+mastermidibus::api_schedule_beats_per_minute (midibpm b, midipulse tick)
+{
+    snd_seq_event_t ev;
+    snd_seq_ev_clear(&ev);
+    snd_seq_ev_schedule_tick(&ev, m_queue, 0, tick);
+    snd_seq_change_queue_tempo
+    (
+        m_alsa_seq, m_queue, int(tempo_us_from_bpm(b)), &ev
+    );
+}
+
+/**
+ *  Restarts the ALSA queue at tick 0, for scheduled output.  The events
+ *  still pending from the last run, such as Note Offs, are let out first.
+ *
+ * \threadsafe
+ *
+ * \return
+ *      Always returns true, the ALSA queue can schedule events.
+ */
+
+bool
+mastermidibus::api_start_scheduling ()
+{
+    snd_seq_drain_output(m_alsa_seq);
+    snd_seq_sync_output_queue(m_alsa_seq);
+    snd_seq_start_queue(m_alsa_seq, m_queue, NULL);     /* tick 0       */
+    snd_seq_drain_output(m_alsa_seq);
+    return true;
+}
+
+/**
+ *  Removes the events still waiting in the ALSA queue, from our output
+ *  buffer and from the queue itself, except the Note Offs, which go out on
+ *  time.
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibus::api_cancel_scheduled ()
+{
+    snd_seq_drain_output(m_alsa_seq);
+
+    snd_seq_remove_events_t * remove;
+    snd_seq_remove_events_alloca(&remove);
+    snd_seq_remove_events_set_condition
+    (
+        remove, SND_SEQ_REMOVE_OUTPUT | SND_SEQ_REMOVE_IGNORE_OFF
+    );
+    snd_seq_remove_events_set_queue(remove, m_queue);
+    snd_seq_remove_events(m_alsa_seq, remove);
+}
+
+/**
+ *  Gets the current tick of the ALSA queue.
+ *
+ * \threadsafe
+ *
+ * \return
+ *      Returns the tick, or SEQ64_NULL_MIDIPULSE if the status of the queue
+ *      cannot be obtained.
+ */
+
+midipulse
+mastermidibus::api_schedule_tick ()
+{
+    snd_seq_queue_status_t * status;
+    snd_seq_queue_status_alloca(&status);
+    if (snd_seq_get_queue_status(m_alsa_seq, m_queue, status) < 0)
+        return SEQ64_NULL_MIDIPULSE;
+
+    return midipulse(snd_seq_queue_status_get_tick_time(status));
+}
+
+/**
+ *  Gets the age of an input event, from the real time of the ALSA queue at
+ *  which it came in, as stamped by api_get_midi_event().  The input
+ *  subscriptions ask ALSA to stamp the events with the real time of the
+ *  queue.  The stamp is in microseconds, and wraps around, so only the
+ *  difference from the current real time of the queue is used.
+ *
+ * \threadsafe
+ *
+ * \param stamp
+ *      The timestamp of the event.
+ *
+ * \return
+ *      Returns the number of microseconds since the event came in, or 0 if
+ *      the event has no real-time stamp or the queue cannot be read.
+ */
+
+long
+mastermidibus::api_input_age (midipulse stamp)
+{
+    long result = 0;
+    if (! is_null_midipulse(stamp))
+    {
+        snd_seq_queue_status_t * status;
+        snd_seq_queue_status_alloca(&status);
+        if (snd_seq_get_queue_status(m_alsa_seq, m_queue, status) == 0)
+        {
+            const snd_seq_real_time_t * rt =
+                snd_seq_queue_status_get_real_time(status);
+
+            unsigned long now = (unsigned long)(rt->tv_sec) * 1000000UL +
+                rt->tv_nsec / 1000;
+
+            result = long(now - (unsigned long)(stamp));
+        }
+    }
+    return result;
+}
+
 /**
  *  Flushes our local queue events out into ALSA.
  *
@@ -492,7 +672,11 @@ mastermidibus::api_flush ()
 }
 
 /**
- *  Initiate a poll() on the existing poll descriptors.  The m_
+ *  Initiate a poll() on the existing poll descriptors.  The poll waits for
+ *  up to a second, but ends at once when MIDI comes in or when
+ *  api_wake_input() is called.  A wake-up is consumed here and is not
+ *  counted in the result, so the caller sees no input and gets to check
+ *  whether it is to stop.
  *
  *  No locking needed?
  *
@@ -507,12 +691,32 @@ int
 mastermidibus::api_poll_for_midi ()
 {
     int result = poll(m_poll_descriptors, m_num_poll_descriptors, 1000);
-    if (result == 0)
-        (void) microsleep(100);     // millisleep(1);
-
+    if (result > 0 && m_wake_fd >= 0)
+    {
+        const pollfd & wake = m_poll_descriptors[m_num_poll_descriptors - 1];
+        if ((wake.revents & POLLIN) != 0)
+        {
+            eventfd_t count;
+            (void) eventfd_read(m_wake_fd, &count);
+            --result;
+        }
+    }
     return result;
 }
 
+/**
+ *  Ends the wait of the input thread in api_poll_for_midi().
+ *
+ * \threadsafe
+ */
+
+void
+mastermidibus::api_wake_input ()
+{
+    if (m_wake_fd >= 0)
+        (void) eventfd_write(m_wake_fd, 1);
+}
+
 #ifdef USE_SND_SEQ_EVENT_INPUT_PENDING
 
 /**
@@ -611,26 +815,42 @@ mastermidibus::api_port_start (int bus, int port)
         }
     }                                           /* end loop for clients */
 
-    /*
-     * Get the number of MIDI input poll file descriptors.  Allocate the
-     * buffer to hold the descriptors, then get the descriptors from ALSA.
-     */
+    get_poll_descriptors();
+}
 
-    m_num_poll_descriptors = snd_seq_poll_descriptors_count(m_alsa_seq, POLLIN);
-    m_poll_descriptors = new pollfd[m_num_poll_descriptors];
-    snd_seq_poll_descriptors
-    (
-        m_alsa_seq, m_poll_descriptors, m_num_poll_descriptors, POLLIN
-    );
+/**
+ *  Gets the number of MIDI input poll file descriptors, allocates the array
+ *  to hold them, plus one for the wake-up eventfd, and then gets the
+ *  descriptors from ALSA.  Any previous array is freed.  Called only at
+ *  initialization and from the input thread, so no locking is needed.
+ */
+
+void
+mastermidibus::get_poll_descriptors ()
+{
+    if (not_nullptr(m_poll_descriptors))
+        delete [] m_poll_descriptors;
+
+    int count = snd_seq_poll_descriptors_count(m_alsa_seq, POLLIN);
+    m_poll_descriptors = new pollfd[count + 1];
+    snd_seq_poll_descriptors(m_alsa_seq, m_poll_descriptors, count, POLLIN);
+    if (m_wake_fd >= 0)
+    {
+        m_poll_descriptors[count].fd = m_wake_fd;
+        m_poll_descriptors[count].events = POLLIN;
+        m_poll_descriptors[count].revents = 0;
+        ++count;
+    }
+    m_num_poll_descriptors = count;
 }
 
 /**
- *  Grab a MIDI event.  First, a rather large buffer is allocated on the stack
- *  to hold the MIDI event data.  Next, if the --alsa-manual-ports option is
- *  not in force, then we check to see if the event is a port-start,
- *  port-exit, or port-change event, and we prcess it, and are done.
+ *  Grab a MIDI event.  If the --alsa-manual-ports option is not in force,
+ *  then we check to see if the event is a port-start, port-exit, or
+ *  port-change event, and we prcess it, and are done.
  *
- *  Otherwise, we create a "MIDI event parser" and decode the MIDI event.
+ *  Otherwise, we decode the MIDI event with the "MIDI event parser" into
+ *  m_midi_buffer.  Both are made once, in the constructor.
  *
  * \threadsafe
  *
@@ -649,8 +869,10 @@ mastermidibus::api_get_midi_event (event * inev)
     snd_seq_event_t * ev;
     bool sysex = false;
     bool result = false;
-    midibyte buffer[0x1000];                /* temporary buffer for MIDI data */
-    snd_seq_event_input(m_alsa_seq, &ev);
+    midibyte * buffer = m_midi_buffer;      /* buffer for the MIDI data     */
+    if (snd_seq_event_input(m_alsa_seq, &ev) < 0 || is_nullptr(m_midi_parser))
+        return false;
+
     if (! rc().manual_alsa_ports())
     {
         switch (ev->type)
@@ -679,13 +901,14 @@ mastermidibus::api_get_midi_event (event * inev)
     if (result)
         return false;
 
-    snd_midi_event_t * midi_ev;                     /* for ALSA MIDI parser  */
-    snd_midi_event_new(sizeof(buffer), &midi_ev);   /* make ALSA MIDI parser */
-    long bytes = snd_midi_event_decode(midi_ev, buffer, sizeof(buffer), ev);
+    long bytes = snd_midi_event_decode
+    (
+        m_midi_parser, buffer, SEQ64_ALSA_PARSER_SIZE, ev
+    );
     if (bytes <= 0)                                 /* happens at startup    */
         return false;
 
-    inev->set_timestamp(ev->time.tick);
+    inev->set_timestamp(alsa_input_stamp(ev));
     inev->set_status_keep_channel(buffer[0]);
 
     /**
@@ -726,16 +949,49 @@ mastermidibus::api_get_midi_event (event * inev)
     while (sysex)       /* sysex messages might be more than one message */
     {
         snd_seq_event_input(m_alsa_seq, &ev);
-        long bytes = snd_midi_event_decode(midi_ev, buffer, sizeof(buffer), ev);
+        long bytes = snd_midi_event_decode
+        (
+            m_midi_parser, buffer, SEQ64_ALSA_PARSER_SIZE, ev
+        );
         if (bytes > 0)
             sysex = inev->append_sysex(buffer, bytes);
         else
             sysex = false;
     }
-    snd_midi_event_free(midi_ev);
     return true;
 }
 
+/**
+ *  Grabs all of the input events that ALSA has pending, up to a limit, so
+ *  that one wakeup of the input thread handles a whole burst of input.
+ *  The pending check also fetches events from the sequencer, so that a
+ *  burst that arrives while the batch is being taken is drained too.
+ *
+ * \param evs
+ *      The array of events to be set based on the found input events.
+ *
+ * \param count
+ *      The number of events that the array can hold.
+ *
+ * \return
+ *      Returns the number of events set.  ALSA port events and events that
+ *      do not decode are not counted.
+ */
+
+int
+mastermidibus::api_get_midi_events (event * evs, int count)
+{
+    int result = 0;
+    do
+    {
+        evs[result] = event();
+        if (api_get_midi_event(&evs[result]))
+            ++result;
+    }
+    while (result < count && snd_seq_event_input_pending(m_alsa_seq, 1) > 0);
+    return result;
+}
+
 }           // namespace seq64
 
 /*
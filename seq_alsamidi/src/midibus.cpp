@@ -32,6 +32,7 @@
  */
 
 #include "globals.h"
+#include "alsa_encode.hpp"              /* seq64::alsa_encode_event()       */
 #include "calculations.hpp"             /* clock_ticks_from_ppqn()          */
 #include "event.hpp"                    /* seq64::event (MIDI event)        */
 #include "midibus.hpp"                  /* seq64::midibus for ALSA          */
@@ -123,9 +124,14 @@ midibus::midibus
     m_dest_addr_port    (destport),     // actually the port ID
     m_local_addr_client (localclient),
     m_local_addr_port   (-1),
-    m_input_port_name   (rc().app_client_name() + " in")
+    m_input_port_name   (rc().app_client_name() + " in"),
+    m_midi_encoder      (nullptr)
 {
-    // Functionality moved into the base class
+    if (snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &m_midi_encoder) < 0)
+    {
+        m_midi_encoder = nullptr;
+        errprint("snd_midi_event_new() error");
+    }
 }
 
 /**
@@ -178,18 +184,24 @@ midibus::midibus
     m_dest_addr_port    (SEQ64_NO_PORT),
     m_local_addr_client (localclient),
     m_local_addr_port   (SEQ64_NO_PORT),
-    m_input_port_name   (rc().app_client_name() + " in")
+    m_input_port_name   (rc().app_client_name() + " in"),
+    m_midi_encoder      (nullptr)
 {
-    // Functionality moved to the base class
+    if (snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &m_midi_encoder) < 0)
+    {
+        m_midi_encoder = nullptr;
+        errprint("snd_midi_event_new() error");
+    }
 }
 
 /**
- *  A rote empty destructor.
+ *  The destructor frees the ALSA MIDI encoder.
  */
 
 midibus::~midibus()
 {
-    // empty body
+    if (not_nullptr(m_midi_encoder))
+        snd_midi_event_free(m_midi_encoder);
 }
 
 /**
@@ -273,11 +285,14 @@ midibus::api_init_in ()
     snd_seq_port_subscribe_set_dest(subs, &dest);       /* local              */
 
     /*
-     * Use the master queue, and get ticks, then subscribe.
+     * Use the master queue, and get its real time, then subscribe.  The
+     * real time tells when each event came in; see mastermidibus ::
+     * api_input_age().
      */
 
     snd_seq_port_subscribe_set_queue(subs, queue_number());
     snd_seq_port_subscribe_set_time_update(subs, 1);
+    snd_seq_port_subscribe_set_time_real(subs, 1);
     result = snd_seq_subscribe_port(m_seq, subs);
     if (result < 0)
     {
@@ -426,7 +441,8 @@ midibus::api_deinit_in ()
     snd_seq_port_subscribe_set_dest(subs, &dest);
 
     snd_seq_port_subscribe_set_queue(subs, queue_number()); /* master queue */
-    snd_seq_port_subscribe_set_time_update(subs, 1);        /* get ticks    */
+    snd_seq_port_subscribe_set_time_update(subs, 1);        /* get times    */
+    snd_seq_port_subscribe_set_time_real(subs, 1);          /* real time    */
 
     int result = snd_seq_unsubscribe_port(m_seq, subs);     /* subscribe    */
     if (result < 0)
@@ -441,14 +457,6 @@ midibus::api_deinit_in ()
     return true;
 }
 
-/**
- *  Defines the size of the MIDI event buffer, which should be large enough to
- *  accomodate the largest MIDI message to be encoded.
- *  A local define for visibility.
- */
-
-#define SEQ64_MIDI_EVENT_SIZE_MAX   10
-
 /**
  *  This play() function takes a native event, encodes it to an ALSA MIDI
  *  sequencer event, sets the broadcasting to the subscribers, sets the
@@ -467,22 +475,55 @@ midibus::api_deinit_in ()
 
 void
 midibus::api_play (event * e24, midibyte channel)
+{
+    api_play_at(e24, channel, SEQ64_NULL_MIDIPULSE);
+}
+
+/**
+ *  Like api_play(), but schedules the event on the ALSA queue at the given
+ *  tick, rather than sending it directly.  The queue tick is provided by
+ *  mastermidibase::play_at().
+ *
+ * \threadsafe
+ *
+ * \param e24
+ *      The event to be played on this bus.  For speed, we don't bother to
+ *      check the pointer.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param tick
+ *      The tick of the queue at which the event is to be delivered.  If
+ *      SEQ64_NULL_MIDIPULSE, the event is sent directly.
+ */
+
+void
+midibus::api_play_at (event * e24, midibyte channel, midipulse tick)
 {
     midibyte buffer[4];                             /* temp for MIDI data   */
     buffer[0] = e24->get_status();                  /* fill buffer          */
     buffer[0] += (channel & 0x0F);
     e24->get_data(buffer[1], buffer[2]);            /* set MIDI data        */
 
-    snd_midi_event_t * midi_ev;                     /* ALSA MIDI parser     */
-    snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
-
     snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);                          /* clear event          */
-    snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* encode 3 raw bytes   */
-    snd_midi_event_free(midi_ev);                   /* free the parser      */
+    if
+    (
+        ! alsa_encode_event(ev, buffer[0], buffer[1], buffer[2]) &&
+        not_nullptr(m_midi_encoder)
+    )
+    {
+        snd_midi_event_reset_encode(m_midi_encoder);    /* no leftovers     */
+        snd_midi_event_encode(m_midi_encoder, buffer, 3, &ev);
+    }
     snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
     snd_seq_ev_set_subs(&ev);
-    snd_seq_ev_set_direct(&ev);                     /* it is immediate      */
+    if (is_null_midipulse(tick))
+        snd_seq_ev_set_direct(&ev);                 /* it is immediate      */
+    else
+        snd_seq_ev_schedule_tick(&ev, queue_number(), 0, tick);
+
     snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
 }
 
@@ -505,16 +546,12 @@ min (long a, long b)
     return (a < b) ? a : b ;
 }
 
-/**
- *  Defines the value used for sleeping, in microseconds.  Defined locally
- *  simply for visibility.  Why 80000?
- */
-
-#define SEQ64_USLEEP_US     80000
-
 /**
  *  Takes a native SYSEX event, encodes it to an ALSA event, and then
- *  puts it in the queue.
+ *  puts it in the queue.  This function no longer sleeps between the
+ *  chunks; mastermidibase::sysex() hands the event to a sysex_sender, which
+ *  calls this function with one chunk at a time, paced at the "rc"
+ *  [sysex-output] rate.
  *
  * \param e24
  *      The event to be handled.
@@ -551,7 +588,6 @@ midibus::api_sysex (event * e24)
             &ev, min(data_left, c_midibus_sysex_chunk), &data[offset]
         );
         snd_seq_event_output_direct(m_seq, &ev);        /* pump into queue  */
-        usleep(SEQ64_USLEEP_US);
         flush();
     }
 }
@@ -1357,19 +1357,15 @@ mainwnd::timer_callback ()
 
     if (perf().is_pattern_playing())
     {
-        int ppqn = perf().get_ppqn();
+        const tempo_map & tm = perf().get_tempo_map();
         if (m_tick_time_as_bbt)
         {
-            midi_timing mt
-            (
-                bpm, perf().get_beats_per_bar(), perf().get_beat_width(), ppqn
-            );
-            std::string t = pulses_to_measurestring(tick, mt);
+            std::string t = tm.measure_string(tick);
             m_tick_time->set_text(t);
         }
         else
         {
-            std::string t = pulses_to_timestring(tick, bpm, ppqn, false);
+            std::string t = tm.time_string(tick, false);
             m_tick_time->set_text(t);
         }
         if (m_button_mode->get_sensitive())
@@ -611,8 +611,9 @@ perfroll::draw_sequence_on (int seqnum)
     {
         midipulse tick_offset = m_4bar_offset;      //  * m_ticks_per_bar;
         midipulse x_offset = tick_offset / m_perf_scale_x;
+        midipulse tick_window = m_window_x * m_perf_scale_x;
         m_sequence_active[seqnum] = true;
-        seq->reset_draw_trigger_marker();
+        seq->reset_draw_trigger_marker(tick_offset, tick_offset + tick_window);
         seqnum -= m_sequence_offset;
 
         midipulse sequence_length = seq->get_length();
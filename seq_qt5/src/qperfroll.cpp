@@ -224,7 +224,7 @@ qperfroll::paintEvent (QPaintEvent *)
                 sequence * seq = perf().get_sequence(seqid);
                 midipulse seq_length = seq->get_length();
                 int length_w = seq_length / scale_zoom();
-                seq->reset_draw_trigger_marker();
+                seq->reset_draw_trigger_marker(tick0, tick1);
                 while (seq->get_next_trigger(tick_on, tick_off, selected, offset))
                 {
                     if (tick_off > 0)
@@ -983,20 +983,15 @@ qsmainwnd::refresh ()
     if (perf().is_pattern_playing())
     {
         midipulse tick = perf().get_tick();
-        midibpm bpm = perf().bpm();         // perf().get_beats_per_minute();
-        int ppqn = perf().get_ppqn();
+        const tempo_map & tm = perf().get_tempo_map();
         if (m_tick_time_as_bbt)
         {
-            midi_timing mt
-            (
-                bpm, perf().get_beats_per_bar(), perf().get_beat_width(), ppqn
-            );
-            std::string t = pulses_to_measurestring(tick, mt);
+            std::string t = tm.measure_string(tick);
             ui->label_HMS->setText(t.c_str());
         }
         else
         {
-            std::string t = pulses_to_timestring(tick, bpm, ppqn, false);
+            std::string t = tm.time_string(tick, false);
             ui->label_HMS->setText(t.c_str());
         }
     }
@@ -110,6 +110,75 @@ protected:
         m_midi_master.api_set_beats_per_minute(b);
     }
 
+    /**
+     *  Provides MIDI API-specific functionality for the scheduled
+     *  set_beats_per_minute() function.
+     */
+
+    virtual void api_schedule_beats_per_minute (midibpm b, midipulse tick)
+    {
+        m_midi_master.api_schedule_beats_per_minute(b, tick);
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the start_scheduling()
+     *  function.
+     */
+
+    virtual bool api_start_scheduling ()
+    {
+        return m_midi_master.api_start_scheduling();
+    }
+
+    virtual void api_cancel_scheduled ()
+    {
+        m_midi_master.api_cancel_scheduled();
+    }
+
+    virtual midipulse api_schedule_tick ()
+    {
+        return m_midi_master.api_schedule_tick();
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the frame_tick()
+     *  function.
+     */
+
+    virtual void api_frame_tick (midipulse tick)
+    {
+        m_midi_master.api_frame_tick(tick);
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the input_tick()
+     *  function.
+     */
+
+    virtual midipulse api_input_tick (midipulse stamp)
+    {
+        return m_midi_master.api_input_tick(stamp);
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the input_tick()
+     *  function.
+     */
+
+    virtual long api_input_age (midipulse stamp)
+    {
+        return m_midi_master.api_input_age(stamp);
+    }
+
+    /**
+     *  Provides MIDI API-specific functionality for the engine() function.
+     */
+
+    virtual bool api_engine (bool on)
+    {
+        return m_midi_master.api_engine(on ? this : nullptr);
+    }
+
     virtual void api_flush ()
     {
         m_midi_master.api_flush();
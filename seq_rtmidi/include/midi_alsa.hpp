@@ -103,6 +103,14 @@ private:
 
     const std::string m_input_port_name;
 
+    /**
+     *  The ALSA MIDI encoder for the messages that alsa_encode_event() does
+     *  not handle.  Made once for the buss, rather than for each event, and
+     *  used under the buss mutex.  Can be null, if ALSA could not make it.
+     */
+
+    snd_midi_event_t * m_midi_encoder;
+
 public:
 
     /*
@@ -163,6 +171,7 @@ protected:
      */
 
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_at (event * e24, midibyte channel, midipulse tick);
     virtual void api_sysex (event * e24);
     virtual void api_flush ();
     virtual void api_continue_from (midipulse tick, midipulse beats);
@@ -96,6 +96,11 @@ public:
     virtual int api_poll_for_midi ();
     virtual void api_set_ppqn (int p);
     virtual void api_set_beats_per_minute (midibpm b);
+    virtual void api_schedule_beats_per_minute (midibpm b, midipulse tick);
+    virtual bool api_start_scheduling ();
+    virtual void api_cancel_scheduled ();
+    virtual midipulse api_schedule_tick ();
+    virtual long api_input_age (midipulse stamp);
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port);
     virtual void api_flush ();
 
@@ -146,6 +146,19 @@ public:
     virtual void api_set_ppqn (int ppqn) = 0;
     virtual void api_set_beats_per_minute (midibpm bpm) = 0;
 
+    /**
+     *  Plays an event at the given tick of the queue.  Only an API with a
+     *  queue can schedule events, so the default plays the event now.
+     */
+
+    virtual void api_play_at
+    (
+        event * e24, midibyte channel, midipulse /* tick */
+    )
+    {
+        api_play(e24, channel);
+    }
+
     /*
      * The next two functions are provisional.  Currently useful only in the
      * midi_jack module.
@@ -48,6 +48,7 @@
 namespace seq64
 {
     class event;
+    class mastermidibase;
     class mastermidibus;
     class midibus;
 
@@ -416,6 +417,95 @@ public:
         m_bpm = b;
     }
 
+    /**
+     *  Schedules a tempo change on the queue.  Only the ALSA API has a
+     *  queue, so by default the change is made now.
+     */
+
+    virtual void api_schedule_beats_per_minute
+    (
+        midibpm b, midipulse /* tick */
+    )
+    {
+        api_set_beats_per_minute(b);
+    }
+
+    /**
+     *  Restarts the queue for scheduled output.  An API without a queue
+     *  cannot schedule events.
+     */
+
+    virtual bool api_start_scheduling ()
+    {
+        return false;
+    }
+
+    /**
+     *  Drops the events still scheduled.  An ALSA-specific function.
+     */
+
+    virtual void api_cancel_scheduled ()
+    {
+        // Empty body
+    }
+
+    /**
+     *  Gets the current tick of the queue.  An ALSA-specific function.
+     */
+
+    virtual midipulse api_schedule_tick ()
+    {
+        return SEQ64_NULL_MIDIPULSE;
+    }
+
+    /**
+     *  Notes the current tick of the performance.  A JACK-specific function.
+     */
+
+    virtual void api_frame_tick (midipulse /* tick */)
+    {
+        // Empty body
+    }
+
+    /**
+     *  Converts the timestamp of an input event to a tick.  A JACK-specific
+     *  function.
+     *
+     * \return
+     *      Returns SEQ64_NULL_MIDIPULSE, meaning "use the current tick".
+     */
+
+    virtual midipulse api_input_tick (midipulse /* stamp */)
+    {
+        return SEQ64_NULL_MIDIPULSE;
+    }
+
+    /**
+     *  Gets the number of microseconds since an input event came in, from
+     *  its timestamp.
+     *
+     * \return
+     *      Returns 0, meaning "just now".
+     */
+
+    virtual long api_input_age (midipulse /* stamp */)
+    {
+        return 0;
+    }
+
+    /**
+     *  Lets the process cycle of the API drive playback, by calling
+     *  mastermidibase::engine_cycle().  A JACK-specific function.
+     *
+     * \return
+     *      Returns true if the API has a process cycle.
+     */
+
+    virtual bool api_engine (mastermidibase * /* masterbus */)
+    {
+        return false;
+    }
+
     /**
      *  An ALSA-specific function at the moment.
      */
@@ -153,6 +153,7 @@ protected:
     void close_client ();
     void close_port ();
     bool create_ringbuffer (size_t rbsize);
+    bool create_input_ringbuffer (size_t rbsize);
     bool connect_port
     (
         bool input,
@@ -193,7 +194,18 @@ protected:
      */
 
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_at (event * e24, midibyte channel, midipulse tick);
     virtual void api_sysex (event * e24);
+
+    /**
+     *  A JACK port takes each SysEx message whole.  See api_sysex().
+     */
+
+    virtual int api_sysex_chunk () const
+    {
+        return 0;
+    }
+
     virtual void api_flush ();
     virtual void api_continue_from (midipulse tick, midipulse beats);
     virtual void api_start ();
@@ -206,7 +218,12 @@ protected:
 private:
 
     void send_byte (midibyte evbyte);
-    bool send_message (const midi_message & message);
+    bool send_message
+    (
+        const midi_message & message,
+        midipulse tick = SEQ64_NULL_MIDIPULSE
+    );
+    bool send_event (const midibyte * msg, int count, midipulse tick);
     bool set_virtual_name (int portid, const std::string & portname);
 
 };          // class midi_jack
@@ -232,6 +249,8 @@ public:
 
 private:
 
+    bool get_input_message (midi_message & message);
+
     /**
      *  This function is virtual, so we don't call it in the constructor,
      *  using open_client_impl() directly instead.  This function replaces the
@@ -9,7 +9,7 @@
  * \library       sequencer64 application
  * \author        Chris Ahlstrom
  * \date          2017-01-02
- * \updates       2017-09-14
+ * \updates       2026-10-17
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *  GitHub issue #165: enabled a build and run with no JACK support.
@@ -19,6 +19,7 @@
 
 #ifdef SEQ64_JACK_SUPPORT
 
+#include <atomic>                       /* std::atomic<int>             */
 #include <jack/jack.h>
 #include <jack/ringbuffer.h>
 
@@ -28,6 +29,47 @@
 
 namespace seq64
 {
+    struct engine_event;
+
+/**
+ *  The header of each record of the output ring-buffer.  It gives the size
+ *  of the message, and the absolute JACK frame at which the message is due.
+ *  The bytes of the message follow it in the same ring-buffer.
+ */
+
+struct midi_jack_header
+{
+    jack_nframes_t mjh_frame;       /**< The frame at which the event is due. */
+    int mjh_size;                   /**< The number of bytes in the message.  */
+};
+
+/**
+ *  The number of MIDI bytes held by one midi_jack_record.  Most messages
+ *  fit in one record; a SysEx message takes as many records as needed.
+ */
+
+#define SEQ64_JACK_RECORD_BYTES     24
+
+/**
+ *  The number of bytes of output records, headers included, that the JACK
+ *  output process callback can hold over for a later cycle.
+ */
+
+#define SEQ64_JACK_CARRY_BYTES    4096
+
+/**
+ *  A fixed-size record of the input ring-buffer.  The JACK input process
+ *  callback writes one or more of these for each incoming message; the
+ *  input thread reads them back.  Only the first record of a message gives
+ *  the frame and the size; the rest just carry the remaining bytes.
+ */
+
+struct midi_jack_record
+{
+    jack_nframes_t mjr_frame;       /**< The absolute frame of the event.     */
+    int mjr_size;                   /**< The number of bytes in the message.  */
+    midibyte mjr_bytes[SEQ64_JACK_RECORD_BYTES];    /**< The message bytes.   */
+};
 
 /**
  *  Contains the JACK MIDI API data as a kind of scratchpad for this object.
@@ -57,25 +99,91 @@ struct midi_jack_data
     jack_port_t * m_jack_port;
 
     /**
-     *  Holds the size of data for communicating between the client
-     *  ring-buffer and the JACK port's internal buffer.
+     *  Holds the messages passed from the application to the JACK output
+     *  process callback, for an output port.  Each message is a framed
+     *  record, a midi_jack_header followed by the bytes of the message,
+     *  which is published to the reader in one step, so that the reader
+     *  never sees part of a record.
+     */
+
+    jack_ringbuffer_t * m_jack_buffoutput;
+
+    /**
+     *  The number of output messages dropped because m_jack_buffoutput was
+     *  full.  Written only by the thread that writes the ring-buffer.
+     */
+
+    int m_jack_drops;
+
+    /**
+     *  The number of output messages dropped by the process callback,
+     *  because they could never fit in one cycle, or because JACK could not
+     *  reserve room for them.  Written only by the process callback, which
+     *  must not print; midi_jack::api_flush() reports the new drops.
+     */
+
+    std::atomic<int> m_jack_cycle_drops;
+
+    /**
+     *  The value of m_jack_cycle_drops that midi_jack::api_flush() last
+     *  reported.  Used only by the thread that flushes.
+     */
+
+    int m_jack_cycle_drops_seen;
+
+    /**
+     *  The most bytes that m_jack_buffoutput has held, as seen by the writer
+     *  just after a write.  Used to size the ring-buffer; see the "rc"
+     *  [jack-ringbuffer] setting.
+     */
+
+    size_t m_jack_high_water;
+
+    /**
+     *  Holds the output records, each a midi_jack_header followed by its
+     *  bytes, that the process callback has read from m_jack_buffoutput but
+     *  that are due in a later cycle.  Taking them out of the ring-buffer
+     *  lets the records behind them, such as untimed messages, go out at
+     *  once.  Used only by the process callback.
+     */
+
+    char m_jack_carry[SEQ64_JACK_CARRY_BYTES];
+
+    /**
+     *  The number of bytes in use in m_jack_carry.
+     */
+
+    int m_jack_carry_used;
+
+    /**
+     *  The events rendered in engine mode for the current process cycle,
+     *  for all of the busses, set by jack_process_io() just before it
+     *  writes this output port.  Only those of m_jack_engine_bus are
+     *  written to the port.  Used only by the process callback.
+     */
+
+    const engine_event * m_jack_engine;
+
+    /**
+     *  The number of events in m_jack_engine, or 0 if not in engine mode.
      */
 
-    jack_ringbuffer_t * m_jack_buffsize;
+    int m_jack_engine_count;
 
     /**
-     *  Holds the data for communicating between the client ring-buffer and
-     *  the JACK port's internal buffer.
+     *  The buss number of this output port, which selects its events from
+     *  m_jack_engine.
      */
 
-    jack_ringbuffer_t * m_jack_buffmessage;
+    int m_jack_engine_bus;
 
     /**
-     *  The last time-stamp obtained.  Use for calculating the delta time, I
-     *  would imagine.
+     *  Holds the midi_jack_record items passed from the JACK input process
+     *  callback to the input thread, for an input port.  A JACK ringbuffer
+     *  has one writer and one reader, and needs no lock.
      */
 
-    jack_time_t m_jack_lasttime;
+    jack_ringbuffer_t * m_jack_buffinput;
 
     /**
      *  Holds special data peculiar to the client and its MIDI input
@@ -89,12 +197,20 @@ struct midi_jack_data
      */
 
     midi_jack_data () :
-        m_jack_client       (nullptr),
-        m_jack_port         (nullptr),
-        m_jack_buffsize     (nullptr),
-        m_jack_buffmessage  (nullptr),
-        m_jack_lasttime     (0),
-        m_jack_rtmidiin     (nullptr)
+        m_jack_client           (nullptr),
+        m_jack_port             (nullptr),
+        m_jack_buffoutput       (nullptr),
+        m_jack_drops            (0),
+        m_jack_cycle_drops      (0),
+        m_jack_cycle_drops_seen (0),
+        m_jack_high_water       (0),
+        m_jack_carry            (),
+        m_jack_carry_used       (0),
+        m_jack_engine           (nullptr),
+        m_jack_engine_count     (0),
+        m_jack_engine_bus       (0),
+        m_jack_buffinput        (nullptr),
+        m_jack_rtmidiin         (nullptr)
     {
         // Empty body
     }
@@ -115,7 +231,7 @@ struct midi_jack_data
 
     bool valid_buffer () const
     {
-        return not_nullptr(m_jack_buffsize) && not_nullptr(m_jack_buffmessage);
+        return not_nullptr(m_jack_buffoutput);
     }
 
 };          // class midi_jack_data
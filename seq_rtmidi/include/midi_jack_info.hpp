@@ -9,7 +9,7 @@
  * \library       sequencer64 application
  * \author        Chris Ahlstrom
  * \date          2017-01-01
- * \updates       2018-09-14
+ * \updates       2026-10-17
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *    We need to have a way to get all of the JACK information of
@@ -76,6 +76,51 @@ private:
 
     jack_client_t * m_jack_client_2;
 
+    /**
+     *  The tick of the performance when the output thread started its
+     *  current frame, or SEQ64_NULL_MIDIPULSE before playback.  See
+     *  api_frame_tick().
+     */
+
+    midipulse m_frame_tick;
+
+    /**
+     *  The estimated JACK frame time at which m_frame_tick was noted.
+     */
+
+    jack_nframes_t m_frame_time;
+
+    /**
+     *  The number of JACK frames in a tick, at the current tempo.
+     */
+
+    double m_frames_per_tick;
+
+    /**
+     *  The delay added to every frame time, one JACK period.  The events
+     *  played during a period go out in the next one, so this delay puts
+     *  each event at its own offset within that period.  Not used for the
+     *  events rendered in engine mode, which carry their own offsets.
+     */
+
+    jack_nframes_t m_frame_latency;
+
+    /**
+     *  The master bus whose engine_cycle() renders each period, if the
+     *  process callback drives playback (see api_engine()), or a null
+     *  pointer.
+     */
+
+    mastermidibase * m_engine_bus;
+
+    /**
+     *  The events that engine_cycle() renders in each process cycle, which
+     *  the output ports then write at their frames in the same cycle.  Used
+     *  only by the process callback.
+     */
+
+    engine_event m_engine_events[SEQ64_ENGINE_EVENTS];
+
 public:
 
     midi_jack_info
@@ -103,6 +148,12 @@ public:
     virtual void api_set_beats_per_minute (midibpm b);
     virtual void api_port_start (mastermidibus & masterbus, int bus, int port);
     virtual void api_flush ();
+    virtual void api_frame_tick (midipulse tick);
+    virtual midipulse api_input_tick (midipulse stamp);
+    virtual long api_input_age (midipulse stamp);
+    virtual bool api_engine (mastermidibase * masterbus);
+
+    jack_nframes_t frame_time (midipulse tick) const;
 
 private:
 
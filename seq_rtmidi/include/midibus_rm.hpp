@@ -113,6 +113,9 @@ protected:
     virtual void api_stop ();
     virtual void api_clock (midipulse tick);
     virtual void api_play (event * e24, midibyte channel);
+    virtual void api_play_at (event * e24, midibyte channel, midipulse tick);
+    virtual void api_sysex (event * e24);
+    virtual int api_sysex_chunk () const;
 
 };          // class midibus (rtmidi version)
 
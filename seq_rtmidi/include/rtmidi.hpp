@@ -78,6 +78,11 @@ public:
         get_api()->api_play(e24, channel);
     }
 
+    virtual void api_play_at (event * e24, midibyte channel, midipulse tick)
+    {
+        get_api()->api_play_at(e24, channel, tick);
+    }
+
     virtual void api_continue_from (midipulse tick, midipulse beats)
     {
         get_api()->api_continue_from(tick, beats);
@@ -148,6 +153,11 @@ public:
         get_api()->api_sysex(e24);
     }
 
+    virtual int api_sysex_chunk () const
+    {
+        return get_api()->sysex_chunk();
+    }
+
     virtual void api_flush ()
     {
         get_api()->api_flush();
@@ -27,6 +27,7 @@
 
 namespace seq64
 {
+    class mastermidibase;
     class mastermidibus;
 
 /**
@@ -243,6 +244,46 @@ public:
         return get_api_info()->api_set_beats_per_minute(b);
     }
 
+    void api_schedule_beats_per_minute (midibpm b, midipulse tick)
+    {
+        get_api_info()->api_schedule_beats_per_minute(b, tick);
+    }
+
+    bool api_start_scheduling ()
+    {
+        return get_api_info()->api_start_scheduling();
+    }
+
+    void api_cancel_scheduled ()
+    {
+        get_api_info()->api_cancel_scheduled();
+    }
+
+    midipulse api_schedule_tick ()
+    {
+        return get_api_info()->api_schedule_tick();
+    }
+
+    void api_frame_tick (midipulse tick)
+    {
+        get_api_info()->api_frame_tick(tick);
+    }
+
+    midipulse api_input_tick (midipulse stamp)
+    {
+        return get_api_info()->api_input_tick(stamp);
+    }
+
+    long api_input_age (midipulse stamp)
+    {
+        return get_api_info()->api_input_age(stamp);
+    }
+
+    bool api_engine (mastermidibase * masterbus)
+    {
+        return get_api_info()->api_engine(masterbus);
+    }
+
     void api_port_start (mastermidibus & masterbus, int bus, int port)
     {
         get_api_info()->api_port_start(masterbus, bus, port);
@@ -72,7 +72,7 @@ mastermidibus::mastermidibus (int ppqn, midibpm bpm)
     ),
     m_use_jack_polling  (rc().with_jack_midi())
 {
-    // Empty body
+    frame_stamping(m_use_jack_polling);     /* JACK places events by frame  */
 }
 
 /**
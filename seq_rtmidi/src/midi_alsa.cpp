@@ -86,6 +86,7 @@
  */
 
 #include "globals.h"
+#include "alsa_encode.hpp"              /* seq64::alsa_encode_event()       */
 #include "calculations.hpp"             /* clock_ticks_from_ppqn()          */
 #include "event.hpp"                    /* seq64::event (MIDI event)        */
 #include "midibus_rm.hpp"               /* seq64::midibus for rtmidi        */
@@ -144,19 +145,26 @@ midi_alsa::midi_alsa (midibus & parentbus, midi_info & masterinfo)
     m_dest_addr_port    (parentbus.get_port_id()),
     m_local_addr_client (snd_seq_client_id(m_seq)),     /* our client ID    */
     m_local_addr_port   (-1),
-    m_input_port_name   (rc().app_client_name() + " in")
+    m_input_port_name   (rc().app_client_name() + " in"),
+    m_midi_encoder      (nullptr)
 {
     set_bus_id(m_local_addr_client);
     set_name(SEQ64_CLIENT_NAME, bus_name(), port_name());
+    if (snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &m_midi_encoder) < 0)
+    {
+        m_midi_encoder = nullptr;
+        errprint("snd_midi_event_new() error");
+    }
 }
 
 /**
- *  A rote empty virtual destructor.
+ *  The virtual destructor frees the ALSA MIDI encoder.
  */
 
 midi_alsa::~midi_alsa ()
 {
-    // empty body
+    if (not_nullptr(m_midi_encoder))
+        snd_midi_event_free(m_midi_encoder);
 }
 
 /**
@@ -293,12 +301,15 @@ midi_alsa::api_init_in ()
     snd_seq_port_subscribe_set_dest(subs, &dest);       /* local              */
 
     /*
-     * Use the master queue, and get ticks, then subscribe.
+     * Use the master queue, and get its real time, then subscribe.  The
+     * real time tells when each event came in; see midi_alsa_info ::
+     * api_input_age().
      */
 
     int queue = parent_bus().queue_number();
     snd_seq_port_subscribe_set_queue(subs, queue);
     snd_seq_port_subscribe_set_time_update(subs, 1);
+    snd_seq_port_subscribe_set_time_real(subs, 1);
     result = snd_seq_subscribe_port(m_seq, subs);
     if (result < 0)
     {
@@ -486,7 +497,8 @@ midi_alsa::api_deinit_in ()
 
     int queue = parent_bus().queue_number();
     snd_seq_port_subscribe_set_queue(subs, queue);
-    snd_seq_port_subscribe_set_time_update(subs, queue);    /* get ticks    */
+    snd_seq_port_subscribe_set_time_update(subs, queue);    /* get times    */
+    snd_seq_port_subscribe_set_time_real(subs, 1);          /* real time    */
 
     int result = snd_seq_unsubscribe_port(m_seq, subs);     /* unsubscribe  */
     if (result < 0)
@@ -525,14 +537,6 @@ midi_alsa::api_deinit_in ()
  *
  */
 
-/**
- *  Defines the size of the MIDI event buffer, which should be large enough to
- *  accomodate the largest MIDI message to be encoded.
- *  A local define for visibility.
- */
-
-#define SEQ64_MIDI_EVENT_SIZE_MAX   10
-
 /**
  *  This play() function takes a native event, encodes it to an ALSA MIDI
  *  sequencer event, sets the broadcasting to the subscribers, sets the
@@ -551,19 +555,47 @@ midi_alsa::api_deinit_in ()
 
 void
 midi_alsa::api_play (event * e24, midibyte channel)
+{
+    api_play_at(e24, channel, SEQ64_NULL_MIDIPULSE);
+}
+
+/**
+ *  Like api_play(), but schedules the event on the ALSA queue of the parent
+ *  buss at the given tick, rather than sending it directly.
+ *
+ * \threadsafe
+ *
+ * \param e24
+ *      The event to be played on this bus.  For speed, we don't bother to
+ *      check the pointer.
+ *
+ * \param channel
+ *      The channel of the playback.
+ *
+ * \param tick
+ *      The tick of the queue at which the event is to be delivered.  If
+ *      SEQ64_NULL_MIDIPULSE, the event is sent directly.
+ */
+
+void
+midi_alsa::api_play_at (event * e24, midibyte channel, midipulse tick)
 {
     midibyte buffer[4];                             /* temp for MIDI data   */
     buffer[0] = e24->get_status();                  /* fill buffer          */
     buffer[0] += (channel & 0x0F);
     e24->get_data(buffer[1], buffer[2]);            /* set MIDI data        */
 
-    snd_midi_event_t * midi_ev;                     /* ALSA MIDI parser     */
-    snd_midi_event_new(SEQ64_MIDI_EVENT_SIZE_MAX, &midi_ev);
-
     snd_seq_event_t ev;
     snd_seq_ev_clear(&ev);                          /* clear event          */
-    snd_midi_event_encode(midi_ev, buffer, 3, &ev); /* encode 3 raw bytes   */
-    snd_midi_event_free(midi_ev);                   /* free the parser      */
+    if
+    (
+        ! alsa_encode_event(ev, buffer[0], buffer[1], buffer[2]) &&
+        not_nullptr(m_midi_encoder)
+    )
+    {
+        snd_midi_event_reset_encode(m_midi_encoder);    /* no leftovers     */
+        snd_midi_event_encode(m_midi_encoder, buffer, 3, &ev);
+    }
     snd_seq_ev_set_source(&ev, m_local_addr_port);  /* set source           */
 
 #ifdef SEQ64_SHOW_API_CALLS_XXX                     /* Too Much Information */
@@ -571,7 +603,13 @@ midi_alsa::api_play (event * e24, midibyte channel)
 #endif
 
     snd_seq_ev_set_subs(&ev);
-    snd_seq_ev_set_direct(&ev);                     /* it is immediate      */
+    if (is_null_midipulse(tick))
+        snd_seq_ev_set_direct(&ev);                 /* it is immediate      */
+    else
+    {
+        int queue = parent_bus().queue_number();
+        snd_seq_ev_schedule_tick(&ev, queue, 0, tick);
+    }
     snd_seq_event_output(m_seq, &ev);               /* pump into the queue  */
 }
 
@@ -594,16 +632,12 @@ min (long a, long b)
     return (a < b) ? a : b ;
 }
 
-/**
- *  Defines the value used for sleeping, in microseconds.  Defined locally
- *  simply for visibility.  Why 80000?
- */
-
-#define SEQ64_USLEEP_US     80000
-
 /**
  *  Takes a native SYSEX event, encodes it to an ALSA event, and then
- *  puts it in the queue.
+ *  puts it in the queue.  This function no longer sleeps between the
+ *  chunks; mastermidibase::sysex() hands the event to a sysex_sender, which
+ *  calls this function with one chunk at a time, paced at the "rc"
+ *  [sysex-output] rate.
  *
  * \param e24
  *      The event to be handled.
@@ -640,7 +674,6 @@ midi_alsa::api_sysex (event * e24)
         int data_left = data_size - offset;
         snd_seq_ev_set_sysex(&ev, min(data_left, chunk), &data[offset]);
         snd_seq_event_output_direct(m_seq, &ev);        /* pump into queue  */
-        usleep(SEQ64_USLEEP_US);
         api_flush();
     }
 }
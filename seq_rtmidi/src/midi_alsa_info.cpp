@@ -88,6 +88,31 @@
 namespace seq64
 {
 
+/**
+ *  Converts the real-time stamp of an ALSA input event to the timestamp of
+ *  a Sequencer64 event, in microseconds of the queue real time.  The value
+ *  wraps around where a long does; see api_input_age().
+ *
+ * \param ev
+ *      The ALSA event.
+ *
+ * \return
+ *      Returns the stamp, or SEQ64_NULL_MIDIPULSE if the event was not
+ *      stamped with the real time.
+ */
+
+static midipulse
+alsa_input_stamp (const snd_seq_event_t * ev)
+{
+    if (! snd_seq_ev_is_real(ev))
+        return SEQ64_NULL_MIDIPULSE;
+
+    unsigned long us = (unsigned long)(ev->time.time.tv_sec) * 1000000UL +
+        ev->time.time.tv_nsec / 1000;
+
+    return midipulse(us);
+}
+
 /*
  * Initialization of static members.
  */
@@ -393,6 +418,126 @@ midi_alsa_info::api_set_beats_per_minute (midibpm b)
     snd_seq_set_queue_tempo(m_alsa_seq, queue, tempo);
 }
 
+/**
+ *  Sets the BPM numeric value, and schedules the change of the ALSA queue
+ *  tempo at the given tick, so that the events queued ahead of it keep the
+ *  old tempo.
+ *
+ * \param b
+ *      The desired new BPM value to set.
+ *
+ * \param tick
+ *      The tick of the queue at which the tempo changes.
+ */
+
+void
+midi_alsa_info::api_schedule_beats_per_minute (midibpm b, midipulse tick)
+{
+    midi_info::api_set_beats_per_minute(b);
+
+    int queue = global_queue();
+    snd_seq_event_t ev;
+    snd_seq_ev_clear(&ev);
+    snd_seq_ev_schedule_tick(&ev, queue, 0, tick);
+    snd_seq_change_queue_tempo
+    (
+        m_alsa_seq, queue, int(tempo_us_from_bpm(b)), &ev
+    );
+}
+
+/**
+ *  Restarts the ALSA queue at tick 0, for scheduled output.  The events
+ *  still pending from the last run, such as Note Offs, are let out first.
+ *
+ * \return
+ *      Always returns true, the ALSA queue can schedule events.
+ */
+
+bool
+midi_alsa_info::api_start_scheduling ()
+{
+    snd_seq_drain_output(m_alsa_seq);
+    snd_seq_sync_output_queue(m_alsa_seq);
+    snd_seq_start_queue(m_alsa_seq, global_queue(), NULL);  /* tick 0   */
+    snd_seq_drain_output(m_alsa_seq);
+    return true;
+}
+
+/**
+ *  Removes the events still waiting in the ALSA queue, from our output
+ *  buffer and from the queue itself, except the Note Offs, which go out on
+ *  time.
+ */
+
+void
+midi_alsa_info::api_cancel_scheduled ()
+{
+    snd_seq_drain_output(m_alsa_seq);
+
+    snd_seq_remove_events_t * remove;
+    snd_seq_remove_events_alloca(&remove);
+    snd_seq_remove_events_set_condition
+    (
+        remove, SND_SEQ_REMOVE_OUTPUT | SND_SEQ_REMOVE_IGNORE_OFF
+    );
+    snd_seq_remove_events_set_queue(remove, global_queue());
+    snd_seq_remove_events(m_alsa_seq, remove);
+}
+
+/**
+ *  Gets the current tick of the ALSA queue.
+ *
+ * \return
+ *      Returns the tick, or SEQ64_NULL_MIDIPULSE if the status of the queue
+ *      cannot be obtained.
+ */
+
+midipulse
+midi_alsa_info::api_schedule_tick ()
+{
+    snd_seq_queue_status_t * status;
+    snd_seq_queue_status_alloca(&status);
+    if (snd_seq_get_queue_status(m_alsa_seq, global_queue(), status) < 0)
+        return SEQ64_NULL_MIDIPULSE;
+
+    return midipulse(snd_seq_queue_status_get_tick_time(status));
+}
+
+/**
+ *  Gets the age of an input event, from the real time of the ALSA queue at
+ *  which it came in, as stamped by api_get_midi_event().  Identical to
+ *  seq_alsamidi's mastermidibus :: api_input_age().
+ *
+ * \param stamp
+ *      The timestamp of the event.
+ *
+ * \return
+ *      Returns the number of microseconds since the event came in, or 0 if
+ *      the event has no real-time stamp or the queue cannot be read.
+ */
+
+long
+midi_alsa_info::api_input_age (midipulse stamp)
+{
+    long result = 0;
+    if (! is_null_midipulse(stamp))
+    {
+        snd_seq_queue_status_t * status;
+        snd_seq_queue_status_alloca(&status);
+        if (snd_seq_get_queue_status(m_alsa_seq, global_queue(), status) == 0)
+        {
+            const snd_seq_real_time_t * rt =
+                snd_seq_queue_status_get_real_time(status);
+
+            unsigned long now = (unsigned long)(rt->tv_sec) * 1000000UL +
+                rt->tv_nsec / 1000;
+
+            result = long(now - (unsigned long)(stamp));
+        }
+    }
+    return result;
+}
+
 /**
  *  Polls for any ALSA MIDI information using a timeout value of 1000
  *  milliseconds.  Identical to seq_alsamidi's mastermidibus ::
@@ -641,13 +786,15 @@ midi_alsa_info::api_get_midi_event (event * inev)
     }
 
     /*
-     *  Note that ev->time.tick is always 0!  (Same in Seq32).
+     *  Note that ev->time.tick is always 0!  (Same in Seq32).  The input
+     *  subscriptions get the real time of the queue instead.
      */
 
     long bytes = snd_midi_event_decode(midi_ev, buffer, sizeof buffer, ev);
     if (bytes > 0)
     {
-        result = inev->set_midi_event(ev->time.tick, buffer, bytes);
+        midipulse stamp = alsa_input_stamp(ev);
+        result = inev->set_midi_event(stamp, buffer, bytes);
         if (result)
         {
             bool sysex = inev->is_sysex();
@@ -6,7 +6,7 @@
  * \library       sequencer64 application
  * \author        Gary P. Scavone; severe refactoring by Chris Ahlstrom
  * \date          2016-11-14
- * \updates       2020-05-24
+ * \updates       2026-10-17
  * \license       See the rtexmidi.lic file.  Too big for a header file.
  *
  *  Written primarily by Alexander Svetalkin, with updates for delta time by
@@ -147,6 +147,8 @@
 
 #ifdef SEQ64_JACK_SUPPORT
 
+#include <cstdio>                       /* std::printf()                    */
+#include <cstring>                      /* std::memcpy()                    */
 #include <sstream>
 
 #include <jack/midiport.h>
@@ -155,15 +157,26 @@
 #include "easy_macros.hpp"              /* C++ version of easy macros       */
 #include "event.hpp"                    /* seq64::event from main library   */
 #include "jack_assistant.hpp"           /* seq64::jack_status_pair_t        */
+#include "mastermidibase.hpp"           /* seq64::engine_event              */
 #include "midibus_rm.hpp"               /* seq64::midibus for rtmidi        */
 #include "midi_jack.hpp"                /* seq64::midi_jack                 */
 #include "settings.hpp"                 /* seq64::rc() accessor function    */
 
 /**
- *  Delimits the size of the JACK ringbuffer.
+ *  Delimits the number of events that one JACK output port can sort and
+ *  write in one process cycle.  The rest wait for the next cycle.
  */
 
-#define JACK_RINGBUFFER_SIZE 16384      /* default size for ringbuffer  */
+#define SEQ64_JACK_CYCLE_EVENTS   256
+
+/**
+ *  An estimate of the space that the JACK port buffer uses for each event,
+ *  besides the bytes of the event.  JACK does not export the size of its
+ *  event header, so this errs on the large side.  Used to keep from
+ *  reserving more in a cycle than the port buffer holds.
+ */
+
+#define SEQ64_JACK_EVENT_OVERHEAD   8
 
 /*
  * Do not document the namespace; it breaks Doxygen.
@@ -172,6 +185,320 @@
 namespace seq64
 {
 
+/**
+ *  One event taken for the current process cycle.  Its bytes are not
+ *  copied; they are left where they are, in the output ringbuffer or in the
+ *  carry-over store, until they are written to the port buffer.  Bytes in
+ *  the ringbuffer may wrap around its end, and so come in two parts.
+ */
+
+struct jack_cycle_item
+{
+    jack_nframes_t offset;                      /* frame in this cycle      */
+    const char * part1;                         /* the first part of bytes  */
+    size_t size1;                               /* bytes in the first part  */
+    const char * part2;                         /* the rest of the bytes    */
+    size_t size;                                /* bytes in the message     */
+};
+
+/**
+ *  Locates bytes in the space given by jack_ringbuffer_get_read_vector(),
+ *  which may wrap around the end of the ringbuffer.  The caller has made
+ *  sure that the bytes are there.
+ *
+ * \param vec
+ *      The two parts of the read space of the ringbuffer.
+ *
+ * \param offset
+ *      The offset of the bytes in the read space.
+ *
+ * \param count
+ *      The number of bytes.
+ *
+ * \param [out] item
+ *      Gets the location of the bytes.  The offset is not touched.
+ */
+
+static void
+jack_vector_span
+(
+    const jack_ringbuffer_data_t * vec,
+    size_t offset,
+    size_t count,
+    jack_cycle_item & item
+)
+{
+    if (offset < vec[0].len)
+    {
+        size_t n0 = vec[0].len - offset;
+        item.part1 = vec[0].buf + offset;
+        item.size1 = count < n0 ? count : n0 ;
+        item.part2 = vec[1].buf;
+    }
+    else
+    {
+        item.part1 = vec[1].buf + (offset - vec[0].len);
+        item.size1 = count;
+        item.part2 = nullptr;
+    }
+    item.size = count;
+}
+
+/**
+ *  Copies the bytes located by jack_vector_span() or set up for the carry
+ *  store.
+ *
+ * \param item
+ *      The location of the bytes.
+ *
+ * \param dest
+ *      The destination, which has room for item.size bytes.
+ */
+
+static void
+jack_cycle_copy (const jack_cycle_item & item, char * dest)
+{
+    std::memcpy(dest, item.part1, item.size1);
+    if (item.size > item.size1)
+        std::memcpy(dest + item.size1, item.part2, item.size - item.size1);
+}
+
+/**
+ *  Checks if one more event can be taken in the current process cycle.
+ *
+ * \param count
+ *      The number of events already taken.
+ *
+ * \param used
+ *      The number of bytes already taken.
+ *
+ * \param space
+ *      The number of bytes in the event.
+ *
+ * \param room
+ *      The space in the JACK port buffer.
+ *
+ * \return
+ *      Returns 1 if the event fits, 0 if it must wait for the next cycle,
+ *      and -1 if it can never fit in a cycle, and must be dropped.
+ */
+
+static int
+jack_cycle_fits (int count, size_t used, size_t space, size_t room)
+{
+    if (count == SEQ64_JACK_CYCLE_EVENTS)
+        return 0;
+
+    size_t need = used + space + size_t(count + 1) * SEQ64_JACK_EVENT_OVERHEAD;
+    if (need > room)
+        return count > 0 ? 0 : -1 ;
+
+    return 1;
+}
+
+/**
+ *  Adds an event to the items of the current process cycle, after every
+ *  event at the same or an earlier offset.
+ *
+ * \param items
+ *      The events taken so far, sorted by offset.
+ *
+ * \param [out] count
+ *      The number of events, which is incremented.
+ *
+ * \param ahead
+ *      The number of frames from the start of the cycle to the event.  It
+ *      is clamped to the cycle; a late event is played at once.
+ *
+ * \param nframes
+ *      The number of frames in the cycle.
+ *
+ * \param item
+ *      The location of the bytes of the event.
+ */
+
+static void
+jack_cycle_insert
+(
+    jack_cycle_item * items, int & count, long ahead,
+    jack_nframes_t nframes, const jack_cycle_item & item
+)
+{
+    if (ahead >= long(nframes))
+        ahead = long(nframes) - 1;
+    else if (ahead < 0)
+        ahead = 0;                              /* late, play at once       */
+
+    int i = count++;
+    while (i > 0 && items[i - 1].offset > jack_nframes_t(ahead))
+    {
+        items[i] = items[i - 1];
+        --i;
+    }
+    items[i] = item;
+    items[i].offset = jack_nframes_t(ahead);
+}
+
+/**
+ *  Copies bytes into the space given by jack_ringbuffer_get_write_vector(),
+ *  which may wrap around the end of the ringbuffer.  The caller has made
+ *  sure that the bytes fit.
+ *
+ * \param vec
+ *      The two parts of the write space of the ringbuffer.
+ *
+ * \param [in,out] offset
+ *      The offset into the write space at which to copy.  It is advanced
+ *      past the copied bytes.
+ *
+ * \param src
+ *      The bytes to copy.
+ *
+ * \param count
+ *      The number of bytes to copy.
+ */
+
+static void
+jack_vector_copy
+(
+    jack_ringbuffer_data_t * vec,
+    size_t & offset,
+    const char * src,
+    size_t count
+)
+{
+    size_t n0 = offset < vec[0].len ? vec[0].len - offset : 0 ;
+    if (n0 > count)
+        n0 = count;
+
+    if (n0 > 0)
+        std::memcpy(vec[0].buf + offset, src, n0);
+
+    if (count > n0)
+    {
+        size_t n1 = offset + n0 - vec[0].len;       /* offset into part 2   */
+        std::memcpy(vec[1].buf + n1, src + n0, count - n0);
+    }
+
+    offset += count;
+}
+
+/**
+ *  Writes one outgoing MIDI message to the output ringbuffer as a framed
+ *  record, its midi_jack_header followed by its bytes.  The record is
+ *  copied into the write space, and only then is the write pointer
+ *  advanced, so the process callback sees all of the record or none of it.
+ *  If the record does not fit, it is dropped and counted.
+ *
+ * \param jackdata
+ *      The data of the output port.
+ *
+ * \param header
+ *      The frame and the size of the message.
+ *
+ * \param data
+ *      The bytes of the message.
+ *
+ * \return
+ *      Returns true if the message was written.
+ */
+
+static bool
+jack_write_output_record
+(
+    midi_jack_data & jackdata,
+    const midi_jack_header & header,
+    const midibyte * data
+)
+{
+    jack_ringbuffer_t * ring = jackdata.m_jack_buffoutput;
+    size_t total = sizeof header + size_t(header.mjh_size);
+    bool result = jack_ringbuffer_write_space(ring) >= total;
+    if (result)
+    {
+        jack_ringbuffer_data_t vec[2];
+        size_t offset = 0;
+        jack_ringbuffer_get_write_vector(ring, vec);
+        jack_vector_copy
+        (
+            vec, offset, reinterpret_cast<const char *>(&header), sizeof header
+        );
+        jack_vector_copy
+        (
+            vec, offset, reinterpret_cast<const char *>(data),
+            size_t(header.mjh_size)
+        );
+        jack_ringbuffer_write_advance(ring, total);
+
+        size_t held = jack_ringbuffer_read_space(ring);
+        if (held > jackdata.m_jack_high_water)
+            jackdata.m_jack_high_water = held;
+    }
+    else
+        ++jackdata.m_jack_drops;
+
+    return result;
+}
+
+/**
+ *  Writes one incoming MIDI message to the input ringbuffer, as one or more
+ *  midi_jack_record items.  The message is written only if all of its
+ *  records fit, and the first record gives the size of the whole message,
+ *  so the reader can wait until all of them are in.
+ *
+ * \param ring
+ *      The input ringbuffer of the port.
+ *
+ * \param frame
+ *      The absolute JACK frame of the message.
+ *
+ * \param data
+ *      The bytes of the message.
+ *
+ * \param count
+ *      The number of bytes in the message.
+ *
+ * \return
+ *      Returns true if the message was written.
+ */
+
+static bool
+jack_write_input_records
+(
+    jack_ringbuffer_t * ring,
+    jack_nframes_t frame,
+    const jack_midi_data_t * data,
+    int count
+)
+{
+    size_t records = (count + SEQ64_JACK_RECORD_BYTES - 1) /
+        SEQ64_JACK_RECORD_BYTES;
+
+    bool result = records > 0 &&
+        jack_ringbuffer_write_space(ring) >= records * sizeof(midi_jack_record);
+
+    if (result)
+    {
+        midi_jack_record record;
+        record.mjr_frame = frame;
+        record.mjr_size = count;
+        while (count > 0)
+        {
+            int n = count < SEQ64_JACK_RECORD_BYTES ?
+                count : SEQ64_JACK_RECORD_BYTES ;
+
+            std::memcpy(record.mjr_bytes, data, size_t(n));
+            (void) jack_ringbuffer_write
+            (
+                ring, reinterpret_cast<const char *>(&record), sizeof record
+            );
+            data += n;
+            count -= n;
+        }
+    }
+    return result;
+}
+
 /**
  *  Defines the JACK input process callback.  It is the JACK process callback
  *  for a MIDI output port (e.g. "system:midi_capture_1", which gives us the
@@ -183,20 +510,16 @@ namespace seq64
  *
  *      -#  Get the JACK port buffer and the MIDI event-count into this
  *          buffer.
- *      -#  For each MIDI event, get the event from JACK and push it into a
- *          local midi_message object.
- *      -#  Get the event time, converting it to a delta time if possible.
- *      -#  If it is not a SysEx continuation, then:
- *          -#  If we're using a callback, pass the data to that callback.  Do
- *              we need this callback to interface with the midibus-based
- *              code?
- *          -#  Otherwise, add the midi_message container to the rtmidi input
- *              queue.  One can then grab this data in a midibase ::
- *              poll_for_midi() call.  We still ought to check the add
- *              success.
- *
- *  The ALSA code polls for events, and that model is also available here.
- *  We're still working exactly how it will work best.
+ *      -#  For each MIDI event, get the event from JACK.  Its absolute
+ *          frame is jack_last_frame_time() plus its offset in the cycle.
+ *      -#  If it is not a SysEx continuation, write it, with its frame, to
+ *          the input ringbuffer as one or more fixed-size midi_jack_record
+ *          items.  If the ringbuffer is full, the event is dropped.
+ *
+ *  Nothing is allocated and nothing is locked here.  The input thread reads
+ *  the records in midi_in_jack::api_poll_for_midi() and
+ *  midi_in_jack::api_get_midi_event(), and calls the rtmidi callback, if
+ *  one is used.
  *
  *  This function used to be static, but now we make it available to
  *  midi_jack_info.  Also note the s_null_detected flag.  It is used only to
@@ -247,45 +570,26 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
      */
 
     void * buff = jack_port_get_buffer(jackdata->m_jack_port, nframes);
-    if (not_nullptr(buff))
+    jack_ringbuffer_t * ring = jackdata->m_jack_buffinput;
+    if (not_nullptr(buff) && not_nullptr(ring))
     {
         rtmidi_in_data * rtindata = jackdata->m_jack_rtmidiin;
+        jack_client_t * client = jackdata->m_jack_client;
+        jack_nframes_t lastframe = jack_last_frame_time(client);
         jack_midi_event_t jmevent;
-        jack_time_t jtime;
         int evcount = jack_midi_get_event_count(buff);
         for (int j = 0; j < evcount; ++j)
         {
             int rc = jack_midi_event_get(&jmevent, buff, j);
             if (rc == 0)
             {
-                midi_message message;
-                int eventsize = int(jmevent.size);
-                for (int i = 0; i < eventsize; ++i)
-                    message.push(jmevent.buffer[i]);
-
-                jack_time_t delta_jtime;
-                jtime = jack_get_time();            /* compute delta time   */
-                if (rtindata->first_message())
-                {
-                    rtindata->first_message(false);
-                    delta_jtime = jack_time_t(0);
-                }
-                else
-                {
-                    jtime -= jackdata->m_jack_lasttime;
-                    delta_jtime = jack_time_t(jtime * 0.000001);
-                }
-                message.timestamp(delta_jtime);
-                jackdata->m_jack_lasttime = jtime;
                 if (! rtindata->continue_sysex())
                 {
-                    if (rtindata->using_callback())
-                    {
-                        rtmidi_callback_t callback = rtindata->user_callback();
-                        callback(message, rtindata->user_data());
-                    }
-                    else
-                        (void) rtindata->queue().add(message);
+                    (void) jack_write_input_records
+                    (
+                        ring, lastframe + jmevent.time,
+                        jmevent.buffer, int(jmevent.size)
+                    );
                 }
             }
             else
@@ -312,19 +616,28 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
  *  Client" by qjackctl.  Here's how it works:
  *
  *      -#  Get the JACK port buffer, for our local jack port.  Clear it.
- *      -#  Loop while the number of bytes available for reading [via
- *          jack_ringbuffer_read_space()] is non-zero.  Note that the second
- *          parameter is where the data is copied.
- *      -#  Get the size of each event, and allocate space for an event to be
- *          written to an event port buffer (the JACK "reserve" function).
- *      -#  Read the data from the ringbuffer into this port buffer.  JACK
- *          should then send it to the remote port.
+ *      -#  Loop while a message header is available for reading [via
+ *          jack_ringbuffer_read_space()].
+ *      -#  Peek at the header of each event.  If its frame is past the end
+ *          of this cycle, stop; it stays in the ringbuffer for the next
+ *          cycle.  Otherwise, its offset in the cycle is its frame minus
+ *          jack_last_frame_time(), or 0 for a late event.  Copy the event
+ *          to a stack array, sorted by that offset.
+ *      -#  For each sorted event, allocate space for it in the port buffer
+ *          at its offset (the JACK "reserve" function), and copy the data
+ *          into this port buffer.  JACK should then send it to the remote
+ *          port.
  *
  *  Since this is an output port, "buff" is the area to which we can write
  *  data, to send it to the "remote" (i.e. outside our application) port.  The
  *  data is written to the ringbuffer in api_init_out(), and here we read the
  *  ring buffer and pass it to the output buffer.
  *
+ *  In engine mode, the events that jack_process_io() has just rendered for
+ *  this cycle (see mastermidibase::engine_cycle()) are taken first, each at
+ *  its own offset.  They come from a fixed array, not the ringbuffer, and
+ *  there is no next cycle for them, so one that does not fit is dropped.
+ *
  *  We were wondering if, like the JACK midiseq example program, we need to
  *  wrap the out-process in a for-loop over the number of frames.  In our
  *  tests, we are getting 1024 frames, and the code seems to work without that
@@ -343,7 +656,6 @@ jack_process_rtmidi_input (jack_nframes_t nframes, void * arg)
 int
 jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
 {
-    static size_t s_offset = 0;
     midi_jack_data * jackdata = reinterpret_cast<midi_jack_data *>(arg);
 
 #ifdef SEQ64_USE_DEBUG_OUTPUT
@@ -357,7 +669,7 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
         }
         return 0;
     }
-    if (is_nullptr(jackdata->m_jack_buffsize))      /* port set up?         */
+    if (is_nullptr(jackdata->m_jack_buffoutput))    /* port set up?         */
     {
         if (! s_null_detected)
         {
@@ -371,6 +683,8 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
     void * buf = jack_port_get_buffer(jackdata->m_jack_port, nframes);
     jack_midi_clear_buffer(buf);                    /* no nullptr test      */
 
+    size_t room = jack_midi_max_event_size(buf);    /* port buffer space    */
+
 #ifdef SEQ64_SHOW_API_CALLS_TMI
     printf
     (
@@ -380,47 +694,181 @@ jack_process_rtmidi_output (jack_nframes_t nframes, void * arg)
 #endif
 
     /*
-     * A for-loop over the number of nframes?  See discussion above.
      * Why are we reading here?  That's where our app has dumped the next set
-     * of MIDI events to output.
+     * of MIDI events to output.  Each one goes at the offset of its frame in
+     * this cycle.  An offset of nframes or more is due in a later cycle, but
+     * one more than a second ahead can only come from a bad frame time, and
+     * is played now, so that it cannot hold up the ringbuffer.
+     *
+     * A record due in a later cycle is moved to the carry-over store of the
+     * port, so that the records behind it, such as untimed messages, still
+     * go out in this cycle.  The carried records are older than the ones in
+     * the ringbuffer, so they are looked at first in each cycle.  Only when
+     * the store is full does the rest of the ringbuffer wait.
+     *
+     * The patterns write their events in pattern order, not time order, so
+     * the events due in this cycle are first sorted by offset, since JACK
+     * needs the offsets in order.  The sort is stable, so that events at
+     * the same offset keep the order they were written.  Only the places of
+     * the events are sorted; their bytes stay where they are until they are
+     * written to the port buffer, and only then is the ringbuffer advanced.
+     *
+     * Only as many events are taken as fit in the port buffer, so that
+     * jack_midi_event_reserve() does not fail.  A SysEx message (see
+     * api_sysex()) is one event, and waits for a cycle that has room for
+     * all of it.  One too big for even an empty port buffer is dropped.
      */
 
-    while (jack_ringbuffer_read_space(jackdata->m_jack_buffsize) > 0)
+    jack_nframes_t lastframe = jack_last_frame_time(jackdata->m_jack_client);
+    jack_nframes_t rate = jack_get_sample_rate(jackdata->m_jack_client);
+    jack_cycle_item items[SEQ64_JACK_CYCLE_EVENTS];
+    jack_cycle_item item;
+    int count = 0;
+    size_t used = 0;
+    bool full = false;                              /* rest in next cycle   */
+    char * carry = jackdata->m_jack_carry;
+    int carried = jackdata->m_jack_carry_used;
+    int kept = carried;                             /* carry bytes in use   */
+    midi_jack_header header;
+    for (int e = 0; e < jackdata->m_jack_engine_count; ++e)
     {
-        int space;
-        (void) jack_ringbuffer_read
-        (
-            jackdata->m_jack_buffsize, (char *) &space, sizeof space
-        );
+        const engine_event & ee = jackdata->m_jack_engine[e];
+        if (int(ee.ee_bus) == jackdata->m_jack_engine_bus)
+        {
+            size_t space = size_t(ee.ee_size);
+            int fits = jack_cycle_fits(count, used, space, room);
+            if (fits > 0)
+            {
+                item.part1 = reinterpret_cast<const char *>(ee.ee_data);
+                item.size1 = item.size = space;
+                item.part2 = nullptr;
+                jack_cycle_insert(items, count, ee.ee_frame, nframes, item);
+                used += space;
+            }
+            else
+                ++jackdata->m_jack_cycle_drops;     /* see api_flush()      */
+        }
+    }
+    for (int r = 0; r < carried; /* r is advanced below */)
+    {
+        std::memcpy(&header, &carry[r], sizeof header);
 
-        /*
-         * s_offset is always zero. Using nframes instead of s_offset = 0
-         * causes notes not to be played.  Probably because this is a write
-         * operation?
-         */
+        int space = header.mjh_size;
+        int record = int(sizeof header) + space;
+        long ahead = long(int32_t(header.mjh_frame - lastframe));
+        if (ahead < long(nframes) || ahead > long(rate))
+        {
+            int fits = jack_cycle_fits(count, used, size_t(space), room);
+            if (fits == 0)
+            {
+                full = true;
+                break;                              /* rest in next cycle   */
+            }
+            if (fits > 0)
+            {
+                item.part1 = &carry[r + int(sizeof header)];
+                item.size1 = item.size = size_t(space);
+                item.part2 = nullptr;
+                jack_cycle_insert(items, count, ahead, nframes, item);
+                used += size_t(space);
+            }
+            else
+                ++jackdata->m_jack_cycle_drops;     /* see api_flush()      */
+
+            header.mjh_size = -space;               /* taken, remove below  */
+            std::memcpy(&carry[r], &header, sizeof header);
+        }
+        r += record;
+    }
+
+    jack_ringbuffer_t * ring = jackdata->m_jack_buffoutput;
+    jack_ringbuffer_data_t vec[2];
+    jack_ringbuffer_get_read_vector(ring, vec);
+
+    size_t readable = vec[0].len + vec[1].len;
+    size_t pos = 0;                                 /* bytes to advance     */
+    while (! full && readable - pos >= sizeof header)
+    {
+        jack_vector_span(vec, pos, sizeof header, item);
+        jack_cycle_copy(item, reinterpret_cast<char *>(&header));
+
+        size_t space = size_t(header.mjh_size);
+        size_t record = sizeof header + space;
+        long ahead = long(int32_t(header.mjh_frame - lastframe));
+        jack_vector_span(vec, pos + sizeof header, space, item);
+        if (ahead >= long(nframes) && ahead <= long(rate))
+        {
+            if (size_t(kept) + record > SEQ64_JACK_CARRY_BYTES)
+                break;                              /* store full, wait     */
+
+            std::memcpy(&carry[kept], &header, sizeof header);
+            jack_cycle_copy(item, &carry[kept + int(sizeof header)]);
+            kept += int(record);                    /* due in a later cycle */
+            pos += record;
+            continue;
+        }
+
+        int fits = jack_cycle_fits(count, used, space, room);
+        if (fits == 0)
+            break;                                  /* rest in next cycle   */
+
+        if (fits > 0)
+        {
+            jack_cycle_insert(items, count, ahead, nframes, item);
+            used += space;
+        }
+        else
+            ++jackdata->m_jack_cycle_drops;         /* see api_flush()      */
 
-        jack_midi_data_t * md = jack_midi_event_reserve(buf, s_offset, space);
+        pos += record;
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        jack_midi_data_t * md = jack_midi_event_reserve
+        (
+            buf, items[i].offset, items[i].size
+        );
         if (not_nullptr(md))
         {
-            char * mididata = reinterpret_cast<char *>(md);
-            (void) jack_ringbuffer_read         /* copy into mididata */
-            (
-                jackdata->m_jack_buffmessage, mididata, size_t(space)
-            );
+            jack_cycle_copy(items[i], reinterpret_cast<char *>(md));
 
 #ifdef SEQ64_SHOW_API_CALLS_TMI
-            printf("%d bytes read: ", space);
-            for (int i = 0; i < space; ++i)
-                printf("%x ", (unsigned char)(mididata[i]));
+            printf("%d bytes read: ", int(items[i].size));
+            for (size_t b = 0; b < items[i].size; ++b)
+                printf("%x ", unsigned(md[b]));
 
             printf("\n");
 #endif
         }
         else
+            ++jackdata->m_jack_cycle_drops;         /* see api_flush()      */
+    }
+    if (pos > 0)
+        jack_ringbuffer_read_advance(ring, pos);
+
+    /*
+     * Now that their bytes are written, remove the carried records that
+     * were taken, keeping the order of the rest.
+     */
+
+    int w = 0;
+    for (int r = 0; r < kept; /* r is advanced below */)
+    {
+        std::memcpy(&header, &carry[r], sizeof header);
+
+        bool taken = header.mjh_size < 0;
+        int space = taken ? -header.mjh_size : header.mjh_size ;
+        int record = int(sizeof header) + space;
+        if (! taken)
         {
-            errprint("jack_midi_event_reserve() returned a null pointer");
+            if (w < r)
+                std::memmove(&carry[w], &carry[r], size_t(record));
+
+            w += record;
         }
+        r += record;
     }
+    jackdata->m_jack_carry_used = w;
     return 0;
 }
 
@@ -467,11 +915,24 @@ midi_jack::midi_jack
 
 midi_jack::~midi_jack ()
 {
-    if (not_nullptr(m_jack_data.m_jack_buffsize))
-        jack_ringbuffer_free(m_jack_data.m_jack_buffsize);
+    if (not_nullptr(m_jack_data.m_jack_buffoutput))
+    {
+        if (rc().stats())
+        {
+            printf
+            (
+                "JACK port %s: %d dropped (ring full), %d dropped in callback, "
+                "high water %d of %d bytes\n",
+                port_name().c_str(), m_jack_data.m_jack_drops,
+                int(m_jack_data.m_jack_cycle_drops),
+                int(m_jack_data.m_jack_high_water), rc().jack_ring_size()
+            );
+        }
+        jack_ringbuffer_free(m_jack_data.m_jack_buffoutput);
+    }
 
-    if (not_nullptr(m_jack_data.m_jack_buffmessage))
-        jack_ringbuffer_free(m_jack_data.m_jack_buffmessage);
+    if (not_nullptr(m_jack_data.m_jack_buffinput))
+        jack_ringbuffer_free(m_jack_data.m_jack_buffinput);
 
     apiprint("~midi_jack", "jack");
 }
@@ -500,7 +961,7 @@ midi_jack::api_init_out ()
     std::string remoteportname = connect_name();    /* "bus:port"   */
     remote_port_name(remoteportname);
 
-    bool result = create_ringbuffer(JACK_RINGBUFFER_SIZE);
+    bool result = create_ringbuffer(rc().jack_ring_size());
     if (result)
     {
         set_alt_name
@@ -569,7 +1030,9 @@ midi_jack::api_init_in ()
     (
         rc().application_name(), rc().app_client_name(), remoteportname
     );
-    bool result = register_port(SEQ64_MIDI_INPUT_PORT, port_name());
+    bool result = create_input_ringbuffer(rc().jack_ring_size());
+    if (result)
+        result = register_port(SEQ64_MIDI_INPUT_PORT, port_name());
 
     /*
      * Note that we cannot connect ports until we are activated, and we
@@ -668,7 +1131,7 @@ midi_jack::api_init_out_sub ()
         result = portid >= 0;
     }
     if (result)
-        result = create_ringbuffer(JACK_RINGBUFFER_SIZE);
+        result = create_ringbuffer(rc().jack_ring_size());
 
     if (result)
     {
@@ -706,6 +1169,9 @@ midi_jack::api_init_in_sub ()
         portid = get_bus_index();
         result = portid >= 0;
     }
+    if (result)
+        result = create_input_ringbuffer(rc().jack_ring_size());
+
     if (result)
     {
         std::string portname = master_info().get_port_name(get_bus_index());
@@ -747,15 +1213,35 @@ midi_jack::api_deinit_in ()
 void
 midi_jack::api_play (event * e24, midibyte channel)
 {
-    midibyte status = e24->get_status() + (channel & 0x0F);
+    api_play_at(e24, channel, SEQ64_NULL_MIDIPULSE);
+}
+
+/**
+ *  Like api_play(), but the message is placed at the frame of the JACK
+ *  cycle that matches the tick of the event.  See send_message().
+ *
+ * \param e24
+ *      The event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param tick
+ *      The tick of the performance at which the event is due, or
+ *      SEQ64_NULL_MIDIPULSE to send it as soon as possible.
+ */
+
+void
+midi_jack::api_play_at (event * e24, midibyte channel, midipulse tick)
+{
+    midibyte buffer[3];                         /* no heap in JACK cycle */
     midibyte d0, d1;
     e24->get_data(d0, d1);
+    buffer[0] = e24->get_status() + (channel & 0x0F);
+    buffer[1] = d0;
+    buffer[2] = d1;
 
-    midi_message message;
-    message.push(status);
-    message.push(d0);
-    if (e24->is_two_bytes())                    /* \change ca 2017-04-26 */
-        message.push(d1);
+    int count = e24->is_two_bytes() ? 3 : 2;    /* \change ca 2017-04-26 */
 
 #ifdef SEQ64_SHOW_API_CALLS_TMI
     printf("midi_jack::play()\n");
@@ -763,7 +1249,7 @@ midi_jack::api_play (event * e24, midibyte channel)
 
     if (m_jack_data.valid_buffer())
     {
-        if (! send_message(message))
+        if (! send_event(buffer, count, tick))
         {
             errprint("JACK api_play failed");
         }
@@ -771,60 +1257,119 @@ midi_jack::api_play (event * e24, midibyte channel)
 }
 
 /**
- *  Sends a JACK MIDI output message.  It writes the full message size and
- *  the message itself to the JACK ring buffer.
+ *  Sends a JACK MIDI output message.  See send_event().
  *
  * \param message
  *      Provides the MIDI message object, which contains the bytes to send.
  *
+ * \param tick
+ *      The tick of the performance at which the message is due.  The
+ *      default, SEQ64_NULL_MIDIPULSE, means as soon as possible.
+ *
  * \return
- *      Returns true if the buffer message and buffer size seem to be written
- *      correctly.
+ *      Returns true if the message was written to the output ringbuffer.
  */
 
 bool
-midi_jack::send_message (const midi_message & message)
+midi_jack::send_message (const midi_message & message, midipulse tick)
 {
-    int nbytes = message.count();
-    bool result = nbytes > 0;
-    if (result)
-    {
 #ifdef PLATFORM_DEBUG_TMI
-        message.show();
+    message.show();
 #endif
-        int count1 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffmessage, message.array(), message.count()
-        );
-        int count2 = jack_ringbuffer_write
-        (
-            m_jack_data.m_jack_buffsize, (char *) &nbytes, sizeof nbytes
-        );
+    return send_event
+    (
+        reinterpret_cast<const midibyte *>(message.array()),
+        message.count(), tick
+    );
+}
+
+/**
+ *  Sends the bytes of a JACK MIDI output message.  It writes the message
+ *  size, the frame at which the message is due, and the message itself to
+ *  the JACK output ringbuffer as one framed record; see
+ *  jack_write_output_record().  Nothing is allocated, and nothing waits on
+ *  the process callback.
+ *
+ * \param msg
+ *      Provides the bytes to send.
+ *
+ * \param count
+ *      The number of bytes to send.
+ *
+ * \param tick
+ *      The tick of the performance at which the message is due, converted
+ *      to a frame by midi_jack_info::frame_time().  SEQ64_NULL_MIDIPULSE
+ *      means as soon as possible.
+ *
+ * \return
+ *      Returns true if the message was written to the output ringbuffer.
+ */
+
+bool
+midi_jack::send_event (const midibyte * msg, int count, midipulse tick)
+{
+    bool result = count > 0;
+    if (result)
+    {
+        midi_jack_header header;
+        header.mjh_frame = m_jack_info.frame_time(tick);
+        header.mjh_size = count;
+        result = jack_write_output_record(m_jack_data, header, msg);
         apiprint("send_message", "jack");
-        result = (count1 > 0) && (count2 > 0);
     }
     return result;
 }
 
 /**
- * \todo
- *      Flesh out this routine.
+ *  Sends a SysEx message through the output ringbuffer, whole, as one
+ *  record due as soon as possible.  The process callback writes it as one
+ *  JACK MIDI event, in the first cycle whose port buffer has room for all
+ *  of it (see jack_midi_max_event_size()), so that a device never gets
+ *  part of one.  A message too big for the ringbuffer is dropped.
+ *
+ *  Normally, mastermidibase::sysex() hands the message to a sysex_sender,
+ *  which calls this function with the whole message, since
+ *  api_sysex_chunk() is 0, and paces the messages at the "rc"
+ *  [sysex-output] rate.
+ *
+ * \param e24
+ *      The SysEx event to send.
  */
 
 void
-midi_jack::api_sysex (event * /* e24 */)
+midi_jack::api_sysex (event * e24)
 {
-    // Will put this one off until later....
+    const event::SysexContainer & data = e24->get_sysex();
+    int data_size = e24->get_sysex_size();
+    if (data_size > 0 && m_jack_data.valid_buffer())
+    {
+        if (! send_event(&data[0], data_size, SEQ64_NULL_MIDIPULSE))
+        {
+            errprint("JACK api_sysex: ringbuffer full, SysEx dropped");
+        }
+    }
 }
 
 /**
- *  It seems like JACK doesn't have the concept of flushing event.
+ *  It seems like JACK doesn't have the concept of flushing event.  But the
+ *  process callback cannot safely print, so here we report the output
+ *  messages it has dropped since the last flush.  This is called from
+ *  midi_jack_info::api_flush(), never from the process callback.
  */
 
 void
 midi_jack::api_flush ()
 {
-    // No code needed
+    int drops = m_jack_data.m_jack_cycle_drops;
+    if (drops != m_jack_data.m_jack_cycle_drops_seen)
+    {
+        errprintf
+        (
+            "JACK port %s: %d messages dropped in the process callback\n",
+            port_name().c_str(), drops - m_jack_data.m_jack_cycle_drops_seen
+        );
+        m_jack_data.m_jack_cycle_drops_seen = drops;
+    }
 }
 
 /**
@@ -939,11 +1484,9 @@ midi_jack::api_clock (midipulse tick)
 void
 midi_jack::send_byte (midibyte evbyte)
 {
-    midi_message message;
-    message.push(evbyte);
     if (m_jack_data.valid_buffer())
     {
-        bool ok = send_message(message);
+        bool ok = send_event(&evbyte, 1, SEQ64_NULL_MIDIPULSE);
         if (! ok)
         {
             errprint("JACK send_byte() failed");
@@ -1006,8 +1549,7 @@ midi_jack::api_get_port_name ()
  *
  *  For output, connects the MIDI output port.  The following calls are made:
  *
- *      -   jack_ringbuffer_create(), called twice, to initialize the
- *          output ringbuffers
+ *      -   jack_ringbuffer_create(), to initialize the output ringbuffer
  *      -   jack_client_open(), to initialize JACK client
  *      -   jack_set_process_callback(), to set jack_process_inpu()
  *
@@ -1072,7 +1614,7 @@ midi_jack::open_client_impl (bool input)
             }
             else
             {
-                bool ok = create_ringbuffer(JACK_RINGBUFFER_SIZE);
+                bool ok = create_ringbuffer(rc().jack_ring_size());
                 if (ok)
                 {
                     int rc = jack_set_process_callback
@@ -1303,7 +1845,8 @@ midi_jack::close_port ()
 }
 
 /**
- *  Creates the JACK ring-buffers.
+ *  Creates the JACK output ring-buffer, which holds framed records, each a
+ *  midi_jack_header followed by the bytes of the message.
  */
 
 bool
@@ -1313,21 +1856,37 @@ midi_jack::create_ringbuffer (size_t rbsize)
     if (result)
     {
         jack_ringbuffer_t * rb = jack_ringbuffer_create(rbsize);
-        if (not_nullptr(rb))
+        result = not_nullptr(rb);
+        if (result)
+            m_jack_data.m_jack_buffoutput = rb;
+        else
         {
-            m_jack_data.m_jack_buffsize = rb;
-            rb = jack_ringbuffer_create(rbsize);
-            if (not_nullptr(rb))
-                m_jack_data.m_jack_buffmessage = rb;
-            else
-                result = false;
+            m_error_string = "JACK ringbuffer error";
+            error(rterror::WARNING, m_error_string);
         }
-        else
-            result = false;
+    }
+    return result;
+}
 
-        if (! result)
+/**
+ *  Creates the JACK input ringbuffer, which holds midi_jack_record items.
+ *  JACK rounds the size up to a power of 2, so a record never straddles the
+ *  end of the ringbuffer.
+ */
+
+bool
+midi_jack::create_input_ringbuffer (size_t rbsize)
+{
+    bool result = rbsize > 0;
+    if (result)
+    {
+        jack_ringbuffer_t * rb = jack_ringbuffer_create(rbsize);
+        result = not_nullptr(rb);
+        if (result)
+            m_jack_data.m_jack_buffinput = rb;
+        else
         {
-            m_error_string = "JACK ringbuffer error";
+            m_error_string = "JACK input ringbuffer error";
             error(rterror::WARNING, m_error_string);
         }
     }
@@ -1369,10 +1928,12 @@ midi_in_jack::midi_in_jack (midibus & parentbus, midi_info & masterinfo)
 }
 
 /**
- *  Checks the rtmidi_in_data queue for the number of items in the queue.
+ *  Checks the input ringbuffer for the number of records in it.  If the
+ *  caller uses an rtmidi callback function, the messages are read here and
+ *  passed to it, in this thread rather than the JACK process thread.
  *
  * \return
- *      Returns the value of rtindata->queue().count(), unless the caller is
+ *      Returns the number of input records waiting, unless the caller is
  *      using an rtmidi callback function, in which case 0 is always returned.
  */
 
@@ -1380,21 +1941,87 @@ int
 midi_in_jack::api_poll_for_midi ()
 {
     rtmidi_in_data * rtindata = m_jack_data.m_jack_rtmidiin;
+    (void) microsleep(100);  // millisleep(1);
     if (rtindata->using_callback())
     {
-        (void) microsleep(100);  // millisleep(1);
+        midi_message message;
+        while (get_input_message(message))
+        {
+            rtmidi_callback_t callback = rtindata->user_callback();
+            callback(message, rtindata->user_data());
+            message = midi_message();
+        }
         return 0;
     }
     else
     {
-        (void) microsleep(100);  // millisleep(1);
-        return rtindata->queue().count();
+        jack_ringbuffer_t * ring = m_jack_data.m_jack_buffinput;
+        return is_nullptr(ring) ? 0 :
+            int(jack_ringbuffer_read_space(ring) / sizeof(midi_jack_record));
     }
 }
 
 /**
- *  Gets a MIDI event.  This implementation gets a midi_message off the front
- *  of the queue and converts it to a Sequencer64 event.
+ *  Reads one message from the input ringbuffer.  Nothing is read until all
+ *  of the records of the message are in.
+ *
+ * \param message
+ *      The destination for the bytes of the message.  Its timestamp is set
+ *      to the absolute JACK frame of the message.  It is expected to be
+ *      empty.
+ *
+ * \return
+ *      Returns true if a message was read.
+ */
+
+bool
+midi_in_jack::get_input_message (midi_message & message)
+{
+    jack_ringbuffer_t * ring = m_jack_data.m_jack_buffinput;
+    midi_jack_record record;
+    bool result = not_nullptr(ring) &&
+        jack_ringbuffer_read_space(ring) >= sizeof record;
+
+    if (result)
+    {
+        (void) jack_ringbuffer_peek
+        (
+            ring, reinterpret_cast<char *>(&record), sizeof record
+        );
+
+        int count = record.mjr_size;
+        size_t records = (count + SEQ64_JACK_RECORD_BYTES - 1) /
+            SEQ64_JACK_RECORD_BYTES;
+
+        result = jack_ringbuffer_read_space(ring) >= records * sizeof record;
+        if (result)
+        {
+            message.timestamp(double(record.mjr_frame));
+            while (count > 0)
+            {
+                (void) jack_ringbuffer_read
+                (
+                    ring, reinterpret_cast<char *>(&record), sizeof record
+                );
+
+                int n = count < SEQ64_JACK_RECORD_BYTES ?
+                    count : SEQ64_JACK_RECORD_BYTES ;
+
+                for (int i = 0; i < n; ++i)
+                    message.push(record.mjr_bytes[i]);
+
+                count -= n;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ *  Gets a MIDI event.  This implementation gets a midi_message from the
+ *  input ringbuffer and converts it to a Sequencer64 event.  The timestamp
+ *  of the event is the absolute JACK frame at which it came in; see
+ *  midi_jack_info::api_input_tick().
  *
  * \change ca 2017-11-04
  *      Issue #4 "Bug with Yamaha PSR in JACK native mode" in the
@@ -1418,12 +2045,14 @@ midi_in_jack::api_poll_for_midi ()
 bool
 midi_in_jack::api_get_midi_event (event * inev)
 {
-    rtmidi_in_data * rtindata = m_jack_data.m_jack_rtmidiin;
-    bool result = ! rtindata->queue().empty();
+    midi_message mm;
+    bool result = get_input_message(mm);
     if (result)
     {
-        midi_message mm = rtindata->queue().pop_front();
-        result = inev->set_midi_event(mm.timestamp(), mm.data(), mm.count());
+        result = inev->set_midi_event
+        (
+            midipulse(mm.timestamp()), mm.data(), mm.count()
+        );
         if (result)
         {
             /*
@@ -6,7 +6,7 @@
  * \library       sequencer64 application
  * \author        Chris Ahlstrom
  * \date          2017-01-01
- * \updates       2019-01-05
+ * \updates       2026-10-17
  * \license       See the rtexmidi.lic file.  Too big.
  *
  *  This class is meant to collect a whole bunch of JACK information
@@ -38,6 +38,8 @@
 
 #ifdef SEQ64_JACK_SUPPORT
 
+#include <cmath>                        /* std::floor()                     */
+
 #include "easy_macros.hpp"              /* C++ version of easy macros       */
 #include "event.hpp"                    /* seq64::event and other tokens    */
 #include "jack_assistant.hpp"           /* seq64::create_jack_client()      */
@@ -84,6 +86,24 @@ jack_process_io (jack_nframes_t nframes, void * arg)
         midi_jack_info * self = reinterpret_cast<midi_jack_info *>(arg);
         if (not_nullptr(self))
         {
+            mastermidibase * engine = self->m_engine_bus;
+            engine_event * events = self->m_engine_events;
+            int count = 0;
+            if (not_nullptr(engine))
+            {
+                /*
+                 * Render this period first, into the event array, so that
+                 * the output ports below write its events in this cycle,
+                 * each at its own frame.  Nothing here waits or allocates.
+                 */
+
+                long rate = long(jack_get_sample_rate(self->m_jack_client));
+                count = engine->engine_cycle
+                (
+                    long(nframes), rate, events, SEQ64_ENGINE_EVENTS
+                );
+            }
+
             /*
              * Here we want to go through the I/O ports and route the data
              * appropriately.
@@ -101,7 +121,13 @@ jack_process_io (jack_nframes_t nframes, void * arg)
                 if (mj->parent_bus().is_input_port())
                     (void) jack_process_rtmidi_input(nframes, mjp);
                 else
+                {
+                    mjp->m_jack_engine = events;
+                    mjp->m_jack_engine_count = count;
+                    mjp->m_jack_engine_bus = mj->parent_bus().get_bus_index();
                     (void) jack_process_rtmidi_output(nframes, mjp);
+                    mjp->m_jack_engine_count = 0;
+                }
             }
         }
     }
@@ -130,7 +156,13 @@ midi_jack_info::midi_jack_info
     midi_info               (appname, ppqn, bpm),
     m_jack_ports            (),
     m_jack_client           (nullptr),              /* inited for connect() */
-    m_jack_client_2         (nullptr)
+    m_jack_client_2         (nullptr),
+    m_frame_tick            (SEQ64_NULL_MIDIPULSE),
+    m_frame_time            (0),
+    m_frames_per_tick       (0.0),
+    m_frame_latency         (0),
+    m_engine_bus            (nullptr),
+    m_engine_events         ()
 {
     silence_jack_info();
     m_jack_client = connect();
@@ -400,13 +432,20 @@ midi_jack_info::get_all_port_info ()
 
 /**
  *  Flushes our local queue events out into JACK.  This is also a midi_jack
- *  function.
+ *  function.  There is nothing to flush, but each output port reports the
+ *  messages its process callback has dropped; see midi_jack::api_flush().
  */
 
 void
 midi_jack_info::api_flush ()
 {
-    // No code yet
+    std::vector<midi_jack *>::iterator mi;
+    for (mi = m_jack_ports.begin(); mi != m_jack_ports.end(); ++mi)
+    {
+        midi_jack * mj = *mi;
+        if (! mj->parent_bus().is_input_port())
+            mj->api_flush();
+    }
 }
 
 /**
@@ -493,6 +532,131 @@ midi_jack_info::api_set_beats_per_minute (midibpm b)
     // Need JACK specific tempo-setting here if applicable.
 }
 
+/**
+ *  Notes the tick of the performance at the current JACK frame time, and
+ *  the frame rate of the ticks at the current tempo, for frame_time().
+ *  Called by the output thread at the start of each frame, via
+ *  mastermidibase::frame_tick().
+ *
+ * \param tick
+ *      The current tick of the performance.
+ */
+
+void
+midi_jack_info::api_frame_tick (midipulse tick)
+{
+    if (not_nullptr(m_jack_client) && bpm() > 0 && ppqn() > 0)
+    {
+        double rate = double(jack_get_sample_rate(m_jack_client));
+        m_frame_tick = tick;
+        m_frames_per_tick = rate * 60.0 / (bpm() * ppqn());
+        m_frame_time = jack_frame_time(m_jack_client);
+        m_frame_latency = jack_get_buffer_size(m_jack_client);
+    }
+}
+
+/**
+ *  Turns the JACK-driven engine on or off.  When on, jack_process_io()
+ *  calls mastermidibase::engine_cycle() at the start of each cycle, before
+ *  it writes the output ports, so that the events rendered for the period
+ *  go out in the same cycle.
+ *
+ * \param masterbus
+ *      The master bus to call, or a null pointer to turn the engine off.
+ *
+ * \return
+ *      Returns true if the engine is on.
+ */
+
+bool
+midi_jack_info::api_engine (mastermidibase * masterbus)
+{
+    m_engine_bus = masterbus;
+    return not_nullptr(masterbus) && not_nullptr(m_jack_client);
+}
+
+/**
+ *  Converts the tick of an event to the JACK frame at which it is to be
+ *  placed.  The event is as far behind the current frame time as its tick
+ *  is behind the tick noted by api_frame_tick(), plus one period, so that
+ *  all of the events played during one period keep their spacing in the
+ *  next one.
+ *
+ * \param tick
+ *      The tick of the event.  If SEQ64_NULL_MIDIPULSE, or if no tick has
+ *      been noted, the event is due now.
+ *
+ * \return
+ *      Returns the absolute frame time of the event.
+ */
+
+jack_nframes_t
+midi_jack_info::frame_time (midipulse tick) const
+{
+    if (is_nullptr(m_jack_client))
+        return 0;
+
+    if (is_null_midipulse(tick) || is_null_midipulse(m_frame_tick))
+        return jack_frame_time(m_jack_client);
+
+    long lag = long((m_frame_tick - tick) * m_frames_per_tick);
+    return jack_nframes_t(m_frame_time + m_frame_latency - lag);
+}
+
+/**
+ *  The converse of frame_time(), for input.  Converts the absolute frame at
+ *  which an input event came in to the tick of the performance that was
+ *  heard at that frame, using the tick noted by api_frame_tick().  The same
+ *  latency is allowed for, so that a note played along with the output is
+ *  recorded at the tick that was sounding.
+ *
+ * \param stamp
+ *      The absolute JACK frame of the input event, as set by
+ *      midi_in_jack::api_get_midi_event().
+ *
+ * \return
+ *      Returns the tick of the event, or SEQ64_NULL_MIDIPULSE if no tick
+ *      has been noted yet.
+ */
+
+midipulse
+midi_jack_info::api_input_tick (midipulse stamp)
+{
+    if (is_null_midipulse(m_frame_tick) || m_frames_per_tick <= 0.0)
+        return SEQ64_NULL_MIDIPULSE;
+
+    jack_nframes_t heard = m_frame_time + m_frame_latency;
+    long ahead = long(int32_t(jack_nframes_t(stamp) - heard));
+    return m_frame_tick + midipulse(std::floor(ahead / m_frames_per_tick));
+}
+
+/**
+ *  Gets the age of an input event from the absolute frame at which it came
+ *  in.  Used by mastermidibase::input_tick() when there is no tick noted by
+ *  api_frame_tick() to convert the frame with.
+ *
+ * \param stamp
+ *      The absolute JACK frame of the input event.
+ *
+ * \return
+ *      Returns the number of microseconds since the event came in.
+ */
+
+long
+midi_jack_info::api_input_age (midipulse stamp)
+{
+    long result = 0;
+    if (not_nullptr(m_jack_client) && ! is_null_midipulse(stamp))
+    {
+        jack_nframes_t now = jack_frame_time(m_jack_client);
+        long frames = long(int32_t(now - jack_nframes_t(stamp)));
+        double rate = double(jack_get_sample_rate(m_jack_client));
+        if (rate > 0.0)
+            result = long(frames * 1000000.0 / rate);
+    }
+    return result;
+}
+
 /**
  *  Start the given JACK MIDI port.  This function is called by
  *  api_get_midi_event() when an JACK event SND_SEQ_EVENT_PORT_START is
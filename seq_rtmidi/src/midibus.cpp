@@ -378,6 +378,57 @@ midibus::api_play (event * e24, midibyte channel)
         m_rt_midi->api_play(e24, channel);
 }
 
+/**
+ *  Plays the event at the given tick of the queue, if the RtMidi API
+ *  supports scheduling.  See mastermidibase::play_at().
+ *
+ * \param e24
+ *      The MIDI event to play.
+ *
+ * \param channel
+ *      The channel on which to play the event.
+ *
+ * \param tick
+ *      The tick of the queue at which to play the event.
+ */
+
+void
+midibus::api_play_at (event * e24, midibyte channel, midipulse tick)
+{
+    if (not_nullptr(m_rt_midi))
+        m_rt_midi->api_play_at(e24, channel, tick);
+}
+
+/**
+ *  Sends a SysEx message, or the piece of one given by the sysex_sender.
+ *
+ * \param e24
+ *      The SysEx event to send.
+ */
+
+void
+midibus::api_sysex (event * e24)
+{
+    if (not_nullptr(m_rt_midi))
+        m_rt_midi->api_sysex(e24);
+}
+
+/**
+ *  Tells the sysex_sender how much of a SysEx message the RtMidi API takes
+ *  at a time.
+ *
+ * \return
+ *      Returns the size of a piece, or 0 if the API takes each message
+ *      whole.
+ */
+
+int
+midibus::api_sysex_chunk () const
+{
+    return not_nullptr(m_rt_midi) ?
+        m_rt_midi->sysex_chunk() : c_midibus_sysex_chunk ;
+}
+
 /**
  *  Continue from the given tick.  This function implements only the
  *  RtMidi-specific code.